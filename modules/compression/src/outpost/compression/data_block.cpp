@@ -136,6 +136,22 @@ DataBlock::applyWaveletTransform()
     return false;
 }
 
+bool
+DataBlock::applyWaveletTransform(outpost::Slice<Fixpoint> scratch)
+{
+    if (!isTransformed() && !isEncoded() && mSampleCount > 0)
+    {
+        outpost::Slice<int16_t> coefficients =
+                LeGall53Wavelet::forwardTransformContiguous(this->getSamples(), scratch);
+        if (coefficients.getNumberOfElements() > 0)
+        {
+            mIsTransformed = true;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool
 DataBlock::isComplete() const
 {
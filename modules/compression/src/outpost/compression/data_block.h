@@ -124,6 +124,20 @@ public:
      */
     ~DataBlock() = default;
 
+    DataBlock(const DataBlock&) = default;
+
+    DataBlock&
+    operator=(const DataBlock&) = default;
+
+    /**
+     * Takes over the memory of another block without changing the reference count of the
+     * underlying SharedBuffer. The source block is left invalid.
+     */
+    DataBlock(DataBlock&&) = default;
+
+    DataBlock&
+    operator=(DataBlock&&) = default;
+
     /**
      * Getter for parameter identification
      * @return Unique parameter ID of the current block
@@ -208,6 +222,16 @@ public:
     bool
     applyWaveletTransform();
 
+    /**
+     * Applies the LeGall53 wavelet transform to the current block of samples using the
+     * cache-friendly LeGall53Wavelet::forwardTransformContiguous(). The resulting coefficients
+     * are identical to applyWaveletTransform().
+     * @param scratch Temporary memory for at least getSampleCount() samples.
+     * @return Returns true if the transform could be applied, false otherwise.
+     */
+    bool
+    applyWaveletTransform(outpost::Slice<Fixpoint> scratch);
+
     /**
      * Getter for the block's completeness in terms of its blocksize
      * @return Returns true if the number of samples according to its blocksize has been pushed,
@@ -15,6 +15,8 @@
 
 #include <outpost/utils/container/reference_queue.h>
 
+#include <utility>
+
 namespace outpost
 {
 namespace compression
@@ -27,7 +29,7 @@ OneTimeQueueSender::OneTimeQueueSender(utils::ReferenceQueueBase<DataBlock>& que
 bool
 OneTimeQueueSender::send(DataBlock& b)
 {
-    return mOutputQueue.send(b);
+    return mOutputQueue.send(std::move(b));
 }
 
 }  // namespace compression
@@ -48,7 +48,8 @@ public:
 
     /**
      * Sends a DataBlock.
-     * @param block The DataBlock to send
+     * @param block The DataBlock to send. Implementations may take over the block's memory,
+     * leaving it invalid, if the block was sent successfully.
      * @return Returns true if successful, false otherwise.
      */
     virtual bool
@@ -69,6 +70,7 @@ public:
     ~OneTimeQueueSender() = default;
 
     /**
+     * Moves the block into the queue without changing the reference count of its memory.
      * @see DataBlockSender::send
      */
     bool
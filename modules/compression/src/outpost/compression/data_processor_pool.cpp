@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "data_processor_pool.h"
+
+#include "data_block.h"
+
+#include <outpost/rtos/mutex_guard.h>
+#include <outpost/utils/container/reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <utility>
+
+namespace outpost
+{
+namespace compression
+{
+constexpr size_t DataProcessorWorker::maximumBlockLength;
+
+DataProcessorWorker::DataProcessorWorker(uint8_t threadPriority, DataProcessorPoolBase& pool) :
+    outpost::rtos::Thread(threadPriority, 1024, "DPW"),
+    mPool(pool),
+    mCheckpoint(outpost::rtos::Checkpoint::State::suspending),
+    mEncoder(),
+    mTurn(outpost::rtos::BinarySemaphore::State::acquired),
+    mTicket(0),
+    mParameterId(0),
+    mIsActive(false),
+    mIsWaiting(false)
+{
+}
+
+DataProcessorWorker::~DataProcessorWorker()
+{
+}
+
+void
+DataProcessorWorker::run()
+{
+    while (1)
+    {
+        mCheckpoint.pass();
+        mPool.process(*this, outpost::time::Duration::infinity());
+    }
+}
+
+// ---------------------------------------------------------------------------
+DataProcessorPoolBase::DataProcessorPoolBase(
+        outpost::Slice<DataProcessorWorker> workers,
+        outpost::utils::SharedBufferPoolBase& pool,
+        outpost::utils::ReferenceQueueBase<DataBlock>& inputQueue,
+        outpost::utils::ReferenceQueueBase<DataBlock>& outputQueue,
+        uint8_t numOutputRetries,
+        outpost::time::Duration retryTimeout) :
+    mWorkers(workers),
+    mInputQueue(inputQueue),
+    mOutputQueue(outputQueue),
+    mPool(pool),
+    mInputMutex(),
+    mStateMutex(),
+    mNextTicket(0),
+    mNumIncomingBlocks(0),
+    mNumProcessedBlocks(0),
+    mNumForwardedBlocks(0),
+    mNumLostBlocks(0),
+    mRetrySendTimeout(retryTimeout),
+    mMaxSendRetries(numOutputRetries)
+{
+}
+
+DataProcessorPoolBase::~DataProcessorPoolBase()
+{
+}
+
+void
+DataProcessorPoolBase::start()
+{
+    for (auto& worker : mWorkers)
+    {
+        worker.start();
+    }
+}
+
+void
+DataProcessorPoolBase::enable()
+{
+    for (auto& worker : mWorkers)
+    {
+        worker.mCheckpoint.resume();
+    }
+}
+
+void
+DataProcessorPoolBase::disable()
+{
+    for (auto& worker : mWorkers)
+    {
+        worker.mCheckpoint.suspend();
+    }
+}
+
+bool
+DataProcessorPoolBase::isEnabled() const
+{
+    for (auto& worker : mWorkers)
+    {
+        if (worker.mCheckpoint.getState() != outpost::rtos::Checkpoint::State::running)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t
+DataProcessorPoolBase::getNumberOfReceivedBlocks() const
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    return mNumIncomingBlocks;
+}
+
+uint32_t
+DataProcessorPoolBase::getNumberOfProcessedBlocks() const
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    return mNumProcessedBlocks;
+}
+
+uint32_t
+DataProcessorPoolBase::getNumberOfForwardedBlocks() const
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    return mNumForwardedBlocks;
+}
+
+uint32_t
+DataProcessorPoolBase::getNumberOfLostBlocks() const
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    return mNumLostBlocks;
+}
+
+void
+DataProcessorPoolBase::resetCounters()
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    mNumIncomingBlocks = 0;
+    mNumProcessedBlocks = 0;
+    mNumForwardedBlocks = 0;
+    mNumLostBlocks = 0;
+}
+
+void
+DataProcessorPoolBase::processSingleBlock(size_t worker, outpost::time::Duration timeout)
+{
+    if (worker < mWorkers.getNumberOfElements())
+    {
+        process(mWorkers[worker], timeout);
+    }
+}
+
+void
+DataProcessorPoolBase::process(DataProcessorWorker& worker, outpost::time::Duration timeout)
+{
+    DataBlock b;
+    if (receive(worker, b, timeout))
+    {
+        bool forwarded = false;
+        const bool processed = compress(worker, b);
+        if (processed)
+        {
+            waitForTurn(worker);
+            forwarded = forward(b);
+        }
+        finish(worker, processed, forwarded);
+    }
+}
+
+bool
+DataProcessorPoolBase::receive(DataProcessorWorker& worker,
+                               DataBlock& block,
+                               outpost::time::Duration timeout)
+{
+    // Tickets have to be assigned in the order of reception. The lock is
+    // held while waiting, the other workers would wait for the queue anyway.
+    outpost::rtos::MutexGuard inputLock(mInputMutex);
+    if (!mInputQueue.receive(block, timeout))
+    {
+        return false;
+    }
+
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    mNumIncomingBlocks++;
+    worker.mTicket = mNextTicket++;
+    worker.mParameterId = block.getParameterId();
+    worker.mIsActive = true;
+    return true;
+}
+
+bool
+DataProcessorPoolBase::compress(DataProcessorWorker& worker, DataBlock& b)
+{
+    if (b.getSampleCount() <= DataProcessorWorker::maximumBlockLength
+        && b.applyWaveletTransform(outpost::asSlice(worker.mScratch))
+        && b.getCoefficients().getNumberOfElements() > 0U)
+    {
+        outpost::utils::SharedBufferPointer p;
+        if (mPool.allocate(p))
+        {
+            DataBlock outputBlock(
+                    p, b.getParameterId(), b.getStartTime(), b.getSamplingRate(), b.getBlocksize());
+            if (b.encode(outputBlock, worker.mEncoder))
+            {
+                b = std::move(outputBlock);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool
+DataProcessorPoolBase::forward(DataBlock& block)
+{
+    for (uint8_t tries = 0; tries < mMaxSendRetries; tries++)
+    {
+        if (mOutputQueue.send(std::move(block)))
+        {
+            return true;
+        }
+        outpost::rtos::Thread::sleep(mRetrySendTimeout);
+    }
+    return false;
+}
+
+void
+DataProcessorPoolBase::waitForTurn(DataProcessorWorker& worker)
+{
+    while (1)
+    {
+        {
+            outpost::rtos::MutexGuard lock(mStateMutex);
+            if (!hasPrecedingBlock(worker))
+            {
+                return;
+            }
+            worker.mIsWaiting = true;
+        }
+        // Released by finish() of another worker, check again afterwards
+        worker.mTurn.acquire();
+    }
+}
+
+void
+DataProcessorPoolBase::finish(DataProcessorWorker& worker, bool processed, bool forwarded)
+{
+    outpost::rtos::MutexGuard lock(mStateMutex);
+    worker.mIsActive = false;
+    if (processed)
+    {
+        mNumProcessedBlocks++;
+        if (forwarded)
+        {
+            mNumForwardedBlocks++;
+        }
+        else
+        {
+            mNumLostBlocks++;
+        }
+    }
+
+    for (auto& other : mWorkers)
+    {
+        if (other.mIsWaiting)
+        {
+            other.mIsWaiting = false;
+            other.mTurn.release();
+        }
+    }
+}
+
+bool
+DataProcessorPoolBase::hasPrecedingBlock(const DataProcessorWorker& worker) const
+{
+    for (auto& other : mWorkers)
+    {
+        // Tickets wrap around, compare their distance instead of the absolute values
+        if ((&other != &worker) && other.mIsActive && (other.mParameterId == worker.mParameterId)
+            && (static_cast<int32_t>(other.mTicket - worker.mTicket) < 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace compression
+}  // namespace outpost
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_COMPRESSION_DATA_PROCESSOR_POOL_H_
+#define OUTPOST_COMPRESSION_DATA_PROCESSOR_POOL_H_
+
+#include "nls_encoder.h"
+
+#include <outpost/base/fixpoint.h>
+#include <outpost/base/slice.h>
+#include <outpost/rtos/checkpoint.h>
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/semaphore.h>
+#include <outpost/rtos/thread.h>
+#include <outpost/time/duration.h>
+#include <outpost/utils/meta.h>
+
+#include <array>
+
+namespace outpost
+{
+namespace utils
+{
+template <typename T>
+class ReferenceQueueBase;
+
+class SharedBufferPoolBase;
+}  // namespace utils
+
+namespace compression
+{
+class DataBlock;
+class DataProcessorPoolBase;
+
+/**
+ * Worker thread of a DataProcessorPool.
+ *
+ * Holds the resources needed to compress a DataBlock independently of the
+ * other workers: an NLSEncoder and the scratch memory for the wavelet
+ * transform. The encoded bitstream is written directly into the output
+ * DataBlock allocated by the worker.
+ */
+class DataProcessorWorker : public outpost::rtos::Thread
+{
+public:
+    static constexpr size_t maximumBlockLength = 4096U;
+
+    DataProcessorWorker(uint8_t threadPriority, DataProcessorPoolBase& pool);
+
+    // Disable copy constructor
+    DataProcessorWorker(const DataProcessorWorker&) = delete;
+
+    DataProcessorWorker&
+    operator=(const DataProcessorWorker&) = delete;
+
+    virtual ~DataProcessorWorker();
+
+    /**
+     * Processes DataBlocks from the input queue of the pool while enabled.
+     */
+    void
+    run() override;
+
+private:
+    friend class DataProcessorPoolBase;
+
+    DataProcessorPoolBase& mPool;
+    outpost::rtos::Checkpoint mCheckpoint;
+
+    NLSEncoder mEncoder;
+    Fixpoint mScratch[maximumBlockLength];
+
+    // Ordering state, protected by the mutex of the pool
+    outpost::rtos::BinarySemaphore mTurn;
+    uint32_t mTicket;
+    uint16_t mParameterId;
+    bool mIsActive;
+    bool mIsWaiting;
+};
+
+/**
+ * Transforms and encodes DataBlocks with several worker threads.
+ *
+ * All workers take DataBlocks from a shared input queue and compress them in
+ * parallel. Blocks of the same parameter are forwarded to the output queue in
+ * the order in which they have been received, blocks of different parameters
+ * may overtake each other.
+ *
+ * \see DataProcessorThread for a single threaded variant.
+ */
+class DataProcessorPoolBase
+{
+public:
+    // Disable copy constructor
+    DataProcessorPoolBase(const DataProcessorPoolBase&) = delete;
+
+    DataProcessorPoolBase&
+    operator=(const DataProcessorPoolBase&) = delete;
+
+    virtual ~DataProcessorPoolBase();
+
+    /**
+     * Starts all worker threads. Processing has to be enabled separately.
+     */
+    void
+    start();
+
+    /**
+     * Enables the processing of DataBlocks for all workers
+     */
+    void
+    enable();
+
+    /**
+     * Disables the processing of DataBlocks for all workers. Blocks which are
+     * currently processed are finished first.
+     */
+    void
+    disable();
+
+    /**
+     * Getter for the pool's state.
+     * @return Returns true if processing is currently enabled for all workers, false otherwise.
+     */
+    bool
+    isEnabled() const;
+
+    inline size_t
+    getNumberOfWorkers() const
+    {
+        return mWorkers.getNumberOfElements();
+    }
+
+    /**
+     * Getter for the number of DataBlocks that have been received from the input queue.
+     */
+    uint32_t
+    getNumberOfReceivedBlocks() const;
+
+    /**
+     * Getter for the number of DataBlocks that have been processed.
+     */
+    uint32_t
+    getNumberOfProcessedBlocks() const;
+
+    /**
+     * Getter for the number of DataBlocks that haven been forwarded to the output queue.
+     */
+    uint32_t
+    getNumberOfForwardedBlocks() const;
+
+    /**
+     * Getter for the number of DataBlocks that have been lost because they could not be sent to
+     * the output queue.
+     */
+    uint32_t
+    getNumberOfLostBlocks() const;
+
+    /**
+     * Resets the counters for incoming, processed, forwarded and lost blocks.
+     */
+    void
+    resetCounters();
+
+    /**
+     * Goes through the entire processing sequence for a single block in the
+     * calling thread, using the encoder and scratch memory of the given worker.
+     *
+     * Can be called concurrently for different workers, but not for a
+     * worker whose thread has been started.
+     *
+     * @param worker Index of the worker, must be smaller than getNumberOfWorkers().
+     * @param timeout Timeout for reception of a DataBlock on the input queue.
+     */
+    void
+    processSingleBlock(size_t worker,
+                       outpost::time::Duration timeout = outpost::time::Duration::infinity());
+
+protected:
+    DataProcessorPoolBase(outpost::Slice<DataProcessorWorker> workers,
+                          outpost::utils::SharedBufferPoolBase& pool,
+                          outpost::utils::ReferenceQueueBase<DataBlock>& inputQueue,
+                          outpost::utils::ReferenceQueueBase<DataBlock>& outputQueue,
+                          uint8_t numOutputRetries,
+                          outpost::time::Duration retryTimeout);
+
+private:
+    friend class DataProcessorWorker;
+
+    void
+    process(DataProcessorWorker& worker, outpost::time::Duration timeout);
+
+    bool
+    receive(DataProcessorWorker& worker, DataBlock& block, outpost::time::Duration timeout);
+
+    bool
+    compress(DataProcessorWorker& worker, DataBlock& block);
+
+    bool
+    forward(DataBlock& block);
+
+    /**
+     * Blocks until no other worker processes an earlier block of the same parameter.
+     */
+    void
+    waitForTurn(DataProcessorWorker& worker);
+
+    void
+    finish(DataProcessorWorker& worker, bool processed, bool forwarded);
+
+    bool
+    hasPrecedingBlock(const DataProcessorWorker& worker) const;
+
+    outpost::Slice<DataProcessorWorker> mWorkers;
+
+    outpost::utils::ReferenceQueueBase<DataBlock>& mInputQueue;
+    outpost::utils::ReferenceQueueBase<DataBlock>& mOutputQueue;
+
+    outpost::utils::SharedBufferPoolBase& mPool;
+
+    // Serializes the reception of blocks and the assignment of tickets
+    outpost::rtos::Mutex mInputMutex;
+
+    // Protects the ordering state of the workers and the counters
+    mutable outpost::rtos::Mutex mStateMutex;
+
+    uint32_t mNextTicket;
+
+    uint32_t mNumIncomingBlocks;
+    uint32_t mNumProcessedBlocks;
+    uint32_t mNumForwardedBlocks;
+    uint32_t mNumLostBlocks;
+
+    outpost::time::Duration mRetrySendTimeout;
+    uint8_t mMaxSendRetries;
+};
+
+/**
+ * DataProcessorPool with a fixed number of worker threads.
+ *
+ * \tparam numberOfWorkers
+ *     Number of worker threads. Each worker needs about 20 kB of memory for
+ *     its encoder and scratch memory.
+ */
+template <size_t numberOfWorkers>
+class DataProcessorPool : public DataProcessorPoolBase
+{
+public:
+    static_assert(numberOfWorkers > 0, "A DataProcessorPool needs at least one worker");
+
+    /** Constructor
+     * @param threadPriority Priority of the worker threads in the OS' scheduler
+     * @param pool SharedBufferPool for allocation of new DataBlocks
+     * @param inputQueue Queue to listen to for incoming raw DataBlocks
+     * @param outputQueue Queue to send encoded DataBlocks to for long-term storage or transmission
+     * to ground
+     */
+    DataProcessorPool(uint8_t threadPriority,
+                      outpost::utils::SharedBufferPoolBase& pool,
+                      outpost::utils::ReferenceQueueBase<DataBlock>& inputQueue,
+                      outpost::utils::ReferenceQueueBase<DataBlock>& outputQueue,
+                      uint8_t numOutputRetries = 5U,
+                      outpost::time::Duration retryTimeout = outpost::time::Milliseconds(500)) :
+        DataProcessorPool(typename outpost::MakeIndexSequence<numberOfWorkers>::Type(),
+                          threadPriority,
+                          pool,
+                          inputQueue,
+                          outputQueue,
+                          numOutputRetries,
+                          retryTimeout)
+    {
+    }
+
+private:
+    template <size_t... indices>
+    DataProcessorPool(outpost::IndexSequence<indices...>,
+                      uint8_t threadPriority,
+                      outpost::utils::SharedBufferPoolBase& pool,
+                      outpost::utils::ReferenceQueueBase<DataBlock>& inputQueue,
+                      outpost::utils::ReferenceQueueBase<DataBlock>& outputQueue,
+                      uint8_t numOutputRetries,
+                      outpost::time::Duration retryTimeout) :
+        DataProcessorPoolBase(outpost::asSlice(mWorkers),
+                              pool,
+                              inputQueue,
+                              outputQueue,
+                              numOutputRetries,
+                              retryTimeout),
+        mWorkers{{{(static_cast<void>(indices), threadPriority), *this}...}}
+    {
+    }
+
+    std::array<DataProcessorWorker, numberOfWorkers> mWorkers;
+};
+
+}  // namespace compression
+}  // namespace outpost
+
+#endif /* OUTPOST_COMPRESSION_DATA_PROCESSOR_POOL_H_ */
@@ -91,7 +91,7 @@ DataProcessorThread::processSingleBlock(outpost::time::Duration timeout)
             bool success = false;
             for (uint8_t tries = 0; tries < mMaxSendRetries && !success; tries++)
             {
-                if (mOutputQueue.send(b))
+                if (mOutputQueue.send(std::move(b)))
                 {
                     success = true;
                 }
@@ -13,6 +13,8 @@
 
 #include "legall_wavelet.h"
 
+#include "legall_wavelet_kernels.h"
+
 #include <outpost/base/fixpoint.h>
 #include <outpost/base/slice.h>
 #include <outpost/utils/log2.h>
@@ -23,6 +25,50 @@ namespace outpost
 {
 namespace compression
 {
+static_assert(sizeof(Fixpoint) == sizeof(int32_t),
+              "Vectorized kernels require a Fixpoint to be stored as plain int32_t");
+
+static inline int32_t*
+toInteger(outpost::Slice<Fixpoint> buffer)
+{
+    return reinterpret_cast<int32_t*>(buffer.begin());
+}
+
+static inline int32_t*
+toInteger(Fixpoint* buffer)
+{
+    return reinterpret_cast<int32_t*>(buffer);
+}
+
+// Additions of the reversible transformation wrap around on overflow. The
+// forward and backward transformation calculate the same wrapped values, which
+// keeps the transformation reversible for all inputs.
+static inline int32_t
+wrappingAdd(int32_t a, int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+static inline int32_t
+wrappingSubtract(int32_t a, int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+}
+
+// Prediction step of the reversible lifting scheme: floor((left + right) / 2)
+static inline int32_t
+predict(int32_t left, int32_t right)
+{
+    return wrappingAdd(left, right) >> 1;
+}
+
+// Update step of the reversible lifting scheme: floor((left + right + 2) / 4)
+static inline int32_t
+update(int32_t left, int32_t right)
+{
+    return wrappingAdd(wrappingAdd(left, right), 2) >> 2;
+}
+
 void
 LeGall53Wavelet::forwardTransform(outpost::Slice<Fixpoint> inBuffer,
                                   outpost::Slice<Fixpoint> outBuffer)
@@ -35,7 +81,11 @@ LeGall53Wavelet::forwardTransform(outpost::Slice<Fixpoint> inBuffer,
     {
         // Calculate high- and lowpass coefficients for the general case
         halfBufferLength = halfBufferLength >> 1;
-        for (size_t i = 0; i < halfBufferLength - 2; i++)
+        size_t i = legall::forward(toInteger(inBuffer),
+                                   toInteger(outBuffer),
+                                   toInteger(outBuffer) + halfBufferLength,
+                                   halfBufferLength - 2);
+        for (; i < halfBufferLength - 2; i++)
         {
             // Lowpass
             outBuffer[i] = h0 * inBuffer[2 * i] + h1 * inBuffer[2 * i + 1]
@@ -102,8 +152,14 @@ LeGall53Wavelet::forwardTransformInPlace(outpost::Slice<Fixpoint> inBuffer)
         // Temporarily save these for handling of lapping cases
         Fixpoint tmpBuffer[3] = {inBuffer[0], inBuffer[1 << step], inBuffer[2 << step]};
 
-        // Calculate highpass and lowpass coefficients using the lifting scheme
-        for (size_t i = 0; ((i + 4) << step) < inBufferLength; i += 2)
+        // Calculate highpass and lowpass coefficients using the lifting scheme. Only the
+        // first level works on contiguous elements and is passed to the vectorized kernel.
+        size_t i = 0;
+        if ((step == 0) && (inBufferLength > 4))
+        {
+            i = 2 * legall::forwardInPlace(toInteger(inBuffer), inBufferLength / 2 - 2);
+        }
+        for (; ((i + 4) << step) < inBufferLength; i += 2)
         {
             inBuffer[(i << step)] = h0 * inBuffer[i << step] + h1 * inBuffer[(i + 1) << step]
                                     + h2 * inBuffer[(i + 2) << step]
@@ -134,6 +190,74 @@ LeGall53Wavelet::forwardTransformInPlace(outpost::Slice<Fixpoint> inBuffer)
     }
 }
 
+outpost::Slice<int16_t>
+LeGall53Wavelet::forwardTransformContiguous(outpost::Slice<Fixpoint> inBuffer,
+                                            outpost::Slice<Fixpoint> scratch)
+{
+    const size_t bufferLength = inBuffer.getNumberOfElements();
+    if (scratch.getNumberOfElements() < bufferLength)
+    {
+        return outpost::Slice<int16_t>::empty();
+    }
+
+    // The coefficients are stored in the memory of inBuffer. A pass only
+    // writes coefficients to memory that has already been read.
+    int16_t* coefficients = reinterpret_cast<int16_t*>(inBuffer.begin());
+
+    // The first pass reads from inBuffer, all subsequent passes alternate
+    // between the two halves of the scratch area.
+    Fixpoint* source = inBuffer.begin();
+    Fixpoint* destination = scratch.begin();
+
+    size_t length = bufferLength;
+    for (; length >= 4; length >>= 1)
+    {
+        const size_t halfLength = length >> 1;
+        Fixpoint* lowpass = destination;
+        Fixpoint* highpass = destination + halfLength;
+
+        // Same calculations as in forwardTransformInPlace(), but with lowpass
+        // and highpass coefficients stored in separate bands
+        size_t i = legall::forwardLifting(
+                toInteger(source), toInteger(lowpass), toInteger(highpass), halfLength - 2);
+        for (; i < halfLength - 2; i++)
+        {
+            lowpass[i] = h0 * source[2 * i] + h1 * source[2 * i + 1] + h2 * source[2 * i + 2]
+                         + h3 * source[2 * i + 3] + h4 * source[2 * i + 4];
+            highpass[i] = ip_g0 * lowpass[i] + ip_g2 * source[2 * i + 2]
+                          + ip_g3 * source[2 * i + 3] + ip_g4 * source[2 * i + 4];
+        }
+
+        // Handle lapping cases
+        lowpass[halfLength - 2] = h0 * source[length - 4] + h1 * source[length - 3]
+                                  + h2 * source[length - 2] + h3 * source[length - 1]
+                                  + h4 * source[0];
+        highpass[halfLength - 2] = ip_g0 * lowpass[halfLength - 2] + ip_g2 * source[length - 2]
+                                   + ip_g3 * source[length - 1] + ip_g4 * source[0];
+        lowpass[halfLength - 1] = h0 * source[length - 2] + h1 * source[length - 1]
+                                  + h2 * source[0] + h3 * source[1] + h4 * source[2];
+        highpass[halfLength - 1] = ip_g0 * lowpass[halfLength - 1] + ip_g2 * source[0]
+                                   + ip_g3 * source[1] + ip_g4 * source[2];
+
+        // The highpass band is final, round it to its position in the output
+        for (i = 0; i < halfLength; i++)
+        {
+            coefficients[halfLength + i] = static_cast<int16_t>(highpass[i]);
+        }
+
+        source = lowpass;
+        destination = (lowpass == scratch.begin()) ? scratch.begin() + bufferLength / 2
+                                                   : scratch.begin();
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        coefficients[i] = static_cast<int16_t>(source[i]);
+    }
+
+    return outpost::Slice<int16_t>::unsafe(coefficients, bufferLength);
+}
+
 outpost::Slice<int16_t>
 LeGall53Wavelet::reorder(outpost::Slice<Fixpoint> inBuffer)
 {
@@ -196,6 +320,91 @@ LeGall53Wavelet::backwardTransform(outpost::Slice<double> inBuffer,
     }
 }
 
+void
+LeGall53Wavelet::forwardTransformReversible(outpost::Slice<int32_t> inBuffer,
+                                            outpost::Slice<int32_t> outBuffer)
+{
+    const size_t bufferLength = inBuffer.getNumberOfElements();
+    int32_t* in = inBuffer.begin();
+    int32_t* out = outBuffer.begin();
+    if (bufferLength <= 2)
+    {
+        memcpy(out, in, bufferLength * sizeof(int32_t));
+        return;
+    }
+
+    // Perform log2 passes, the lowpass coefficients of each pass are the input of the next one
+    for (size_t length = bufferLength; length > 2; length >>= 1)
+    {
+        const size_t halfLength = length >> 1;
+        const size_t last = halfLength - 1;
+
+        // Symmetric extension at the left border, the highpass coefficient left
+        // of the first one equals the first one.
+        int32_t previousHighpass = wrappingSubtract(in[1], predict(in[0], in[2]));
+        for (size_t i = 0; i < last; i++)
+        {
+            const int32_t highpass =
+                    wrappingSubtract(in[2 * i + 1], predict(in[2 * i], in[2 * i + 2]));
+            out[i] = wrappingAdd(in[2 * i], update(previousHighpass, highpass));
+            out[halfLength + i] = highpass;
+            previousHighpass = highpass;
+        }
+
+        // Symmetric extension at the right border, the sample right of the
+        // last one equals the second to last one.
+        const int32_t highpass =
+                wrappingSubtract(in[2 * last + 1], predict(in[2 * last], in[2 * last]));
+        out[last] = wrappingAdd(in[2 * last], update(previousHighpass, highpass));
+        out[length - 1] = highpass;
+
+        if (halfLength > 2)
+        {
+            memcpy(in, out, halfLength * sizeof(int32_t));
+        }
+    }
+}
+
+void
+LeGall53Wavelet::backwardTransformReversible(outpost::Slice<int32_t> inBuffer,
+                                             outpost::Slice<int32_t> outBuffer)
+{
+    const size_t bufferLength = inBuffer.getNumberOfElements();
+    int32_t* in = inBuffer.begin();
+    int32_t* out = outBuffer.begin();
+    if (bufferLength <= 2)
+    {
+        memcpy(out, in, bufferLength * sizeof(int32_t));
+        return;
+    }
+
+    // Undo the passes of the forward transformation starting with the last one
+    for (size_t length = 4; length <= bufferLength; length <<= 1)
+    {
+        const size_t halfLength = length >> 1;
+        const size_t last = halfLength - 1;
+        const int32_t* lowpass = in;
+        const int32_t* highpass = in + halfLength;
+
+        int32_t even = wrappingSubtract(lowpass[0], update(highpass[0], highpass[0]));
+        for (size_t i = 0; i < last; i++)
+        {
+            const int32_t nextEven =
+                    wrappingSubtract(lowpass[i + 1], update(highpass[i], highpass[i + 1]));
+            out[2 * i] = even;
+            out[2 * i + 1] = wrappingAdd(highpass[i], predict(even, nextEven));
+            even = nextEven;
+        }
+        out[2 * last] = even;
+        out[2 * last + 1] = wrappingAdd(highpass[last], predict(even, even));
+
+        if (length < bufferLength)
+        {
+            memcpy(in, out, length * sizeof(int32_t));
+        }
+    }
+}
+
 const Fixpoint LeGall53Wavelet::h0 = -0.125;
 const Fixpoint LeGall53Wavelet::h1 = 0.25;
 const Fixpoint LeGall53Wavelet::h2 = 0.75;
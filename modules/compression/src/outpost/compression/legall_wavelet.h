@@ -35,6 +35,9 @@ namespace compression
  *
  * For the complete compression scheme, see:
  * https://elib.dlr.de/112826/
+ *
+ * The forward transformations use SSE2, AVX2 or NEON kernels if the target
+ * supports them, with results bit-identical to the scalar implementation.
  */
 class LeGall53Wavelet
 {
@@ -68,6 +71,29 @@ public:
     static void
     forwardTransformInPlace(outpost::Slice<Fixpoint> inBuffer);
 
+    /**
+     * Cache-friendly alternative to forwardTransformInPlace() followed by
+     * reorder(), with identical results.
+     *
+     * Each pass writes its lowpass and highpass coefficients to contiguous
+     * bands, alternating between the two halves of the scratch area, so all
+     * memory accesses have unit stride. The highpass bands are rounded
+     * directly to their final position, which makes the separate reordering
+     * passes unnecessary.
+     *
+     * @param inBuffer
+     *     Samples to transform, the number of elements must be a power of two.
+     *     Overwritten by the resulting coefficients.
+     * @param scratch
+     *     Temporary memory for at least as many elements as inBuffer.
+     * @return
+     *     Slice of the rounded coefficients stored in the memory of inBuffer,
+     *     or an empty slice if the scratch area is too small.
+     */
+    static outpost::Slice<int16_t>
+    forwardTransformContiguous(outpost::Slice<Fixpoint> inBuffer,
+                               outpost::Slice<Fixpoint> scratch);
+
     /**
      * Reorders the coefficients after in place transformation for further coding by using the bits
      * after the comma.
@@ -89,6 +115,46 @@ public:
     static void
     backwardTransform(outpost::Slice<double> inBuffer, outpost::Slice<double> outBuffer);
 
+    /**
+     * Reversible integer forward transformation (JPEG2000 5/3 lifting scheme).
+     *
+     * Uses only integer additions and shifts and can be inverted exactly by
+     * backwardTransformReversible(). The signal is extended symmetrically at
+     * the block borders. Coefficients are stored in the same order as by
+     * forwardTransform(): the two lowpass coefficients of the last level,
+     * followed by the highpass coefficients from the last to the first level.
+     *
+     * All additions wrap around on overflow, therefore the transformation is
+     * reversible for all input values. Samples within the int16_t range never
+     * overflow.
+     *
+     * @param inBuffer
+     *     Samples to transform, the number of elements must be a power of two.
+     *     WARNING: The buffer is used as temporary memory, its contents are
+     *     subject to change!
+     * @param outBuffer
+     *     Buffer for the resulting coefficients. Needs to be able to store
+     *     as many elements as inBuffer.
+     */
+    static void
+    forwardTransformReversible(outpost::Slice<int32_t> inBuffer,
+                               outpost::Slice<int32_t> outBuffer);
+
+    /**
+     * Exact inverse of forwardTransformReversible().
+     *
+     * @param inBuffer
+     *     Coefficients as generated by forwardTransformReversible().
+     *     WARNING: The buffer is used as temporary memory, its contents are
+     *     subject to change!
+     * @param outBuffer
+     *     Buffer for the reconstructed samples. Needs to be able to store
+     *     as many elements as inBuffer.
+     */
+    static void
+    backwardTransformReversible(outpost::Slice<int32_t> inBuffer,
+                                outpost::Slice<int32_t> outBuffer);
+
 private:
     // Forward lowpass coefficients
     static const Fixpoint h0;
@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Vectorized kernels for the LeGall 5/3 forward transformation.
+ *
+ * Only used internally by LeGall53Wavelet. The instruction set is selected
+ * at compile time (AVX2, SSE2 or NEON). Without any of these the kernels
+ * process no elements and the scalar implementation is used throughout.
+ * Define OUTPOST_COMPRESSION_LEGALL_SCALAR to force the scalar path.
+ *
+ * The scalar path computes each filter tap as the Q16 product
+ * floor(c * v / 2^16) with a 64 bit intermediate. All LeGall coefficients
+ * are multiples of 1/8, i.e. c = k * 2^13 with a small integer k. Splitting
+ * v = 8 * q + r with 0 <= r < 8 gives
+ *
+ *     floor(c * v / 2^16) = k * q + floor(k * r / 8)
+ *
+ * For the few distinct values of k this reduces to shifts, masks and
+ * additions on 32 bit integers, see the tap functions below. Overflows wrap
+ * around in the same way as in the scalar path, so the results are
+ * bit-identical.
+ */
+
+#ifndef OUTPOST_COMPRESSION_LEGALL_WAVELET_KERNELS_H
+#define OUTPOST_COMPRESSION_LEGALL_WAVELET_KERNELS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(OUTPOST_COMPRESSION_LEGALL_SCALAR)
+#if defined(__AVX2__)
+#define OUTPOST_COMPRESSION_LEGALL_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#define OUTPOST_COMPRESSION_LEGALL_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define OUTPOST_COMPRESSION_LEGALL_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace outpost
+{
+namespace compression
+{
+namespace legall
+{
+#if defined(OUTPOST_COMPRESSION_LEGALL_AVX2)
+struct Vector
+{
+    typedef __m256i Type;
+    static constexpr size_t width = 8;
+
+    static inline Type
+    set(int32_t value)
+    {
+        return _mm256_set1_epi32(value);
+    }
+
+    static inline Type
+    add(Type a, Type b)
+    {
+        return _mm256_add_epi32(a, b);
+    }
+
+    static inline Type
+    subtract(Type a, Type b)
+    {
+        return _mm256_sub_epi32(a, b);
+    }
+
+    template <int bits>
+    static inline Type
+    shiftLeft(Type a)
+    {
+        return _mm256_slli_epi32(a, bits);
+    }
+
+    /// Arithmetic shift, rounds towards negative infinity
+    template <int bits>
+    static inline Type
+    shiftRight(Type a)
+    {
+        return _mm256_srai_epi32(a, bits);
+    }
+
+    static inline Type
+    mask(Type a, int32_t bits)
+    {
+        return _mm256_and_si256(a, _mm256_set1_epi32(bits));
+    }
+
+    static inline void
+    store(int32_t* data, Type a)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data), a);
+    }
+
+    static inline void
+    loadDeinterleaved(const int32_t* data, Type& even, Type& odd)
+    {
+        const __m256i order = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+        const __m256i a = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)), order);
+        const __m256i b = _mm256_permutevar8x32_epi32(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 8)), order);
+        even = _mm256_permute2x128_si256(a, b, 0x20);
+        odd = _mm256_permute2x128_si256(a, b, 0x31);
+    }
+
+    static inline void
+    storeInterleaved(int32_t* data, Type even, Type odd)
+    {
+        const __m256i low = _mm256_unpacklo_epi32(even, odd);
+        const __m256i high = _mm256_unpackhi_epi32(even, odd);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data),
+                            _mm256_permute2x128_si256(low, high, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + 8),
+                            _mm256_permute2x128_si256(low, high, 0x31));
+    }
+};
+#elif defined(OUTPOST_COMPRESSION_LEGALL_SSE2)
+struct Vector
+{
+    typedef __m128i Type;
+    static constexpr size_t width = 4;
+
+    static inline Type
+    set(int32_t value)
+    {
+        return _mm_set1_epi32(value);
+    }
+
+    static inline Type
+    add(Type a, Type b)
+    {
+        return _mm_add_epi32(a, b);
+    }
+
+    static inline Type
+    subtract(Type a, Type b)
+    {
+        return _mm_sub_epi32(a, b);
+    }
+
+    template <int bits>
+    static inline Type
+    shiftLeft(Type a)
+    {
+        return _mm_slli_epi32(a, bits);
+    }
+
+    /// Arithmetic shift, rounds towards negative infinity
+    template <int bits>
+    static inline Type
+    shiftRight(Type a)
+    {
+        return _mm_srai_epi32(a, bits);
+    }
+
+    static inline Type
+    mask(Type a, int32_t bits)
+    {
+        return _mm_and_si128(a, _mm_set1_epi32(bits));
+    }
+
+    static inline void
+    store(int32_t* data, Type a)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data), a);
+    }
+
+    static inline void
+    loadDeinterleaved(const int32_t* data, Type& even, Type& odd)
+    {
+        const __m128 a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+        const __m128 b =
+                _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4)));
+        even = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        odd = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    static inline void
+    storeInterleaved(int32_t* data, Type even, Type odd)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(even, odd));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 4), _mm_unpackhi_epi32(even, odd));
+    }
+};
+#elif defined(OUTPOST_COMPRESSION_LEGALL_NEON)
+struct Vector
+{
+    typedef int32x4_t Type;
+    static constexpr size_t width = 4;
+
+    static inline Type
+    set(int32_t value)
+    {
+        return vdupq_n_s32(value);
+    }
+
+    static inline Type
+    add(Type a, Type b)
+    {
+        return vaddq_s32(a, b);
+    }
+
+    static inline Type
+    subtract(Type a, Type b)
+    {
+        return vsubq_s32(a, b);
+    }
+
+    template <int bits>
+    static inline Type
+    shiftLeft(Type a)
+    {
+        return vshlq_n_s32(a, bits);
+    }
+
+    /// Arithmetic shift, rounds towards negative infinity
+    template <int bits>
+    static inline Type
+    shiftRight(Type a)
+    {
+        return vshrq_n_s32(a, bits);
+    }
+
+    static inline Type
+    mask(Type a, int32_t bits)
+    {
+        return vandq_s32(a, vdupq_n_s32(bits));
+    }
+
+    static inline void
+    store(int32_t* data, Type a)
+    {
+        vst1q_s32(data, a);
+    }
+
+    static inline void
+    loadDeinterleaved(const int32_t* data, Type& even, Type& odd)
+    {
+        const int32x4x2_t pair = vld2q_s32(data);
+        even = pair.val[0];
+        odd = pair.val[1];
+    }
+
+    static inline void
+    storeInterleaved(int32_t* data, Type even, Type odd)
+    {
+        int32x4x2_t pair;
+        pair.val[0] = even;
+        pair.val[1] = odd;
+        vst2q_s32(data, pair);
+    }
+};
+#endif
+
+#if defined(OUTPOST_COMPRESSION_LEGALL_AVX2) || defined(OUTPOST_COMPRESSION_LEGALL_SSE2) \
+        || defined(OUTPOST_COMPRESSION_LEGALL_NEON)
+/// floor(-v / 8), coefficient -0.125
+static inline Vector::Type
+tapMinusOneEighth(Vector::Type v)
+{
+    // -ceil(v / 8) without negating v, which would overflow for INT32_MIN
+    const Vector::Type roundUp =
+            Vector::shiftRight<3>(Vector::subtract(Vector::set(0), Vector::mask(v, 7)));
+    return Vector::subtract(roundUp, Vector::shiftRight<3>(v));
+}
+
+/// floor(v / 4), coefficient 0.25
+static inline Vector::Type
+tapOneQuarter(Vector::Type v)
+{
+    return Vector::shiftRight<2>(v);
+}
+
+/// floor(3 * v / 4), coefficient 0.75
+static inline Vector::Type
+tapThreeQuarters(Vector::Type v)
+{
+    // With v = 4 * a + b: 3 * a + floor(3 * b / 4)
+    const Vector::Type a = Vector::shiftRight<2>(v);
+    const Vector::Type b = Vector::mask(v, 3);
+    return Vector::add(Vector::add(Vector::shiftLeft<1>(a), a),
+                       Vector::shiftRight<2>(Vector::add(Vector::shiftLeft<1>(b), b)));
+}
+
+/// floor(-v / 2), coefficient -0.5
+static inline Vector::Type
+tapMinusOneHalf(Vector::Type v)
+{
+    // -ceil(v / 2)
+    const Vector::Type roundedUp = Vector::add(Vector::shiftRight<1>(v), Vector::mask(v, 1));
+    return Vector::subtract(Vector::set(0), roundedUp);
+}
+
+/// floor(v / 2), coefficient 0.5
+static inline Vector::Type
+tapOneHalf(Vector::Type v)
+{
+    return Vector::shiftRight<1>(v);
+}
+
+/// floor(-7 * v / 2), coefficient -3.5
+static inline Vector::Type
+tapMinusSevenHalves(Vector::Type v)
+{
+    // With v = 2 * a + b: -(7 * a + 4 * b)
+    const Vector::Type a = Vector::shiftRight<1>(v);
+    const Vector::Type b = Vector::mask(v, 1);
+    return Vector::subtract(Vector::subtract(a, Vector::shiftLeft<3>(a)), Vector::shiftLeft<2>(b));
+}
+
+/**
+ * Lowpass coefficients from the inputs 2i to 2i+4.
+ */
+static inline Vector::Type
+lowpass(Vector::Type e0, Vector::Type o0, Vector::Type e1, Vector::Type o1, Vector::Type e2)
+{
+    Vector::Type l = tapMinusOneEighth(e0);
+    l = Vector::add(l, tapOneQuarter(o0));
+    l = Vector::add(l, tapThreeQuarters(e1));
+    l = Vector::add(l, tapOneQuarter(o1));
+    return Vector::add(l, tapMinusOneEighth(e2));
+}
+
+/**
+ * Highpass coefficient of the lifting scheme calculated from the lowpass
+ * coefficient \p l, with the coefficients 4.0, -3.5, -1.0 and 0.5.
+ */
+static inline Vector::Type
+liftingHighpass(Vector::Type l, Vector::Type e1, Vector::Type o1, Vector::Type e2)
+{
+    Vector::Type h = Vector::shiftLeft<2>(l);
+    h = Vector::add(h, tapMinusSevenHalves(e1));
+    h = Vector::subtract(h, o1);
+    return Vector::add(h, tapOneHalf(e2));
+}
+
+/**
+ * Computes \p count lowpass and highpass coefficients of a single
+ * transformation level.
+ *
+ * Output \c i is calculated from the inputs \c 2i to \c 2i+4, which must
+ * all be available.
+ *
+ * \return  Number of calculated coefficients. The remaining ones have to
+ *          be calculated by the caller.
+ */
+static inline size_t
+forward(const int32_t* in, int32_t* low, int32_t* high, size_t count)
+{
+    size_t i = 0;
+    for (; i + Vector::width <= count; i += Vector::width)
+    {
+        Vector::Type e0, o0, e1, o1, e2, unused;
+        Vector::loadDeinterleaved(&in[2 * i], e0, o0);
+        Vector::loadDeinterleaved(&in[2 * i + 2], e1, o1);
+        Vector::loadDeinterleaved(&in[2 * i + 4], e2, unused);
+
+        const Vector::Type h =
+                Vector::add(Vector::add(tapMinusOneHalf(e0), o0), tapMinusOneHalf(e1));
+
+        Vector::store(&low[i], lowpass(e0, o0, e1, o1, e2));
+        Vector::store(&high[i], h);
+    }
+    return i;
+}
+
+/**
+ * Computes \p count pairs of lowpass and highpass coefficients of the first
+ * level of the in place transformation.
+ *
+ * Pair \c i is stored at \c 2i and \c 2i+1 and calculated from the inputs
+ * \c 2i to \c 2i+4.
+ *
+ * \return  Number of calculated pairs. The remaining ones have to be
+ *          calculated by the caller.
+ */
+static inline size_t
+forwardInPlace(int32_t* data, size_t count)
+{
+    size_t i = 0;
+    for (; i + Vector::width <= count; i += Vector::width)
+    {
+        // Everything is loaded before the first store, later pairs read
+        // the original values of their neighbours
+        Vector::Type e0, o0, e1, o1, e2, unused;
+        Vector::loadDeinterleaved(&data[2 * i], e0, o0);
+        Vector::loadDeinterleaved(&data[2 * i + 2], e1, o1);
+        Vector::loadDeinterleaved(&data[2 * i + 4], e2, unused);
+
+        const Vector::Type l = lowpass(e0, o0, e1, o1, e2);
+        Vector::storeInterleaved(&data[2 * i], l, liftingHighpass(l, e1, o1, e2));
+    }
+    return i;
+}
+
+/**
+ * Computes \p count lowpass and highpass coefficients of a single level of
+ * the in place transformation, but stores them in separate bands.
+ *
+ * Output \c i is calculated from the inputs \c 2i to \c 2i+4, which must
+ * all be available. The results are identical to forwardInPlace().
+ *
+ * \return  Number of calculated coefficients. The remaining ones have to
+ *          be calculated by the caller.
+ */
+static inline size_t
+forwardLifting(const int32_t* in, int32_t* low, int32_t* high, size_t count)
+{
+    size_t i = 0;
+    for (; i + Vector::width <= count; i += Vector::width)
+    {
+        Vector::Type e0, o0, e1, o1, e2, unused;
+        Vector::loadDeinterleaved(&in[2 * i], e0, o0);
+        Vector::loadDeinterleaved(&in[2 * i + 2], e1, o1);
+        Vector::loadDeinterleaved(&in[2 * i + 4], e2, unused);
+
+        const Vector::Type l = lowpass(e0, o0, e1, o1, e2);
+        Vector::store(&low[i], l);
+        Vector::store(&high[i], liftingHighpass(l, e1, o1, e2));
+    }
+    return i;
+}
+#else
+static inline size_t
+forward(const int32_t*, int32_t*, int32_t*, size_t)
+{
+    return 0;
+}
+
+static inline size_t
+forwardInPlace(int32_t*, size_t)
+{
+    return 0;
+}
+
+static inline size_t
+forwardLifting(const int32_t*, int32_t*, int32_t*, size_t)
+{
+    return 0;
+}
+#endif
+
+}  // namespace legall
+}  // namespace compression
+}  // namespace outpost
+
+#endif
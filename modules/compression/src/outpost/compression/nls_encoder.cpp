@@ -85,25 +85,13 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
     int8_t n = Log2(max);
     uint16_t s = 1 << n;
 
-    // Put the number of bitplanes in the output stream
-    for (int8_t i = 3; i >= 0; i--)
-    {
-        outBuffer.pushBit(static_cast<uint16_t>(1 << i) & n);
-    }
-
-    // Put the number of DC components in the output stream
-    for (int8_t i = 3; i >= 0; i--)
-    {
-        outBuffer.pushBit(static_cast<uint8_t>(1 << i) & dcComponents);
-    }
+    BitstreamWriter writer(outBuffer);
 
-    // Put the number of coefficients in the output stream
-    size_t exponent = Log2(inBuffer.getNumberOfElements());
-    for (int8_t i = 3; i >= 0; i--)
-    {
-        size_t tmp = static_cast<size_t>(1 << i) & exponent;
-        outBuffer.pushBit(tmp > 0);
-    }
+    // Put the number of bitplanes, the number of DC components and the number
+    // of coefficients in the output stream
+    writer.pushBits(n, 4);
+    writer.pushBits(dcComponents, 4);
+    writer.pushBits(static_cast<uint32_t>(Log2(inBuffer.getNumberOfElements())), 4);
 
     // Initialize the state marker table
     uint16_t i = 0;
@@ -136,10 +124,10 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
                 // If the coefficient is significant, mark it MNP and push this information and its
                 // sign bit to the output stream
                 bool sig = std::abs(inBuffer[j]) >= s;
-                outBuffer.pushBit(sig);
+                writer.pushBit(sig);
                 if (sig)
                 {
-                    outBuffer.pushBit(inBuffer[j] < 0);
+                    writer.pushBit(inBuffer[j] < 0);
                     mark[j] = MNP;
                     inBuffer[j] = std::abs(inBuffer[j]);
                 }
@@ -152,7 +140,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
         }
 
         // Break if the maximum number of output bytes is reached.
-        if (outBuffer.getSize() > maxBytes)
+        if (writer.getSize() > maxBytes)
         {
             break;
         }
@@ -165,7 +153,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
             if (mark[j] == MD)
             {
                 bool sig = dmax[j >> 1] >= s;
-                outBuffer.pushBit(sig);
+                writer.pushBit(sig);
                 if (sig)
                 {
                     mark[j] = mark[j + 1] = MCP;
@@ -182,7 +170,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
             else if (mark[j] == MG)
             {
                 bool sig = gmax[j >> 2] >= s;
-                outBuffer.pushBit(sig);
+                writer.pushBit(sig);
                 if (sig)
                 {
                     mark[j] = mark[j + 2] = MD;
@@ -197,10 +185,10 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
             else if (mark[j] == MCP)
             {
                 bool sig = std::abs(inBuffer[j]) >= s;
-                outBuffer.pushBit(sig);
+                writer.pushBit(sig);
                 if (sig)
                 {
-                    outBuffer.pushBit(inBuffer[j] < 0);
+                    writer.pushBit(inBuffer[j] < 0);
                     mark[j] = MNP;
                     inBuffer[j] = std::abs(inBuffer[j]);
                 }
@@ -217,7 +205,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
         }
 
         // Break if the maximum number of output bytes is reached.
-        if (outBuffer.getSize() > maxBytes)
+        if (writer.getSize() > maxBytes)
         {
             break;
         }
@@ -229,7 +217,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
             // Push significant coefficients to the output stream
             if (mark[j] == MSP)
             {
-                outBuffer.pushBit((inBuffer[j] & s) > 0);
+                writer.pushBit((inBuffer[j] & s) > 0);
                 j++;
             }
             // Newly identified significant coefficients shall be refined in the next pass
@@ -245,7 +233,7 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
         }
 
         // Break if the maximum number of output bytes is reached.
-        if (outBuffer.getSize() > maxBytes)
+        if (writer.getSize() > maxBytes)
         {
             break;
         }
@@ -254,6 +242,8 @@ NLSEncoder::encode(outpost::Slice<int16_t> inBuffer,
         n--;
         s = s >> 1;
     }
+
+    writer.flush();
 }
 
 void
@@ -302,7 +292,8 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
         push(i, outBufferLength);
     }
 
-    uint16_t buffer_bit_pointer = 12;
+    // Skip the header of 12 bits
+    BitstreamReader reader(inBuffer, 12);
 
     while (n >= 0)
     {
@@ -312,10 +303,10 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
         {
             if (mark[i] == MIP)
             {
-                bool sig = inBuffer.getBit(buffer_bit_pointer++);
+                bool sig = reader.getBit();
                 if (sig)
                 {
-                    signs[i] = inBuffer.getBit(buffer_bit_pointer++);
+                    signs[i] = reader.getBit();
                     mark[i] = MNP;
                     outBuffer[i] += (1 - 2 * signs[i]) * (s + (s >> 1));
                 }
@@ -327,7 +318,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
             }
         }
 
-        if (buffer_bit_pointer >> 3 > inBuffer.getSize())
+        if (reader.getPosition() >> 3 > inBuffer.getSize())
         {
             break;
         }
@@ -338,7 +329,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
         {
             if (mark[i] == MD)
             {
-                bool sig = inBuffer.getBit(buffer_bit_pointer++);
+                bool sig = reader.getBit();
                 if (sig)
                 {
                     mark[i] = mark[i + 1] = MCP;
@@ -354,7 +345,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
             }
             else if (mark[i] == MG)
             {
-                bool sig = inBuffer.getBit(buffer_bit_pointer++);
+                bool sig = reader.getBit();
                 if (sig)
                 {
                     mark[i] = mark[i + 2] = MD;
@@ -368,10 +359,10 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
             }
             else if (mark[i] == MCP)
             {
-                bool sig = inBuffer.getBit(buffer_bit_pointer++);
+                bool sig = reader.getBit();
                 if (sig)
                 {
-                    signs[i] = inBuffer.getBit(buffer_bit_pointer++);
+                    signs[i] = reader.getBit();
                     mark[i] = MNP;
                     outBuffer[i] += (1 - 2 * signs[i]) * (s + (s >> 1));
                 }
@@ -387,7 +378,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
             }
         }
 
-        if (buffer_bit_pointer >> 3 > inBuffer.getSize())
+        if (reader.getPosition() >> 3 > inBuffer.getSize())
         {
             break;
         }
@@ -398,7 +389,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
         {
             if (mark[i] == MSP)
             {
-                bool sig = inBuffer.getBit(buffer_bit_pointer++);
+                bool sig = reader.getBit();
 
                 if (sig)
                 {
@@ -421,7 +412,7 @@ NLSEncoder::decode(Bitstream& inBuffer, outpost::Slice<int16_t> outBuffer)
             }
         }
 
-        if (buffer_bit_pointer >> 3 > inBuffer.getSize())
+        if (reader.getPosition() >> 3 > inBuffer.getSize())
         {
             break;
         }
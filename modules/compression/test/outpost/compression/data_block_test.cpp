@@ -18,6 +18,8 @@
 
 #include <unittest/harness.h>
 
+#include <utility>
+
 using namespace testing;
 using namespace outpost;
 using namespace compression;
@@ -135,6 +137,33 @@ TEST_F(DataBlockTest, Push)
     }
 }
 
+TEST_F(DataBlockTest, Move)
+{
+    outpost::utils::SharedBufferPointer p;
+    ASSERT_TRUE(mPool.allocate(p));
+    outpost::compression::DataBlock block(
+            p,
+            123U,
+            outpost::time::GpsTime::afterEpoch(outpost::time::Hours(3U)),
+            outpost::compression::SamplingRate::hz05,
+            outpost::compression::Blocksize::bs16);
+    EXPECT_TRUE(block.push(Fixpoint(7)));
+    EXPECT_EQ(2U, p->getReferenceCount());
+
+    outpost::compression::DataBlock moved(std::move(block));
+    EXPECT_FALSE(block.isValid());
+    EXPECT_TRUE(moved.isValid());
+    EXPECT_EQ(2U, p->getReferenceCount());
+
+    outpost::compression::DataBlock target;
+    target = std::move(moved);
+    EXPECT_FALSE(moved.isValid());
+    EXPECT_EQ(2U, p->getReferenceCount());
+    EXPECT_EQ(123U, target.getParameterId());
+    ASSERT_EQ(1U, target.getSamples().getNumberOfElements());
+    EXPECT_EQ(Fixpoint(7), target.getSamples()[0]);
+}
+
 TEST_F(DataBlockTest, GetSamples)
 {
     outpost::utils::SharedBufferPointer p;
@@ -190,6 +219,49 @@ TEST_F(DataBlockTest, GetCoefficients)
     EXPECT_EQ(coefficients.getNumberOfElements(), 16U);
 }
 
+TEST_F(DataBlockTest, GetCoefficientsWithScratch)
+{
+    outpost::utils::SharedBufferPointer p1;
+    outpost::utils::SharedBufferPointer p2;
+    mPool.allocate(p1);
+    mPool.allocate(p2);
+    outpost::compression::DataBlock block(
+            p1,
+            123U,
+            outpost::time::GpsTime::afterEpoch(outpost::time::Hours(3U)),
+            outpost::compression::SamplingRate::hz05,
+            outpost::compression::Blocksize::bs128);
+    outpost::compression::DataBlock reference(
+            p2,
+            123U,
+            outpost::time::GpsTime::afterEpoch(outpost::time::Hours(3U)),
+            outpost::compression::SamplingRate::hz05,
+            outpost::compression::Blocksize::bs128);
+
+    for (int16_t i = 0; i < 128; i++)
+    {
+        block.push(Fixpoint(static_cast<int16_t>((i * 37) % 101 - 50)));
+        reference.push(Fixpoint(static_cast<int16_t>((i * 37) % 101 - 50)));
+    }
+
+    Fixpoint scratch[128];
+    EXPECT_FALSE(block.applyWaveletTransform(outpost::Slice<Fixpoint>(scratch).first(64)));
+    EXPECT_FALSE(block.isTransformed());
+
+    EXPECT_TRUE(block.applyWaveletTransform(outpost::Slice<Fixpoint>(scratch)));
+    EXPECT_TRUE(block.isTransformed());
+    EXPECT_FALSE(block.applyWaveletTransform(outpost::Slice<Fixpoint>(scratch)));
+    ASSERT_TRUE(reference.applyWaveletTransform());
+
+    outpost::Slice<int16_t> coefficients = block.getCoefficients();
+    outpost::Slice<int16_t> expected = reference.getCoefficients();
+    ASSERT_EQ(coefficients.getNumberOfElements(), 128U);
+    for (size_t i = 0; i < 128; i++)
+    {
+        EXPECT_EQ(coefficients[i], expected[i]);
+    }
+}
+
 TEST_F(DataBlockTest, Encode)
 {
     outpost::compression::NLSEncoder encoder;
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Throughput of the DataProcessorPool for 1 to 8 workers.
+ *
+ * Each worker is driven by its own std::thread calling processSingleBlock().
+ * A producer thread feeds blocks of 4096 samples for several parameters, the
+ * test thread collects the encoded blocks. The speedup is limited by the
+ * number of available cores.
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include <outpost/base/fixpoint.h>
+#include <outpost/compression/data_block.h>
+#include <outpost/compression/data_processor_pool.h>
+#include <outpost/utils/container/reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using outpost::compression::Blocksize;
+using outpost::compression::DataBlock;
+using outpost::compression::DataProcessorPool;
+using outpost::compression::SamplingRate;
+
+namespace
+{
+static const uint32_t numberOfBlocks = 256;
+static const uint16_t numberOfParameters = 8;
+static const size_t blockLength = 4096;
+
+typedef outpost::utils::SharedBufferPool<16400, 64> BenchmarkBufferPool;
+typedef outpost::utils::ReferenceQueue<DataBlock, 16> BenchmarkQueue;
+
+/**
+ * Returns the number of encoded blocks per second.
+ */
+template <size_t numberOfWorkers>
+double
+measure(BenchmarkBufferPool& pool, const std::vector<int16_t>& samples)
+{
+    BenchmarkQueue inputQueue;
+    BenchmarkQueue outputQueue;
+    std::unique_ptr<DataProcessorPool<numberOfWorkers>> processor(
+            new DataProcessorPool<numberOfWorkers>(
+                    0U, pool, inputQueue, outputQueue, 100U, outpost::time::Milliseconds(1)));
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < numberOfBlocks; i++)
+        {
+            outpost::utils::SharedBufferPointer p;
+            while (!pool.allocate(p))
+            {
+                std::this_thread::yield();
+            }
+            DataBlock block(p,
+                            i % numberOfParameters,
+                            outpost::time::GpsTime::afterEpoch(outpost::time::Milliseconds(i)),
+                            SamplingRate::hz10,
+                            Blocksize::bs4096);
+            for (size_t k = 0; k < blockLength; k++)
+            {
+                block.push(outpost::Fixpoint(samples[(i * 97 + k) % samples.size()]));
+            }
+            while (!inputQueue.send(block))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < numberOfWorkers; w++)
+    {
+        workers.emplace_back([&processor, w]() {
+            while (processor->getNumberOfReceivedBlocks() < numberOfBlocks)
+            {
+                processor->processSingleBlock(w, outpost::time::Milliseconds(1));
+            }
+        });
+    }
+
+    uint32_t received = 0;
+    DataBlock block;
+    while (received < numberOfBlocks && outputQueue.receive(block, outpost::time::Seconds(10)))
+    {
+        block = DataBlock();
+        received++;
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    producer.join();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    EXPECT_EQ(numberOfBlocks, received);
+
+    return received / duration.count();
+}
+
+template <size_t numberOfWorkers>
+void
+printMeasurement(BenchmarkBufferPool& pool, const std::vector<int16_t>& samples, double& baseline)
+{
+    const double blocksPerSecond = measure<numberOfWorkers>(pool, samples);
+    if (numberOfWorkers == 1)
+    {
+        baseline = blocksPerSecond;
+    }
+    printf("%7zu | %10.1f | %12.2f | %7.2f\n",
+           numberOfWorkers,
+           blocksPerSecond,
+           blocksPerSecond * blockLength / 1e6,
+           blocksPerSecond / baseline);
+}
+}  // namespace
+
+TEST(DataProcessorPoolBenchmark, DISABLED_scalingWithNumberOfWorkers)
+{
+    std::unique_ptr<BenchmarkBufferPool> pool(new BenchmarkBufferPool);
+
+    // Smooth signal with noise, similar to sensor data
+    std::vector<int16_t> samples(8192);
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        samples[i] = static_cast<int16_t>((i % 1024) - 512 + rand() % 64);
+    }
+
+    printf("%u blocks of %zu samples, %u parameters, %u hardware threads\n",
+           numberOfBlocks,
+           blockLength,
+           numberOfParameters,
+           std::thread::hardware_concurrency());
+    printf("workers | [blocks/s] | [MSamples/s] | speedup\n");
+
+    double baseline = 0;
+    printMeasurement<1>(*pool, samples, baseline);
+    printMeasurement<2>(*pool, samples, baseline);
+    printMeasurement<3>(*pool, samples, baseline);
+    printMeasurement<4>(*pool, samples, baseline);
+    printMeasurement<5>(*pool, samples, baseline);
+    printMeasurement<6>(*pool, samples, baseline);
+    printMeasurement<7>(*pool, samples, baseline);
+    printMeasurement<8>(*pool, samples, baseline);
+}
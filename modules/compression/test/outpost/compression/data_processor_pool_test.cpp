@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/base/fixpoint.h>
+#include <outpost/compression/data_block.h>
+#include <outpost/compression/data_processor_pool.h>
+#include <outpost/compression/data_processor_thread.h>
+#include <outpost/utils/container/reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using outpost::compression::Blocksize;
+using outpost::compression::DataBlock;
+using outpost::compression::DataProcessorPool;
+using outpost::compression::DataProcessorThread;
+using outpost::compression::SamplingRate;
+
+class DataProcessorPoolTest : public ::testing::Test
+{
+public:
+    DataBlock
+    createBlock(uint16_t parameterId, uint32_t sequence, Blocksize bs)
+    {
+        outpost::utils::SharedBufferPointer p;
+        while (!mPool.allocate(p))
+        {
+            std::this_thread::yield();
+        }
+
+        DataBlock block(p,
+                        parameterId,
+                        outpost::time::GpsTime::afterEpoch(outpost::time::Milliseconds(sequence)),
+                        SamplingRate::hz10,
+                        bs);
+        for (int32_t i = 0; i < outpost::compression::toUInt(bs); i++)
+        {
+            block.push(outpost::Fixpoint(static_cast<int16_t>((i * 37 + sequence) % 512 - 256)));
+        }
+        return block;
+    }
+
+    outpost::utils::SharedBufferPool<16384, 32> mPool;
+    outpost::utils::ReferenceQueue<DataBlock, 8> mInputQueue;
+    outpost::utils::ReferenceQueue<DataBlock, 8> mOutputQueue;
+};
+
+TEST_F(DataProcessorPoolTest, Constructor)
+{
+    DataProcessorPool<3> processor(123U, mPool, mInputQueue, mOutputQueue);
+
+    EXPECT_EQ(processor.getNumberOfWorkers(), 3U);
+    EXPECT_EQ(processor.getNumberOfReceivedBlocks(), 0U);
+    EXPECT_EQ(processor.getNumberOfProcessedBlocks(), 0U);
+    EXPECT_EQ(processor.getNumberOfForwardedBlocks(), 0U);
+    EXPECT_EQ(processor.getNumberOfLostBlocks(), 0U);
+
+    EXPECT_FALSE(processor.isEnabled());
+    processor.enable();
+    EXPECT_TRUE(processor.isEnabled());
+    processor.disable();
+    EXPECT_FALSE(processor.isEnabled());
+}
+
+TEST_F(DataProcessorPoolTest, processSingleInvalidBlock)
+{
+    DataProcessorPool<2> processor(123U, mPool, mInputQueue, mOutputQueue);
+
+    DataBlock block;
+    mInputQueue.send(block);
+    processor.processSingleBlock(1, outpost::time::Duration::zero());
+    processor.processSingleBlock(1, outpost::time::Duration::zero());
+
+    EXPECT_EQ(processor.getNumberOfReceivedBlocks(), 1U);
+    EXPECT_EQ(processor.getNumberOfProcessedBlocks(), 0U);
+    EXPECT_FALSE(mOutputQueue.receive(block, outpost::time::Duration::zero()));
+}
+
+TEST_F(DataProcessorPoolTest, shouldEncodeLikeDataProcessorThread)
+{
+    DataProcessorPool<2> processor(
+            123U, mPool, mInputQueue, mOutputQueue, 2U, outpost::time::Duration::zero());
+    DataProcessorThread thread(
+            123U, mPool, mInputQueue, mOutputQueue, 2U, outpost::time::Duration::zero());
+
+    DataBlock expected;
+    mInputQueue.send(createBlock(7U, 1U, Blocksize::bs512));
+    thread.processSingleBlock(outpost::time::Duration::zero());
+    ASSERT_TRUE(mOutputQueue.receive(expected, outpost::time::Duration::zero()));
+
+    DataBlock actual;
+    mInputQueue.send(createBlock(7U, 1U, Blocksize::bs512));
+    processor.processSingleBlock(1, outpost::time::Duration::zero());
+    ASSERT_TRUE(mOutputQueue.receive(actual, outpost::time::Duration::zero()));
+
+    EXPECT_EQ(processor.getNumberOfReceivedBlocks(), 1U);
+    EXPECT_EQ(processor.getNumberOfProcessedBlocks(), 1U);
+    EXPECT_EQ(processor.getNumberOfForwardedBlocks(), 1U);
+    EXPECT_EQ(processor.getNumberOfLostBlocks(), 0U);
+
+    ASSERT_TRUE(actual.isEncoded());
+    EXPECT_EQ(actual.getParameterId(), 7U);
+    outpost::Slice<uint8_t> expectedData = expected.getEncodedData();
+    outpost::Slice<uint8_t> actualData = actual.getEncodedData();
+    ASSERT_EQ(expectedData.getNumberOfElements(), actualData.getNumberOfElements());
+    for (size_t i = 0; i < expectedData.getNumberOfElements(); i++)
+    {
+        EXPECT_EQ(expectedData[i], actualData[i]) << "index " << i;
+    }
+
+    processor.resetCounters();
+    EXPECT_EQ(processor.getNumberOfReceivedBlocks(), 0U);
+    EXPECT_EQ(processor.getNumberOfForwardedBlocks(), 0U);
+}
+
+TEST_F(DataProcessorPoolTest, shouldKeepOrderPerParameter)
+{
+    static constexpr uint32_t numberOfBlocks = 200;
+    static constexpr uint16_t numberOfParameters = 3;
+    DataProcessorPool<4> processor(
+            123U, mPool, mInputQueue, mOutputQueue, 100U, outpost::time::Milliseconds(1));
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < numberOfBlocks; i++)
+        {
+            // Different block sizes lead to different processing times
+            const Blocksize bs = (i % 4 == 0) ? Blocksize::bs1024 : Blocksize::bs16;
+            DataBlock block = createBlock(i % numberOfParameters, i, bs);
+            while (!mInputQueue.send(block))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < processor.getNumberOfWorkers(); w++)
+    {
+        workers.emplace_back([&processor, w]() {
+            while (processor.getNumberOfReceivedBlocks() < numberOfBlocks)
+            {
+                processor.processSingleBlock(w, outpost::time::Milliseconds(1));
+            }
+        });
+    }
+
+    int64_t lastSequence[numberOfParameters] = {-1, -1, -1};
+    size_t errors = 0;
+    for (uint32_t received = 0; received < numberOfBlocks; received++)
+    {
+        DataBlock block;
+        if (!mOutputQueue.receive(block, outpost::time::Seconds(10)))
+        {
+            ADD_FAILURE() << "missing blocks after " << received;
+            break;
+        }
+        const int64_t sequence = block.getStartTime().timeSinceEpoch().milliseconds();
+        const uint16_t parameter = block.getParameterId();
+        if (parameter >= numberOfParameters || sequence <= lastSequence[parameter])
+        {
+            errors++;
+        }
+        else
+        {
+            lastSequence[parameter] = sequence;
+        }
+    }
+
+    producer.join();
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(0U, errors);
+    EXPECT_EQ(processor.getNumberOfForwardedBlocks(), numberOfBlocks);
+    EXPECT_EQ(processor.getNumberOfLostBlocks(), 0U);
+}
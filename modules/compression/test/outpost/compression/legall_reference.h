@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Scalar Q16 implementation of the LeGall 5/3 forward transformation as it
+ * was used before the vectorized kernels were introduced. Serves as
+ * reference for bit-identical results and as benchmark baseline.
+ */
+
+#ifndef UNITTEST_COMPRESSION_LEGALL_REFERENCE_H
+#define UNITTEST_COMPRESSION_LEGALL_REFERENCE_H
+
+#include <outpost/base/fixpoint.h>
+#include <outpost/base/slice.h>
+
+#include <string.h>
+
+namespace legall_reference
+{
+using outpost::Fixpoint;
+
+static const Fixpoint h0 = -0.125;
+static const Fixpoint h1 = 0.25;
+static const Fixpoint h2 = 0.75;
+static const Fixpoint h3 = 0.25;
+static const Fixpoint h4 = -0.125;
+
+static const Fixpoint g0 = -0.5;
+static const Fixpoint g1 = 1.0;
+static const Fixpoint g2 = -0.5;
+
+static const Fixpoint ip_g0 = 4.0;
+static const Fixpoint ip_g2 = -3.5;
+static const Fixpoint ip_g3 = -1.0;
+static const Fixpoint ip_g4 = 0.5;
+
+inline void
+forwardTransform(outpost::Slice<Fixpoint> inBuffer, outpost::Slice<Fixpoint> outBuffer)
+{
+    size_t halfBufferLength = inBuffer.getNumberOfElements();
+
+    size_t step;
+    // Perform log2 passes, bisecting the buffer after each pass
+    for (step = 0; halfBufferLength > 2; step++)
+    {
+        // Calculate high- and lowpass coefficients for the general case
+        halfBufferLength = halfBufferLength >> 1;
+        for (size_t i = 0; i < halfBufferLength - 2; i++)
+        {
+            // Lowpass
+            outBuffer[i] = h0 * inBuffer[2 * i] + h1 * inBuffer[2 * i + 1]
+                           + h2 * inBuffer[2 * i + 2] + h3 * inBuffer[2 * i + 3]
+                           + h4 * inBuffer[2 * i + 4];
+            // Highpass
+            outBuffer[i + halfBufferLength] =
+                    g0 * inBuffer[2 * i] + g1 * inBuffer[2 * i + 1] + g2 * inBuffer[2 * i + 2];
+        }
+
+        // Handle lapping cases
+        outBuffer[halfBufferLength - 2] =
+                h0 * inBuffer[2 * halfBufferLength - 4] + h1 * inBuffer[2 * halfBufferLength - 3]
+                + h2 * inBuffer[2 * halfBufferLength - 2] + h3 * inBuffer[2 * halfBufferLength - 1]
+                + h4 * inBuffer[0];
+        outBuffer[2 * halfBufferLength - 2] = g0 * inBuffer[2 * halfBufferLength - 4]
+                                              + g1 * inBuffer[2 * halfBufferLength - 3]
+                                              + g2 * inBuffer[2 * halfBufferLength - 2];
+
+        outBuffer[halfBufferLength - 1] = h0 * inBuffer[2 * halfBufferLength - 2]
+                                          + h1 * inBuffer[2 * halfBufferLength - 1]
+                                          + h2 * inBuffer[0] + h3 * inBuffer[1] + h4 * inBuffer[2];
+        outBuffer[2 * halfBufferLength - 1] = g0 * inBuffer[2 * halfBufferLength - 2]
+                                              + g1 * inBuffer[2 * halfBufferLength - 1]
+                                              + g2 * inBuffer[0];
+
+        // Swap buffers for the subsequent pass
+        outpost::Slice<Fixpoint> tmp = inBuffer;
+        inBuffer = outBuffer;
+        outBuffer = tmp;
+    }
+
+    // With coefficients of different levels spread through both buffers, these need to be copied to
+    // outBuffer
+    size_t steps = step;
+    if (step % 2)
+    {
+        outpost::Slice<Fixpoint> tmp = inBuffer;
+        inBuffer = outBuffer;
+        outBuffer = tmp;
+        step = 2;
+    }
+    else
+    {
+        step = 1;
+        memcpy(&outBuffer[0], &inBuffer[0], 16);
+    }
+
+    for (; step < steps; step += 2)
+    {
+        memcpy(&outBuffer[1 << step], &inBuffer[1 << step], (1 << (step + 2)));
+    }
+}
+
+inline void
+forwardTransformInPlace(outpost::Slice<Fixpoint> inBuffer)
+{
+    int16_t length = inBuffer.getNumberOfElements();
+    uint16_t inBufferLength = inBuffer.getNumberOfElements();
+
+    // Perform log2 passes, bisecting the buffer after each pass
+    for (uint16_t step = 0; length >= 3; step++)
+    {
+        // Temporarily save these for handling of lapping cases
+        Fixpoint tmpBuffer[3] = {inBuffer[0], inBuffer[1 << step], inBuffer[2 << step]};
+
+        // Calculate highpass and lowpass coefficients using the lifting scheme
+        for (size_t i = 0; ((i + 4) << step) < inBufferLength; i += 2)
+        {
+            inBuffer[(i << step)] = h0 * inBuffer[i << step] + h1 * inBuffer[(i + 1) << step]
+                                    + h2 * inBuffer[(i + 2) << step]
+                                    + h3 * inBuffer[(i + 3) << step]
+                                    + h4 * inBuffer[(i + 4) << step];
+            inBuffer[(i + 1) << step] =
+                    ip_g0 * inBuffer[i << step] + ip_g2 * inBuffer[(i + 2) << step]
+                    + ip_g3 * inBuffer[(i + 3) << step] + ip_g4 * inBuffer[(i + 4) << step];
+        }
+        // Handle corner cases with lapping coefficients.
+        inBuffer[inBufferLength - (4 << step)] = h0 * inBuffer[inBufferLength - (4 << step)]
+                                                 + h1 * inBuffer[inBufferLength - (3 << step)]
+                                                 + h2 * inBuffer[inBufferLength - (2 << step)]
+                                                 + h3 * inBuffer[inBufferLength - (1 << step)]
+                                                 + h4 * tmpBuffer[0];
+        inBuffer[inBufferLength - (3 << step)] = ip_g0 * inBuffer[inBufferLength - (4 << step)]
+                                                 + ip_g2 * inBuffer[inBufferLength - (2 << step)]
+                                                 + ip_g3 * inBuffer[inBufferLength - (1 << step)]
+                                                 + ip_g4 * tmpBuffer[0];
+        inBuffer[inBufferLength - (2 << step)] = h0 * inBuffer[inBufferLength - (2 << step)]
+                                                 + h1 * inBuffer[inBufferLength - (1 << step)]
+                                                 + h2 * tmpBuffer[0] + h3 * tmpBuffer[1]
+                                                 + h4 * tmpBuffer[2];
+        inBuffer[inBufferLength - (1 << step)] = ip_g0 * inBuffer[inBufferLength - (2 << step)]
+                                                 + ip_g2 * tmpBuffer[0] + ip_g3 * tmpBuffer[1]
+                                                 + ip_g4 * tmpBuffer[2];
+        length >>= 1;
+    }
+}
+
+}  // namespace legall_reference
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Throughput of NLSEncoder::encode() and decode() for wavelet coefficients.
+ *
+ * The throughput is given in MB/s of int16_t coefficients. Every encode
+ * iteration also restores the coefficients, as the encoder modifies them.
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include <outpost/base/fixpoint.h>
+#include <outpost/base/slice.h>
+#include <outpost/compression/legall_wavelet.h>
+#include <outpost/compression/nls_encoder.h>
+#include <outpost/utils/storage/bitstream.h>
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+using outpost::compression::LeGall53Wavelet;
+using outpost::compression::NLSEncoder;
+
+namespace
+{
+static const size_t bytesPerMeasurement = 1 << 24;
+
+/**
+ * Wavelet coefficients of a sawtooth signal with the given noise amplitude.
+ */
+std::vector<int16_t>
+createCoefficients(size_t length, int noise)
+{
+    std::vector<outpost::Fixpoint> samples(length);
+    std::vector<outpost::Fixpoint> scratch(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        samples[i] = outpost::Fixpoint(
+                static_cast<int16_t>((i % 512) * 4 - 1024 + rand() % noise - noise / 2));
+    }
+    outpost::Slice<int16_t> coefficients = LeGall53Wavelet::forwardTransformContiguous(
+            outpost::asSlice(samples), outpost::asSlice(scratch));
+    return std::vector<int16_t>(coefficients.begin(), coefficients.end());
+}
+
+void
+measure(const char* name, const std::vector<int16_t>& coefficients)
+{
+    const size_t length = coefficients.size();
+    const size_t iterations = bytesPerMeasurement / (length * sizeof(int16_t));
+
+    NLSEncoder encoder;
+    std::vector<int16_t> in(length);
+    std::vector<int16_t> out(length);
+    std::vector<uint8_t> buffer(length * sizeof(int16_t) + outpost::Bitstream::headerSize);
+    outpost::Slice<uint8_t> slice(buffer);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        in = coefficients;
+        outpost::Bitstream bitstream(slice);
+        encoder.encode(outpost::asSlice(in), bitstream);
+    }
+    std::chrono::duration<double> encodeDuration = std::chrono::steady_clock::now() - start;
+
+    in = coefficients;
+    outpost::Bitstream bitstream(slice);
+    encoder.encode(outpost::asSlice(in), bitstream);
+    const size_t encodedSize = bitstream.getSize();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        encoder.decode(bitstream, outpost::asSlice(out));
+    }
+    std::chrono::duration<double> decodeDuration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(out == coefficients);
+
+    const double megabytes = iterations * length * sizeof(int16_t) / 1e6;
+    printf("%-6s | %6zu | %12zu | %13.1f | %13.1f\n",
+           name,
+           length,
+           encodedSize,
+           megabytes / encodeDuration.count(),
+           megabytes / decodeDuration.count());
+}
+}  // namespace
+
+TEST(NLSEncoderBenchmark, DISABLED_encodeMegabytesPerSecond)
+{
+    srand(1);
+    printf("signal | length | encoded size | encode [MB/s] | decode [MB/s]\n");
+
+    const size_t lengths[] = {512, 4096};
+    for (size_t length : lengths)
+    {
+        measure("smooth", createCoefficients(length, 8));
+        measure("noisy", createCoefficients(length, 512));
+    }
+}
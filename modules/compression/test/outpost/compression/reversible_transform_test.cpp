@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/base/slice.h>
+#include <outpost/compression/legall_wavelet.h>
+
+#include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
+
+#include <unittest/harness.h>
+
+#include <vector>
+
+using ::testing::ElementsAre;
+using outpost::compression::LeGall53Wavelet;
+
+namespace
+{
+std::vector<int32_t>
+roundtrip(const std::vector<int32_t>& samples)
+{
+    std::vector<int32_t> in = samples;
+    std::vector<int32_t> coefficients(samples.size());
+    std::vector<int32_t> out(samples.size());
+
+    LeGall53Wavelet::forwardTransformReversible(outpost::asSlice(in),
+                                                outpost::asSlice(coefficients));
+    LeGall53Wavelet::backwardTransformReversible(outpost::asSlice(coefficients),
+                                                 outpost::asSlice(out));
+    return out;
+}
+}  // namespace
+
+TEST(ReversibleTransformTest, shouldTransformSingleLevel)
+{
+    int32_t in[4] = {1, 2, 3, 4};
+    int32_t out[4] = {};
+
+    LeGall53Wavelet::forwardTransformReversible(outpost::asSlice(in), outpost::asSlice(out));
+
+    EXPECT_THAT(out, ElementsAre(1, 3, 0, 1));
+}
+
+TEST(ReversibleTransformTest, constantSignalHasNoHighpassCoefficients)
+{
+    std::vector<int32_t> in(256, -1234);
+    std::vector<int32_t> out(256);
+
+    LeGall53Wavelet::forwardTransformReversible(outpost::asSlice(in), outpost::asSlice(out));
+
+    EXPECT_EQ(-1234, out[0]);
+    EXPECT_EQ(-1234, out[1]);
+    for (size_t i = 2; i < out.size(); ++i)
+    {
+        EXPECT_EQ(0, out[i]) << "index " << i;
+    }
+}
+
+TEST(ReversibleTransformTest, shouldReconstructExtremeValues)
+{
+    std::vector<int32_t> samples(4096);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = (i % 3 == 0) ? INT32_MIN : INT32_MAX;
+    }
+
+    EXPECT_EQ(samples, roundtrip(samples));
+}
+
+RC_GTEST_PROP(ReversibleTransformTest, shouldReconstructInt16Samples, ())
+{
+    const size_t length = size_t(1) << *rc::gen::inRange(0, 13);
+    const auto samples = *rc::gen::container<std::vector<int32_t>>(
+            length, rc::gen::inRange<int32_t>(INT16_MIN, INT16_MAX + 1));
+
+    RC_ASSERT(samples == roundtrip(samples));
+}
+
+RC_GTEST_PROP(ReversibleTransformTest, shouldReconstructArbitraryValues, ())
+{
+    const size_t length = size_t(1) << *rc::gen::inRange(0, 13);
+    const auto samples =
+            *rc::gen::container<std::vector<int32_t>>(length, rc::gen::arbitrary<int32_t>());
+
+    RC_ASSERT(samples == roundtrip(samples));
+}
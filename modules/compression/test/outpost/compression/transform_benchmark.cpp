@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Throughput of the LeGall 5/3 forward transformation for all block sizes.
+ *
+ * Compares the scalar Q16 reference implementation with
+ * LeGall53Wavelet::forwardTransform() and forwardTransformInPlace(), which
+ * use the vectorized kernels selected at compile time. The reversible integer
+ * transformation is compared with the fixed point forward and the floating
+ * point backward transformation. The contiguous transformation is compared
+ * with the in place transformation followed by reorder(). Every iteration
+ * also restores the input block, as the transformations modify it.
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include "legall_reference.h"
+
+#include <outpost/compression/data_block.h>
+#include <outpost/compression/legall_wavelet.h>
+
+#include <gtest/gtest.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+using outpost::Fixpoint;
+using outpost::compression::Blocksize;
+using outpost::compression::LeGall53Wavelet;
+
+namespace
+{
+static const size_t samplesPerMeasurement = 1 << 22;
+
+static const Blocksize blocksizes[] = {Blocksize::bs16,
+                                       Blocksize::bs128,
+                                       Blocksize::bs256,
+                                       Blocksize::bs512,
+                                       Blocksize::bs1024,
+                                       Blocksize::bs2048,
+                                       Blocksize::bs4096};
+
+static const char*
+getKernelName()
+{
+#if defined(OUTPOST_COMPRESSION_LEGALL_SCALAR)
+    return "scalar";
+#elif defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#elif defined(__ARM_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+/**
+ * Returns the number of transformed samples per second.
+ */
+template <typename T, typename Transform>
+double
+measure(size_t length, Transform transform)
+{
+    std::vector<T> samples(length);
+    for (auto& sample : samples)
+    {
+        sample = T(static_cast<int16_t>(rand() % 4096 - 2048));
+    }
+    std::vector<T> in(length);
+    std::vector<T> out(length);
+
+    const size_t iterations = samplesPerMeasurement / length;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        in = samples;
+        transform(outpost::asSlice(in), outpost::asSlice(out));
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    return (iterations * length) / duration.count();
+}
+}  // namespace
+
+TEST(TransformBenchmark, DISABLED_forwardTransformSamplesPerSecond)
+{
+    printf("kernel: %s, %zu samples per measurement\n", getKernelName(), samplesPerMeasurement);
+    printf("block size | reference [MSamples/s] | forwardTransform [MSamples/s] | "
+           "forwardTransformInPlace [MSamples/s] | reference in place [MSamples/s]\n");
+
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+
+        const double reference = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint> out) {
+                    legall_reference::forwardTransform(in, out);
+                });
+        const double vectorized = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint> out) {
+                    LeGall53Wavelet::forwardTransform(in, out);
+                });
+        const double inPlace = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint>) {
+                    LeGall53Wavelet::forwardTransformInPlace(in);
+                });
+        const double referenceInPlace = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint>) {
+                    legall_reference::forwardTransformInPlace(in);
+                });
+
+        printf("%10zu | %22.1f | %29.1f | %36.1f | %30.1f\n",
+               length,
+               reference / 1e6,
+               vectorized / 1e6,
+               inPlace / 1e6,
+               referenceInPlace / 1e6);
+    }
+}
+
+TEST(TransformBenchmark, DISABLED_reversibleTransformSamplesPerSecond)
+{
+    printf("%zu samples per measurement\n", samplesPerMeasurement);
+    printf("block size | forwardTransform [MSamples/s] | forwardTransformReversible "
+           "[MSamples/s] | backwardTransform [MSamples/s] | backwardTransformReversible "
+           "[MSamples/s]\n");
+
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+
+        const double forward = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint> out) {
+                    LeGall53Wavelet::forwardTransform(in, out);
+                });
+        const double forwardReversible = measure<int32_t>(
+                length, [](outpost::Slice<int32_t> in, outpost::Slice<int32_t> out) {
+                    LeGall53Wavelet::forwardTransformReversible(in, out);
+                });
+        const double backward = measure<double>(
+                length, [](outpost::Slice<double> in, outpost::Slice<double> out) {
+                    LeGall53Wavelet::backwardTransform(in, out);
+                });
+        const double backwardReversible = measure<int32_t>(
+                length, [](outpost::Slice<int32_t> in, outpost::Slice<int32_t> out) {
+                    LeGall53Wavelet::backwardTransformReversible(in, out);
+                });
+
+        printf("%10zu | %29.1f | %39.1f | %30.1f | %40.1f\n",
+               length,
+               forward / 1e6,
+               forwardReversible / 1e6,
+               backward / 1e6,
+               backwardReversible / 1e6);
+    }
+}
+
+TEST(TransformBenchmark, DISABLED_contiguousTransformSamplesPerSecond)
+{
+    printf("kernel: %s, %zu samples per measurement\n", getKernelName(), samplesPerMeasurement);
+    printf("block size | reference in place + reorder [MSamples/s] | in place + reorder "
+           "[MSamples/s] | forwardTransformContiguous [MSamples/s]\n");
+
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+
+        const double reference = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint>) {
+                    legall_reference::forwardTransformInPlace(in);
+                    LeGall53Wavelet::reorder(in);
+                });
+        const double inPlace = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint>) {
+                    LeGall53Wavelet::forwardTransformInPlace(in);
+                    LeGall53Wavelet::reorder(in);
+                });
+        const double contiguous = measure<Fixpoint>(
+                length, [](outpost::Slice<Fixpoint> in, outpost::Slice<Fixpoint> scratch) {
+                    LeGall53Wavelet::forwardTransformContiguous(in, scratch);
+                });
+
+        printf("%10zu | %41.1f | %30.1f | %39.1f\n",
+               length,
+               reference / 1e6,
+               inPlace / 1e6,
+               contiguous / 1e6);
+    }
+}
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "legall_reference.h"
+
+#include <outpost/compression/data_block.h>
+#include <outpost/compression/legall_wavelet.h>
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+
+#include <vector>
+
+using outpost::Fixpoint;
+using outpost::compression::Blocksize;
+using outpost::compression::LeGall53Wavelet;
+
+namespace
+{
+static const Blocksize blocksizes[] = {Blocksize::bs16,
+                                       Blocksize::bs128,
+                                       Blocksize::bs256,
+                                       Blocksize::bs512,
+                                       Blocksize::bs1024,
+                                       Blocksize::bs2048,
+                                       Blocksize::bs4096};
+
+std::vector<Fixpoint>
+randomSamples(size_t length)
+{
+    std::vector<Fixpoint> samples(length);
+    for (auto& sample : samples)
+    {
+        sample = static_cast<int16_t>(rand());
+    }
+    return samples;
+}
+
+/**
+ * Raw Q16 values covering the whole int32_t range, including values which
+ * overflow during the transformation.
+ */
+std::vector<Fixpoint>
+randomRawValues(size_t length)
+{
+    std::vector<Fixpoint> samples(length);
+    for (auto& sample : samples)
+    {
+        sample.setValue(static_cast<int32_t>((static_cast<uint32_t>(rand()) << 16)
+                                             ^ static_cast<uint32_t>(rand())));
+    }
+    return samples;
+}
+
+void
+expectIdenticalForwardTransform(const std::vector<Fixpoint>& input)
+{
+    std::vector<Fixpoint> in = input;
+    std::vector<Fixpoint> out(input.size());
+    std::vector<Fixpoint> referenceIn = input;
+    std::vector<Fixpoint> referenceOut(input.size());
+
+    LeGall53Wavelet::forwardTransform(outpost::asSlice(in), outpost::asSlice(out));
+    legall_reference::forwardTransform(outpost::asSlice(referenceIn),
+                                       outpost::asSlice(referenceOut));
+
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        ASSERT_EQ(referenceOut[i].getValue(), out[i].getValue())
+                << "length " << input.size() << ", index " << i;
+    }
+}
+
+void
+expectIdenticalInPlaceTransform(const std::vector<Fixpoint>& input)
+{
+    std::vector<Fixpoint> data = input;
+    std::vector<Fixpoint> reference = input;
+
+    LeGall53Wavelet::forwardTransformInPlace(outpost::asSlice(data));
+    legall_reference::forwardTransformInPlace(outpost::asSlice(reference));
+
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        ASSERT_EQ(reference[i].getValue(), data[i].getValue())
+                << "length " << input.size() << ", index " << i;
+    }
+}
+
+void
+expectIdenticalContiguousTransform(const std::vector<Fixpoint>& input)
+{
+    std::vector<Fixpoint> data = input;
+    std::vector<Fixpoint> scratch(input.size());
+    std::vector<Fixpoint> reference = input;
+
+    outpost::Slice<int16_t> coefficients = LeGall53Wavelet::forwardTransformContiguous(
+            outpost::asSlice(data), outpost::asSlice(scratch));
+    LeGall53Wavelet::forwardTransformInPlace(outpost::asSlice(reference));
+    outpost::Slice<int16_t> expected = LeGall53Wavelet::reorder(outpost::asSlice(reference));
+
+    ASSERT_EQ(input.size(), coefficients.getNumberOfElements());
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        ASSERT_EQ(expected[i], coefficients[i]) << "length " << input.size() << ", index " << i;
+    }
+}
+}  // namespace
+
+TEST(TransformKernelTest, forwardTransformIsBitIdentical)
+{
+    srand(1);
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+        expectIdenticalForwardTransform(randomSamples(length));
+        expectIdenticalForwardTransform(randomRawValues(length));
+        expectIdenticalForwardTransform(std::vector<Fixpoint>(length, Fixpoint(int16_t(-32768))));
+        expectIdenticalForwardTransform(std::vector<Fixpoint>(length, Fixpoint(int16_t(32767))));
+    }
+}
+
+TEST(TransformKernelTest, inPlaceTransformIsBitIdentical)
+{
+    srand(2);
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+        expectIdenticalInPlaceTransform(randomSamples(length));
+        expectIdenticalInPlaceTransform(randomRawValues(length));
+        expectIdenticalInPlaceTransform(std::vector<Fixpoint>(length, Fixpoint(int16_t(-32768))));
+        expectIdenticalInPlaceTransform(std::vector<Fixpoint>(length, Fixpoint(int16_t(32767))));
+    }
+}
+
+TEST(TransformKernelTest, nonBlocksizeLengthsAreBitIdentical)
+{
+    srand(3);
+    for (size_t length = 8; length <= 64; length *= 2)
+    {
+        expectIdenticalForwardTransform(randomRawValues(length));
+        expectIdenticalInPlaceTransform(randomRawValues(length));
+    }
+    expectIdenticalForwardTransform(randomRawValues(8192));
+    expectIdenticalInPlaceTransform(randomRawValues(8192));
+}
+
+TEST(TransformKernelTest, contiguousTransformMatchesInPlaceAndReorder)
+{
+    srand(4);
+    for (Blocksize bs : blocksizes)
+    {
+        const size_t length = outpost::compression::toUInt(bs);
+        expectIdenticalContiguousTransform(randomSamples(length));
+        expectIdenticalContiguousTransform(randomRawValues(length));
+        expectIdenticalContiguousTransform(
+                std::vector<Fixpoint>(length, Fixpoint(int16_t(-32768))));
+    }
+    for (size_t length = 1; length <= 8; length *= 2)
+    {
+        expectIdenticalContiguousTransform(randomSamples(length));
+    }
+    expectIdenticalContiguousTransform(randomRawValues(8192));
+}
+
+TEST(TransformKernelTest, contiguousTransformRequiresScratchForAllSamples)
+{
+    std::vector<Fixpoint> data = randomSamples(64);
+    std::vector<Fixpoint> scratch(63);
+
+    EXPECT_EQ(0U,
+              LeGall53Wavelet::forwardTransformContiguous(outpost::asSlice(data),
+                                                          outpost::asSlice(scratch))
+                      .getNumberOfElements());
+}
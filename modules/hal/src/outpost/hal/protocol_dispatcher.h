@@ -80,7 +80,8 @@ public:
      *
      * @param[in] id	The id value to listen to
      * @param[in] pool	The pool to allocate memory from, the provided memories shall be large
-     * enough to fit a package of the specific protocol
+     * enough to fit a package of the specific protocol. With a SharedBufferPoolSet the smallest
+     * buffer fitting the package is used.
      * @param[in] queue	The queue to write the values to
      * @param[in] dropPartial   if true only complete packages will be put into the queue
      *
@@ -260,7 +260,11 @@ ProtocolDispatcher<protocolType, numberOfQueues>::insertIntoQueue(
     bool inserted = false;
 
     outpost::utils::SharedBufferPointer sharedBuffer;
-    if (listener.mPool->allocate(sharedBuffer))
+    // Prefer a buffer fitting the complete package, e.g. from a SharedBufferPoolSet.
+    // Larger packages are truncated to the largest available buffer.
+    const size_t requestedSize =
+            outpost::utils::min<size_t>(readBytes, listener.mPool->elementSize());
+    if (listener.mPool->allocate(sharedBuffer, requestedSize))
     {
         uint32_t effectiveSize = outpost::utils::min<uint32_t>(
                 readBytes, sharedBuffer.getLength(), package.getNumberOfElements());
@@ -270,7 +274,7 @@ ProtocolDispatcher<protocolType, numberOfQueues>::insertIntoQueue(
         sharedBuffer.getChild(child, 0, 0, effectiveSize);
         if (!listener.mDropPartial || effectiveSize >= readBytes)
         {
-            inserted = listener.mQueue->send(child);
+            inserted = listener.mQueue->send(std::move(child));
         }
 
         if (inserted)
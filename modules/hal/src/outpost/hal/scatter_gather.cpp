@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "scatter_gather.h"
+
+#include <outpost/rtos/clock.h>
+
+using outpost::time::Duration;
+using outpost::time::SpacecraftElapsedTime;
+
+size_t
+outpost::hal::write(Serial& serial,
+                    const outpost::utils::SharedBufferChainBase& chain,
+                    Duration timeout)
+{
+    const bool limited = (timeout != Duration::maximum()) && (timeout != Duration::infinity())
+                         && (timeout != Duration::zero());
+    outpost::rtos::SystemClock clock;
+    SpacecraftElapsedTime deadline = SpacecraftElapsedTime::startOfEpoch();
+    if (limited)
+    {
+        deadline = clock.now() + timeout;
+    }
+
+    size_t written = 0;
+    for (size_t i = 0; i < chain.getNumberOfSegments(); ++i)
+    {
+        const outpost::Slice<const uint8_t> segment = chain.getSegment(i);
+
+        Duration remaining = timeout;
+        if (limited && (i > 0))
+        {
+            remaining = deadline - clock.now();
+            if (remaining < Duration::zero())
+            {
+                remaining = Duration::zero();
+            }
+        }
+
+        const size_t length = serial.write(segment, remaining);
+        written += length;
+        if (length < segment.getNumberOfElements())
+        {
+            break;
+        }
+    }
+    return written;
+}
+
+outpost::hal::SpaceWire::Result::Type
+outpost::hal::send(SpaceWire& spacewire,
+                   const outpost::utils::SharedBufferChainBase& chain,
+                   Duration timeout)
+{
+    if (chain.getLength() > spacewire.getMaximumPacketLength())
+    {
+        return SpaceWire::Result::failure;
+    }
+
+    SpaceWire::TransmitBuffer* buffer = nullptr;
+    SpaceWire::Result::Type result = spacewire.requestBuffer(buffer, timeout);
+    if (result != SpaceWire::Result::success)
+    {
+        return result;
+    }
+
+    if (chain.copyTo(buffer->getData()) == chain.getLength())
+    {
+        buffer->setLength(chain.getLength());
+        buffer->setEndMarker(SpaceWire::eop);
+    }
+    else
+    {
+        // The buffer has to be returned to the driver in any case, otherwise
+        // the link stays blocked. Discard the truncated packet instead.
+        buffer->setLength(0);
+        buffer->setEndMarker(SpaceWire::eep);
+        result = SpaceWire::Result::failure;
+    }
+
+    const SpaceWire::Result::Type sent = spacewire.send(buffer, timeout);
+    if (result == SpaceWire::Result::success)
+    {
+        result = sent;
+    }
+    return result;
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_HAL_SCATTER_GATHER_H
+#define OUTPOST_HAL_SCATTER_GATHER_H
+
+#include "serial.h"
+#include "spacewire.h"
+
+#include <outpost/time/duration.h>
+#include <outpost/utils/container/shared_buffer_chain.h>
+
+#include <stddef.h>
+
+namespace outpost
+{
+namespace hal
+{
+/**
+ * Write the segments of a chain to a serial interface.
+ *
+ * The segments are passed one after another to Serial::write() without
+ * gathering them in an intermediate buffer.
+ *
+ * \param serial
+ *      Serial interface to write to.
+ * \param chain
+ *      Segments of the message.
+ * \param timeout
+ *      Overall timeout for writing all segments.
+ * \return
+ *      Number of bytes which could be sent, maximal \p chain.getLength().
+ */
+size_t
+write(Serial& serial,
+      const outpost::utils::SharedBufferChainBase& chain,
+      outpost::time::Duration timeout = outpost::time::Duration::maximum());
+
+/**
+ * Send the segments of a chain as a single SpaceWire packet.
+ *
+ * The segments are gathered directly into the transmit buffer of the
+ * driver and terminated with an end of packet marker.
+ *
+ * \param spacewire
+ *      SpaceWire interface to send the packet with.
+ * \param chain
+ *      Segments of the packet.
+ * \param timeout
+ *      Time to wait for a free transmit buffer and again for the
+ *      transmission.
+ * \retval  Result::failure     The packet exceeds the maximum packet length
+ *                              or the transmission failed.
+ */
+SpaceWire::Result::Type
+send(SpaceWire& spacewire,
+     const outpost::utils::SharedBufferChainBase& chain,
+     outpost::time::Duration timeout);
+
+}  // namespace hal
+}  // namespace outpost
+
+#endif
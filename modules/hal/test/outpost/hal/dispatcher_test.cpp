@@ -13,6 +13,7 @@
 
 #include <outpost/base/slice.h>
 #include <outpost/hal/protocol_dispatcher.h>
+#include <outpost/utils/container/shared_buffer_pool_set.h>
 
 #include <unittest/harness.h>
 
@@ -434,3 +435,50 @@ TEST_F(ProtocolDispatcherTest, testCopy)
     EXPECT_ARRAY_EQ(uint8_t, &buffer[0], &data[0], 6);
     EXPECT_EQ(data.getLength(), 6u);
 }
+
+TEST_F(ProtocolDispatcherTest, poolSetSelectsFittingBuffer)
+{
+    const uint8_t ID = 1;
+    outpost::utils::SharedBufferPoolSetStorage<4, 2, 0, 2> pools;
+    outpost::utils::SharedBufferQueue<2> queue;
+    buffer.fill(ID);
+
+    EXPECT_TRUE(dispatcher->addQueue(ID, &pools, &queue));
+
+    dispatcher->handlePackage(outpost::asSlice(buffer), 3);
+    dispatcher->handlePackage(outpost::asSlice(buffer), 8);
+    EXPECT_EQ(0u, dispatcher->getNumberOfDroppedPackages());
+    EXPECT_EQ(0u, dispatcher->getNumberOfPartialPackages());
+
+    EXPECT_EQ(1u, pools.getStatistics(0).numberOfAllocations);
+    EXPECT_EQ(1u, pools.getStatistics(1).numberOfAllocations);
+
+    outpost::utils::SharedBufferPointer p;
+    ASSERT_TRUE(queue.receive(p, outpost::time::Duration::zero()));
+    EXPECT_EQ(3u, p.getLength());
+    ASSERT_TRUE(queue.receive(p, outpost::time::Duration::zero()));
+    EXPECT_EQ(8u, p.getLength());
+}
+
+TEST_F(ProtocolDispatcherTest, poolSetTruncatesOversizedPackage)
+{
+    const uint8_t ID = 1;
+    outpost::utils::SharedBufferPoolSetStorage<4, 2> pools;
+    outpost::utils::SharedBufferQueue<2> queue;
+    buffer.fill(ID);
+
+    EXPECT_TRUE(dispatcher->addQueue(ID, &pools, &queue));
+
+    dispatcher->handlePackage(outpost::asSlice(buffer), 8);
+    EXPECT_EQ(0u, dispatcher->getNumberOfDroppedPackages());
+    EXPECT_EQ(1u, dispatcher->getNumberOfPartialPackages(&queue));
+
+    // The package is larger than all buffers, but this is not counted as
+    // a failed allocation of the pool set.
+    EXPECT_EQ(0u, pools.getNumberOfFailedAllocations());
+    EXPECT_EQ(1u, pools.getStatistics(0).numberOfAllocations);
+
+    outpost::utils::SharedBufferPointer p;
+    ASSERT_TRUE(queue.receive(p, outpost::time::Duration::zero()));
+    EXPECT_EQ(4u, p.getLength());
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/hal/scatter_gather.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <unittest/hal/serial_stub.h>
+#include <unittest/hal/spacewire_stub.h>
+#include <unittest/harness.h>
+
+using ::testing::ElementsAre;
+using outpost::hal::SpaceWire;
+using outpost::time::Duration;
+using outpost::utils::SharedBufferChain;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+
+class ScatterGatherTest : public testing::Test
+{
+public:
+    ScatterGatherTest() : mSpaceWire(8)
+    {
+    }
+
+    virtual void
+    SetUp() override
+    {
+        mSpaceWire.open();
+        mSpaceWire.up(Duration::zero());
+
+        ASSERT_TRUE(mPool.allocate(mHeader));
+        ASSERT_TRUE(mPool.allocate(mPayload));
+        for (size_t i = 0; i < 16; ++i)
+        {
+            mHeader[i] = static_cast<uint8_t>(0xA0 + i);
+            mPayload[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    unittest::hal::SerialStub mSerial;
+    unittest::hal::SpaceWireStub mSpaceWire;
+
+    SharedBufferPool<16, 2> mPool;
+    SharedBufferPointer mHeader;
+    SharedBufferPointer mPayload;
+};
+
+TEST_F(ScatterGatherTest, shouldWriteSegmentsToSerial)
+{
+    SharedBufferChain<2> chain;
+    chain.append(mHeader, 0, 2);
+    chain.append(mPayload, 3, 3);
+
+    EXPECT_EQ(5U, outpost::hal::write(mSerial, chain, outpost::time::Milliseconds(10)));
+    EXPECT_THAT(mSerial.mDataToTransmit, ElementsAre(0xA0, 0xA1, 3, 4, 5));
+
+    EXPECT_EQ(5U, outpost::hal::write(mSerial, chain));
+    EXPECT_EQ(10U, mSerial.mDataToTransmit.size());
+}
+
+TEST_F(ScatterGatherTest, shouldSendChainAsSinglePacket)
+{
+    SharedBufferChain<2> chain;
+    chain.append(mHeader, 0, 3);
+    chain.append(mPayload, 0, 4);
+
+    EXPECT_EQ(SpaceWire::Result::success,
+              outpost::hal::send(mSpaceWire, chain, Duration::zero()));
+
+    ASSERT_EQ(1U, mSpaceWire.mSentPackets.size());
+    auto& packet = mSpaceWire.mSentPackets.front();
+    EXPECT_THAT(packet.data, ElementsAre(0xA0, 0xA1, 0xA2, 0, 1, 2, 3));
+    EXPECT_EQ(SpaceWire::eop, packet.end);
+    EXPECT_TRUE(mSpaceWire.noUsedTransmitBuffers());
+}
+
+TEST_F(ScatterGatherTest, shouldRejectTooLongPackets)
+{
+    SharedBufferChain<2> chain;
+    chain.append(mHeader, 0, 4);
+    chain.append(mPayload, 0, 5);
+
+    EXPECT_EQ(SpaceWire::Result::failure,
+              outpost::hal::send(mSpaceWire, chain, Duration::zero()));
+    EXPECT_TRUE(mSpaceWire.mSentPackets.empty());
+    EXPECT_TRUE(mSpaceWire.noUsedTransmitBuffers());
+}
@@ -26,6 +26,7 @@
 #include "rtos/mutex.h"
 #include "rtos/periodic_task_manager.h"
 #include "rtos/queue.h"
+#include "rtos/queue_set.h"
 #include "rtos/semaphore.h"
 #include "rtos/thread.h"
 #include "rtos/timer.h"
@@ -18,6 +18,7 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/queue.h>
+#include <freertos/task.h>
 
 #include <outpost/rtos/failure_handler.h>
 
@@ -54,4 +55,52 @@ outpost::rtos::Queue<T>::receive(T& data, outpost::time::Duration timeout)
     return xQueueReceive(mHandle, &data, ticks);
 }
 
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::sendBatch(outpost::Slice<const T> data)
+{
+    // FreeRTOS has no native batch operation, but items are stored
+    // without any waiting.
+    size_t itemsStored = 0;
+    while ((itemsStored < data.getNumberOfElements())
+           && xQueueSend(mHandle, &data[itemsStored], 0))
+    {
+        itemsStored++;
+    }
+
+    return itemsStored;
+}
+
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::receiveBatch(outpost::Slice<T> data,
+                                      size_t minItems,
+                                      outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+    const portTickType ticks = (timeout.milliseconds() * configTICK_RATE_HZ) / 1000;
+    const portTickType start = xTaskGetTickCount();
+
+    size_t itemsRetrieved = 0;
+    while (itemsRetrieved < maximumItems)
+    {
+        // Only wait for the required items, take the others if available
+        portTickType remaining = 0;
+        if (itemsRetrieved < requiredItems)
+        {
+            const portTickType elapsed = xTaskGetTickCount() - start;
+            remaining = (elapsed < ticks) ? (ticks - elapsed) : 0;
+        }
+
+        if (!xQueueReceive(mHandle, &data[itemsRetrieved], remaining))
+        {
+            break;
+        }
+        itemsRetrieved++;
+    }
+
+    return itemsRetrieved;
+}
+
 #endif
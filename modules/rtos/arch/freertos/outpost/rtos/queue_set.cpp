@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "queue_set.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include <outpost/rtos/failure_handler.h>
+
+// ----------------------------------------------------------------------------
+outpost::rtos::QueueSet::QueueSet(size_t numberOfEvents) : mNumberOfMembers(0)
+{
+    mHandle = xQueueCreateSet(numberOfEvents);
+    if (mHandle == 0)
+    {
+        FailureHandler::fatal(FailureCode::resourceAllocationFailed(Resource::messageQueue));
+    }
+}
+
+outpost::rtos::QueueSet::~QueueSet()
+{
+    vQueueDelete(mHandle);
+}
+
+bool
+outpost::rtos::QueueSet::wait(size_t& index, outpost::time::Duration timeout)
+{
+    const portTickType ticks = (timeout.milliseconds() * configTICK_RATE_HZ) / 1000;
+    QueueSetMemberHandle_t member = xQueueSelectFromSet(mHandle, ticks);
+    for (size_t i = 0; i < mNumberOfMembers; ++i)
+    {
+        if (mMembers[i] == member)
+        {
+            index = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool
+outpost::rtos::QueueSet::addMember(void* queueHandle)
+{
+    if (mNumberOfMembers >= maximumNumberOfMembers)
+    {
+        return false;
+    }
+
+    if (xQueueAddToSet(queueHandle, mHandle) != pdPASS)
+    {
+        return false;
+    }
+
+    mMembers[mNumberOfMembers] = queueHandle;
+    mNumberOfMembers++;
+    return true;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_RTOS_FREERTOS_QUEUE_SET_H
+#define OUTPOST_RTOS_FREERTOS_QUEUE_SET_H
+
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace outpost
+{
+namespace rtos
+{
+template <typename T>
+class Queue;
+
+/**
+ * Wait for data on several queues.
+ *
+ * Maps to a FreeRTOS queue set, requires \c configUSE_QUEUE_SETS to be
+ * enabled in the FreeRTOS configuration.
+ *
+ * Every item sent to a member queue generates one event. wait() returns
+ * the events in the order the items were sent, so a busy queue can not
+ * starve the other members. For every successful wait() exactly one item
+ * has to be received from the reported queue.
+ *
+ * All queues have to be added while they are empty and before the set is
+ * used.
+ *
+ * \ingroup rtos
+ */
+class QueueSet
+{
+public:
+    static constexpr size_t maximumNumberOfMembers = 16;
+
+    /**
+     * Create a queue set.
+     *
+     * \param numberOfEvents
+     *      Sum of the sizes of all member queues.
+     */
+    explicit QueueSet(size_t numberOfEvents);
+
+    // disable copy constructor
+    QueueSet(const QueueSet& other) = delete;
+
+    // disable assignment operator
+    QueueSet&
+    operator=(const QueueSet& other) = delete;
+
+    ~QueueSet();
+
+    /**
+     * Add a queue to the set.
+     *
+     * A queue can only be member of a single set and has to be empty.
+     *
+     * \return  \c false if the queue could not be added.
+     */
+    template <typename T>
+    inline bool
+    add(Queue<T>& queue)
+    {
+        return addMember(queue.mHandle);
+    }
+
+    /**
+     * Wait until one of the member queues holds data.
+     *
+     * \param index
+     *      Index of the queue in the order it was added to the set.
+     * \param timeout
+     *      Timeout in milliseconds resolution.
+     *
+     * \retval true     \p index refers to a queue which holds data.
+     * \retval false    Timeout occurred, \p index was not changed.
+     */
+    bool
+    wait(size_t& index, outpost::time::Duration timeout);
+
+private:
+    bool
+    addMember(void* queueHandle);
+
+    void* mHandle;
+    void* mMembers[maximumNumberOfMembers];
+    size_t mNumberOfMembers;
+};
+
+}  // namespace rtos
+}  // namespace outpost
+
+#endif
@@ -14,6 +14,7 @@
 #ifndef OUTPOST_RTOS_RTEMS_QUEUE_H
 #define OUTPOST_RTOS_RTEMS_QUEUE_H
 
+#include <outpost/base/slice.h>
 #include <outpost/time/duration.h>
 
 #include <stddef.h>
@@ -91,6 +92,41 @@ public:
     bool
     receive(T& data, outpost::time::Duration timeout);
 
+    /**
+     * Send several items to the queue.
+     *
+     * Stores items from the beginning of \p data until the queue is full.
+     * The items are sent one by one with send().
+     *
+     * \param data
+     *      Items to append to the queue.
+     *
+     * \return Number of items stored in the queue, starting with the first
+     *      element of \p data.
+     */
+    size_t
+    sendBatch(outpost::Slice<const T> data);
+
+    /**
+     * Receive several items from the queue.
+     *
+     * Waits until at least \p minItems items are available (limited to the
+     * size of \p data) or the timeout expires. Afterwards all available
+     * items which fit into \p data are taken from the queue.
+     *
+     * \param data
+     *      Buffer into which the received items are copied.
+     * \param minItems
+     *      Number of items to wait for.
+     * \param timeout
+     *      Timeout in milliseconds resolution.
+     *
+     * \return Number of items received. Less than \p minItems if the
+     *      timeout occurred.
+     */
+    size_t
+    receiveBatch(outpost::Slice<T> data, size_t minItems, outpost::time::Duration timeout);
+
 private:
     size_t
     increment(size_t index) const;
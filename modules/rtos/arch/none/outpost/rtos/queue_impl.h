@@ -68,6 +68,34 @@ outpost::rtos::Queue<T>::receive(T& data, outpost::time::Duration)
     return itemRetrieved;
 }
 
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::sendBatch(outpost::Slice<const T> data)
+{
+    size_t itemsStored = 0;
+    while ((itemsStored < data.getNumberOfElements()) && send(data[itemsStored]))
+    {
+        itemsStored++;
+    }
+
+    return itemsStored;
+}
+
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::receiveBatch(outpost::Slice<T> data, size_t, outpost::time::Duration)
+{
+    // Without an operating system nothing can be waited for
+    size_t itemsRetrieved = 0;
+    while ((itemsRetrieved < data.getNumberOfElements())
+           && receive(data[itemsRetrieved], outpost::time::Duration::zero()))
+    {
+        itemsRetrieved++;
+    }
+
+    return itemsRetrieved;
+}
+
 template <typename T>
 size_t
 outpost::rtos::Queue<T>::increment(size_t index) const
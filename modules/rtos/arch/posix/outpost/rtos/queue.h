@@ -15,8 +15,11 @@
 #ifndef OUTPOST_RTOS_POSIX_QUEUE_H
 #define OUTPOST_RTOS_POSIX_QUEUE_H
 
+#include "queue_set.h"
+
 #include <pthread.h>
 
+#include <outpost/base/slice.h>
 #include <outpost/time/duration.h>
 
 #include <stddef.h>
@@ -96,7 +99,46 @@ public:
     bool
     receive(T& data, outpost::time::Duration timeout);
 
+    /**
+     * Send several items to the queue.
+     *
+     * Stores items from the beginning of \p data until the queue is full.
+     * In contrast to calling send() for every item, waiting receivers are
+     * only notified once.
+     *
+     * \param data
+     *      Items to append to the queue.
+     *
+     * \return Number of items stored in the queue, starting with the first
+     *      element of \p data.
+     */
+    size_t
+    sendBatch(outpost::Slice<const T> data);
+
+    /**
+     * Receive several items from the queue.
+     *
+     * Waits until at least \p minItems items are available (limited to the
+     * size of \p data and the size of the queue) or the timeout expires.
+     * Afterwards all available items which fit into \p data are taken from
+     * the queue.
+     *
+     * \param data
+     *      Buffer into which the received items are copied.
+     * \param minItems
+     *      Number of items to wait for.
+     * \param timeout
+     *      Timeout in milliseconds resolution.
+     *
+     * \return Number of items received. Less than \p minItems if the
+     *      timeout occurred.
+     */
+    size_t
+    receiveBatch(outpost::Slice<T> data, size_t minItems, outpost::time::Duration timeout);
+
 private:
+    friend class QueueSet;
+
     size_t
     increment(size_t index) const;
 
@@ -109,6 +151,13 @@ private:
     size_t mItemsInBuffer;
     size_t mHead;
     size_t mTail;
+
+    // Receivers waiting for more than a single item
+    size_t mBatchWaiters;
+
+    // Set notified about new items, see QueueSet::add()
+    QueueSet* mSet;
+    size_t mSetIndex;
 };
 
 }  // namespace rtos
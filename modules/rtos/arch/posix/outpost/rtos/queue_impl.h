@@ -25,7 +25,10 @@ outpost::rtos::Queue<T>::Queue(size_t numberOfItems) :
     mMaximumSize(numberOfItems),
     mItemsInBuffer(0),
     mHead(0),
-    mTail(0)
+    mTail(0),
+    mBatchWaiters(0),
+    mSet(nullptr),
+    mSetIndex(0)
 {
     pthread_mutex_init(&mMutex, nullptr);
     pthread_cond_init(&mSignal, nullptr);
@@ -62,13 +65,56 @@ outpost::rtos::Queue<T>::send(const T& data)
         mItemsInBuffer++;
         itemStored = true;
 
-        pthread_cond_signal(&mSignal);
+        if (mBatchWaiters > 0)
+        {
+            // A single wakeup might hit a receiver still waiting for more items
+            pthread_cond_broadcast(&mSignal);
+        }
+        else
+        {
+            pthread_cond_signal(&mSignal);
+        }
     }
 
     pthread_mutex_unlock(&mMutex);
+
+    if (itemStored && (mSet != nullptr))
+    {
+        mSet->notify(mSetIndex, 1);
+    }
     return itemStored;
 }
 
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::sendBatch(outpost::Slice<const T> data)
+{
+    pthread_mutex_lock(&mMutex);
+
+    size_t itemsStored = 0;
+    while ((itemsStored < data.getNumberOfElements()) && (mItemsInBuffer < mMaximumSize))
+    {
+        mHead = increment(mHead);
+
+        mBuffer[mHead] = data[itemsStored];
+        mItemsInBuffer++;
+        itemsStored++;
+    }
+
+    if (itemsStored > 0)
+    {
+        pthread_cond_broadcast(&mSignal);
+    }
+
+    pthread_mutex_unlock(&mMutex);
+
+    if ((itemsStored > 0) && (mSet != nullptr))
+    {
+        mSet->notify(mSetIndex, itemsStored);
+    }
+    return itemsStored;
+}
+
 template <typename T>
 bool
 outpost::rtos::Queue<T>::receive(T& data, outpost::time::Duration timeout)
@@ -111,6 +157,69 @@ outpost::rtos::Queue<T>::receive(T& data, outpost::time::Duration timeout)
     return itemRetrieved;
 }
 
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::receiveBatch(outpost::Slice<T> data,
+                                      size_t minItems,
+                                      outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+    if (requiredItems > mMaximumSize)
+    {
+        // More items than the queue can hold would never become available
+        requiredItems = mMaximumSize;
+    }
+
+    pthread_mutex_lock(&mMutex);
+    if (mItemsInBuffer < requiredItems)
+    {
+        const bool batch = (requiredItems > 1);
+        if (batch)
+        {
+            mBatchWaiters++;
+        }
+
+        const bool infinite = (timeout == outpost::time::Duration::infinity());
+        timespec time = {};
+        if (!infinite)
+        {
+            time = toAbsoluteTime(CLOCK_REALTIME, timeout);
+        }
+
+        bool timeoutOrErrorOccured = false;
+        while ((mItemsInBuffer < requiredItems) && !timeoutOrErrorOccured)
+        {
+            if (infinite)
+            {
+                timeoutOrErrorOccured = (pthread_cond_wait(&mSignal, &mMutex) != 0);
+            }
+            else
+            {
+                timeoutOrErrorOccured = (pthread_cond_timedwait(&mSignal, &mMutex, &time) != 0);
+            }
+        }
+
+        if (batch)
+        {
+            mBatchWaiters--;
+        }
+    }
+
+    size_t itemsRetrieved = 0;
+    while ((itemsRetrieved < maximumItems) && (mItemsInBuffer > 0))
+    {
+        mTail = increment(mTail);
+
+        data[itemsRetrieved] = mBuffer[mTail];
+        mItemsInBuffer--;
+        itemsRetrieved++;
+    }
+
+    pthread_mutex_unlock(&mMutex);
+    return itemsRetrieved;
+}
+
 template <typename T>
 size_t
 outpost::rtos::Queue<T>::increment(size_t index) const
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "queue_set.h"
+
+#include "internal/time.h"
+
+using outpost::rtos::QueueSet;
+
+// ----------------------------------------------------------------------------
+QueueSet::QueueSet(size_t numberOfEvents) :
+    mEvents(new size_t[numberOfEvents]),
+    mMaximumNumberOfEvents(numberOfEvents),
+    mNumberOfEvents(0),
+    mHead(0),
+    mTail(0),
+    mNumberOfMembers(0),
+    mCapacity(0)
+{
+    pthread_mutex_init(&mMutex, nullptr);
+    pthread_cond_init(&mSignal, nullptr);
+}
+
+QueueSet::~QueueSet()
+{
+    delete[] mEvents;
+
+    pthread_mutex_destroy(&mMutex);
+    pthread_cond_destroy(&mSignal);
+}
+
+bool
+QueueSet::wait(size_t& index, outpost::time::Duration timeout)
+{
+    bool eventRetrieved = false;
+    bool timeoutOrErrorOccured = false;
+
+    const bool infinite = (timeout == outpost::time::Duration::infinity());
+    timespec time = {};
+    if (!infinite)
+    {
+        time = toAbsoluteTime(CLOCK_REALTIME, timeout);
+    }
+
+    pthread_mutex_lock(&mMutex);
+    while ((mNumberOfEvents == 0) && !timeoutOrErrorOccured)
+    {
+        if (infinite)
+        {
+            timeoutOrErrorOccured = (pthread_cond_wait(&mSignal, &mMutex) != 0);
+        }
+        else
+        {
+            timeoutOrErrorOccured = (pthread_cond_timedwait(&mSignal, &mMutex, &time) != 0);
+        }
+    }
+
+    if (mNumberOfEvents > 0)
+    {
+        index = mEvents[mTail];
+        mTail = increment(mTail);
+        mNumberOfEvents--;
+        eventRetrieved = true;
+    }
+
+    pthread_mutex_unlock(&mMutex);
+    return eventRetrieved;
+}
+
+bool
+QueueSet::addMember(size_t capacity, size_t itemsInQueue, size_t& index)
+{
+    bool success = false;
+    pthread_mutex_lock(&mMutex);
+
+    if ((mNumberOfMembers < maximumNumberOfMembers)
+        && (mCapacity + capacity <= mMaximumNumberOfEvents))
+    {
+        index = mNumberOfMembers;
+        mNumberOfMembers++;
+        mCapacity += capacity;
+        success = true;
+    }
+
+    pthread_mutex_unlock(&mMutex);
+
+    if (success && (itemsInQueue > 0))
+    {
+        notify(index, itemsInQueue);
+    }
+    return success;
+}
+
+void
+QueueSet::notify(size_t index, size_t count)
+{
+    pthread_mutex_lock(&mMutex);
+
+    // Can only overflow if items are received from a member queue
+    // without waiting on the set first. Such events are dropped.
+    for (size_t i = 0; (i < count) && (mNumberOfEvents < mMaximumNumberOfEvents); ++i)
+    {
+        mEvents[mHead] = index;
+        mHead = increment(mHead);
+        mNumberOfEvents++;
+    }
+    if (count > 1)
+    {
+        pthread_cond_broadcast(&mSignal);
+    }
+    else
+    {
+        pthread_cond_signal(&mSignal);
+    }
+
+    pthread_mutex_unlock(&mMutex);
+}
+
+size_t
+QueueSet::increment(size_t index) const
+{
+    if (index >= (mMaximumNumberOfEvents - 1))
+    {
+        index = 0;
+    }
+    else
+    {
+        index++;
+    }
+
+    return index;
+}
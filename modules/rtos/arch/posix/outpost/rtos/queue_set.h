@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_RTOS_POSIX_QUEUE_SET_H
+#define OUTPOST_RTOS_POSIX_QUEUE_SET_H
+
+#include <pthread.h>
+
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace outpost
+{
+namespace rtos
+{
+template <typename T>
+class Queue;
+
+/**
+ * Wait for data on several queues.
+ *
+ * A thread servicing several queues blocks in wait() until any of them
+ * holds data, instead of polling every queue with a short timeout.
+ *
+ * Every item sent to a member queue generates one event. wait() returns
+ * the events in the order the items were sent, so a busy queue can not
+ * starve the other members. For every successful wait() exactly one item
+ * has to be received from the reported queue:
+ *
+ * \code
+ * QueueSet set(commandQueueSize + telemetryQueueSize);
+ * set.add(commandQueue);      // index 0
+ * set.add(telemetryQueue);    // index 1
+ *
+ * size_t index;
+ * if (set.wait(index, timeout))
+ * {
+ *     if (index == 0)
+ *     {
+ *         commandQueue.receive(command, outpost::time::Duration::zero());
+ *     }
+ *     ...
+ * }
+ * \endcode
+ *
+ * All queues have to be added before the set is used.
+ *
+ * \ingroup rtos
+ */
+class QueueSet
+{
+public:
+    static constexpr size_t maximumNumberOfMembers = 16;
+
+    /**
+     * Create a queue set.
+     *
+     * \param numberOfEvents
+     *      Sum of the sizes of all member queues.
+     */
+    explicit QueueSet(size_t numberOfEvents);
+
+    // disable copy constructor
+    QueueSet(const QueueSet& other) = delete;
+
+    // disable assignment operator
+    QueueSet&
+    operator=(const QueueSet& other) = delete;
+
+    ~QueueSet();
+
+    /**
+     * Add a queue to the set.
+     *
+     * A queue can only be member of a single set. Items already stored in
+     * the queue are reported by the next calls to wait().
+     *
+     * \return  \c false if the queue is already member of a set, the set is
+     *          full or the sizes of the members exceed the number of events.
+     */
+    template <typename T>
+    bool
+    add(Queue<T>& queue);
+
+    /**
+     * Wait until one of the member queues holds data.
+     *
+     * \param index
+     *      Index of the queue in the order it was added to the set.
+     * \param timeout
+     *      Timeout in milliseconds resolution.
+     *
+     * \retval true     \p index refers to a queue which holds data.
+     * \retval false    Timeout occurred, \p index was not changed.
+     */
+    bool
+    wait(size_t& index, outpost::time::Duration timeout);
+
+private:
+    template <typename T>
+    friend class Queue;
+
+    bool
+    addMember(size_t capacity, size_t itemsInQueue, size_t& index);
+
+    /**
+     * Called by a member queue after \p count items have been stored.
+     */
+    void
+    notify(size_t index, size_t count);
+
+    size_t
+    increment(size_t index) const;
+
+    // POSIX handles
+    pthread_mutex_t mMutex;
+    pthread_cond_t mSignal;
+
+    size_t* mEvents;
+    const size_t mMaximumNumberOfEvents;
+    size_t mNumberOfEvents;
+    size_t mHead;
+    size_t mTail;
+
+    size_t mNumberOfMembers;
+    size_t mCapacity;
+};
+
+}  // namespace rtos
+}  // namespace outpost
+
+template <typename T>
+bool
+outpost::rtos::QueueSet::add(Queue<T>& queue)
+{
+    if (queue.mSet != nullptr)
+    {
+        return false;
+    }
+
+    pthread_mutex_lock(&queue.mMutex);
+    size_t index;
+    bool success = addMember(queue.mMaximumSize, queue.mItemsInBuffer, index);
+    if (success)
+    {
+        queue.mSet = this;
+        queue.mSetIndex = index;
+    }
+    pthread_mutex_unlock(&queue.mMutex);
+
+    return success;
+}
+
+#endif
@@ -16,6 +16,7 @@
 
 #include <rtems.h>
 
+#include <outpost/base/slice.h>
 #include <outpost/time/duration.h>
 
 #include <stddef.h>
@@ -95,6 +96,42 @@ public:
     bool
     receive(T& data, outpost::time::Duration timeout);
 
+    /**
+     * Send several items to the queue.
+     *
+     * Stores items from the beginning of \p data until the queue is full.
+     * The items are sent one by one with send(), a waiting receiver is
+     * therefore woken up for every item.
+     *
+     * \param data
+     *      Items to append to the queue.
+     *
+     * \return Number of items stored in the queue, starting with the first
+     *      element of \p data.
+     */
+    size_t
+    sendBatch(outpost::Slice<const T> data);
+
+    /**
+     * Receive several items from the queue.
+     *
+     * Waits until at least \p minItems items are available (limited to the
+     * size of \p data) or the timeout expires. Afterwards all available
+     * items which fit into \p data are taken from the queue.
+     *
+     * \param data
+     *      Buffer into which the received items are copied.
+     * \param minItems
+     *      Number of items to wait for.
+     * \param timeout
+     *      Timeout in milliseconds resolution.
+     *
+     * \return Number of items received. Less than \p minItems if the
+     *      timeout occurred.
+     */
+    size_t
+    receiveBatch(outpost::Slice<T> data, size_t minItems, outpost::time::Duration timeout);
+
 private:
     rtems_id mId;
 };
@@ -69,4 +69,62 @@ outpost::rtos::Queue<T>::receive(T& data, outpost::time::Duration timeout)
     return success;
 }
 
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::sendBatch(outpost::Slice<const T> data)
+{
+    size_t itemsStored = 0;
+    while ((itemsStored < data.getNumberOfElements()) && send(data[itemsStored]))
+    {
+        itemsStored++;
+    }
+
+    return itemsStored;
+}
+
+template <typename T>
+size_t
+outpost::rtos::Queue<T>::receiveBatch(outpost::Slice<T> data,
+                                      size_t minItems,
+                                      outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+    const bool infinite = (timeout == outpost::time::Duration::infinity());
+    const rtems_interval interval = rtems::getInterval(timeout);
+    const rtems_interval start = rtems_clock_get_ticks_since_boot();
+
+    size_t itemsRetrieved = 0;
+    while (itemsRetrieved < maximumItems)
+    {
+        // Only wait for the required items, take the others if available
+        rtems_option options = RTEMS_NO_WAIT;
+        rtems_interval remaining = 0;
+        if (itemsRetrieved < requiredItems)
+        {
+            const rtems_interval elapsed = rtems_clock_get_ticks_since_boot() - start;
+            if (infinite)
+            {
+                options = RTEMS_WAIT;
+            }
+            else if (elapsed < interval)
+            {
+                options = RTEMS_WAIT;
+                remaining = interval - elapsed;
+            }
+        }
+
+        size_t size;
+        rtems_status_code result = rtems_message_queue_receive(
+                mId, &data[itemsRetrieved], &size, options, remaining);
+        if (result != RTEMS_SUCCESSFUL)
+        {
+            break;
+        }
+        itemsRetrieved++;
+    }
+
+    return itemsRetrieved;
+}
+
 #endif
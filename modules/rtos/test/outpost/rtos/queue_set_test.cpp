@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/rtos/queue.h>
+#include <outpost/rtos/queue_set.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using outpost::rtos::Queue;
+using outpost::rtos::QueueSet;
+using outpost::time::Duration;
+using outpost::time::Milliseconds;
+
+TEST(QueueSetTest, shouldTimeOutWithoutData)
+{
+    Queue<int> queue(4);
+    QueueSet set(4);
+    ASSERT_TRUE(set.add(queue));
+
+    size_t index = 42;
+    EXPECT_FALSE(set.wait(index, Duration::zero()));
+    EXPECT_FALSE(set.wait(index, Milliseconds(5)));
+    EXPECT_EQ(42U, index);
+}
+
+TEST(QueueSetTest, shouldReportQueueWithData)
+{
+    Queue<int> first(4);
+    Queue<int> second(4);
+    QueueSet set(8);
+    ASSERT_TRUE(set.add(first));
+    ASSERT_TRUE(set.add(second));
+
+    EXPECT_TRUE(second.send(7));
+
+    size_t index;
+    ASSERT_TRUE(set.wait(index, Duration::zero()));
+    EXPECT_EQ(1U, index);
+
+    int value;
+    EXPECT_TRUE(second.receive(value, Duration::zero()));
+    EXPECT_EQ(7, value);
+    EXPECT_FALSE(set.wait(index, Duration::zero()));
+}
+
+TEST(QueueSetTest, shouldReportItemsAlreadyInQueue)
+{
+    Queue<int> queue(4);
+    EXPECT_TRUE(queue.send(1));
+    EXPECT_TRUE(queue.send(2));
+
+    QueueSet set(4);
+    ASSERT_TRUE(set.add(queue));
+
+    size_t index;
+    EXPECT_TRUE(set.wait(index, Duration::zero()));
+    EXPECT_TRUE(set.wait(index, Duration::zero()));
+    EXPECT_FALSE(set.wait(index, Duration::zero()));
+}
+
+TEST(QueueSetTest, shouldRejectInvalidMembers)
+{
+    Queue<int> first(4);
+    Queue<int> second(4);
+    QueueSet set(6);
+    QueueSet other(8);
+
+    ASSERT_TRUE(set.add(first));
+    // Already member of a set
+    EXPECT_FALSE(set.add(first));
+    EXPECT_FALSE(other.add(first));
+    // Not enough events left for the size of the queue
+    EXPECT_FALSE(set.add(second));
+    EXPECT_TRUE(other.add(second));
+}
+
+TEST(QueueSetTest, shouldGenerateOneEventPerItemOfBatch)
+{
+    Queue<int> queue(8);
+    QueueSet set(8);
+    ASSERT_TRUE(set.add(queue));
+
+    const int values[] = {1, 2, 3};
+    EXPECT_EQ(3U, queue.sendBatch(outpost::asSlice(values)));
+
+    size_t index;
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(set.wait(index, Duration::zero()));
+        EXPECT_EQ(0U, index);
+    }
+    EXPECT_FALSE(set.wait(index, Duration::zero()));
+}
+
+TEST(QueueSetTest, shouldNotStarveQuietQueue)
+{
+    Queue<int> busy(32);
+    Queue<int> quiet(4);
+    QueueSet set(36);
+    ASSERT_TRUE(set.add(busy));
+    ASSERT_TRUE(set.add(quiet));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(busy.send(i));
+    }
+    EXPECT_TRUE(quiet.send(100));
+    for (int i = 10; i < 20; ++i)
+    {
+        EXPECT_TRUE(busy.send(i));
+    }
+
+    // Events are reported in the order the items arrived
+    std::vector<int> order;
+    size_t index;
+    while (set.wait(index, Duration::zero()))
+    {
+        int value;
+        Queue<int>& queue = (index == 0) ? busy : quiet;
+        ASSERT_TRUE(queue.receive(value, Duration::zero()));
+        order.push_back(value);
+    }
+
+    ASSERT_EQ(21U, order.size());
+    EXPECT_EQ(100, order[10]);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(i, order[i]);
+        EXPECT_EQ(i + 10, order[i + 11]);
+    }
+}
+
+TEST(QueueSetTest, shouldServeAllQueuesUnderLoad)
+{
+    static constexpr int itemsPerQueue = 2000;
+    Queue<int> first(16);
+    Queue<int> second(16);
+    QueueSet set(32);
+    ASSERT_TRUE(set.add(first));
+    ASSERT_TRUE(set.add(second));
+
+    auto producer = [](Queue<int>& queue) {
+        for (int i = 0; i < itemsPerQueue; ++i)
+        {
+            while (!queue.send(i))
+            {
+                std::this_thread::yield();
+            }
+        }
+    };
+    std::thread firstProducer(producer, std::ref(first));
+    std::thread secondProducer(producer, std::ref(second));
+
+    int received[2] = {0, 0};
+    int errors = 0;
+    size_t index;
+    while ((received[0] + received[1]) < 2 * itemsPerQueue)
+    {
+        if (!set.wait(index, Milliseconds(1000)))
+        {
+            break;
+        }
+
+        int value;
+        Queue<int>& queue = (index == 0) ? first : second;
+        if (!queue.receive(value, Duration::zero()) || (value != received[index]))
+        {
+            errors++;
+        }
+        received[index]++;
+    }
+    firstProducer.join();
+    secondProducer.join();
+
+    EXPECT_EQ(0, errors);
+    EXPECT_EQ(itemsPerQueue, received[0]);
+    EXPECT_EQ(itemsPerQueue, received[1]);
+}
+
+TEST(QueueSetTest, shouldWakeUpWaitingThread)
+{
+    Queue<int> first(4);
+    Queue<int> second(4);
+    QueueSet set(8);
+    ASSERT_TRUE(set.add(first));
+    ASSERT_TRUE(set.add(second));
+
+    std::chrono::steady_clock::time_point sent;
+    std::chrono::steady_clock::time_point woken;
+    size_t index = 0;
+    bool success = false;
+    std::thread waiter([&]() {
+        success = set.wait(index, Duration::infinity());
+        woken = std::chrono::steady_clock::now();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    sent = std::chrono::steady_clock::now();
+    EXPECT_TRUE(second.send(1));
+    waiter.join();
+
+    EXPECT_TRUE(success);
+    EXPECT_EQ(1U, index);
+
+    // Generous bound, the wakeup is usually a matter of microseconds
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(woken - sent);
+    EXPECT_LT(latency.count(), 50);
+}
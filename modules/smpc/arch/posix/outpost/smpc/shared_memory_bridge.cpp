@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "shared_memory_bridge.h"
+
+#include <outpost/rtos/mutex_guard.h>
+
+using namespace outpost::smpc;
+
+SharedMemoryExport::SharedMemoryExport(SharedMemoryChannel& channel,
+                                       TopicRaw& topic,
+                                       uint32_t id,
+                                       time::Duration timeout) :
+    mChannel(channel),
+    mId(id),
+    mTimeout(timeout),
+    mDroppedMessages(0),
+    mSubscription(topic, this, &SharedMemoryExport::onMessage)
+{
+}
+
+void
+SharedMemoryExport::onMessage(const void* message, size_t length)
+{
+    if (!mChannel.send(mId, message, length, mTimeout))
+    {
+        mDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// ----------------------------------------------------------------------------
+SharedMemoryImport::SharedMemoryImport(SharedMemoryReceiver& receiver,
+                                       TopicRaw& topic,
+                                       uint32_t id) :
+    mReceiver(receiver),
+    mTopic(topic),
+    mId(id),
+    mNextImport(nullptr)
+{
+    mReceiver.add(this);
+}
+
+SharedMemoryImport::~SharedMemoryImport()
+{
+    mReceiver.remove(this);
+}
+
+// ----------------------------------------------------------------------------
+SharedMemoryReceiver::SharedMemoryReceiver(SharedMemoryChannel& channel,
+                                           uint8_t priority,
+                                           size_t stack,
+                                           const char* name) :
+    rtos::Thread(priority, stack, name),
+    mChannel(channel),
+    mMutex(),
+    mImports(nullptr),
+    mUnknownMessages(0)
+{
+}
+
+SharedMemoryReceiver::~SharedMemoryReceiver()
+{
+}
+
+size_t
+SharedMemoryReceiver::dispatch(time::Duration timeout)
+{
+    return mChannel.receive(*this, timeout);
+}
+
+void
+SharedMemoryReceiver::run()
+{
+    while (1)
+    {
+        dispatch(time::Duration::infinity());
+    }
+}
+
+void
+SharedMemoryReceiver::onMessage(uint32_t id, const void* message, size_t length)
+{
+    rtos::MutexGuard lock(mMutex);
+
+    bool found = false;
+    for (SharedMemoryImport* it = mImports; it != nullptr; it = it->mNextImport)
+    {
+        if (it->mId == id)
+        {
+            it->mTopic.publish(message, length);
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        mUnknownMessages++;
+    }
+}
+
+void
+SharedMemoryReceiver::add(SharedMemoryImport* import)
+{
+    rtos::MutexGuard lock(mMutex);
+
+    import->mNextImport = mImports;
+    mImports = import;
+}
+
+void
+SharedMemoryReceiver::remove(SharedMemoryImport* import)
+{
+    rtos::MutexGuard lock(mMutex);
+
+    SharedMemoryImport** it = &mImports;
+    while (*it != nullptr)
+    {
+        if (*it == import)
+        {
+            *it = import->mNextImport;
+            break;
+        }
+        it = &((*it)->mNextImport);
+    }
+    import->mNextImport = nullptr;
+}
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_SHARED_MEMORY_BRIDGE_H
+#define OUTPOST_SMPC_SHARED_MEMORY_BRIDGE_H
+
+#include "shared_memory_channel.h"
+
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/thread.h>
+#include <outpost/smpc/subscriber.h>
+#include <outpost/smpc/subscription_raw.h>
+#include <outpost/smpc/topic_raw.h>
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace smpc
+{
+class SharedMemoryReceiver;
+
+/**
+ * Mirror a raw topic into a shared memory channel.
+ *
+ * Every message published on the topic is copied into the channel
+ * with the given identifier. The subscription is connected together
+ * with all other raw subscriptions by
+ * SubscriptionRaw::connectSubscriptionsToTopics().
+ *
+ * Example for the sending process:
+ * \code
+ * SharedMemoryChannel channel;
+ * channel.create("/payload", 65536);
+ * SharedMemoryExport housekeeping(channel, housekeepingTopic, 1);
+ * SubscriptionRaw::connectSubscriptionsToTopics();
+ * \endcode
+ *
+ * \warning
+ *      Do not export a topic which is imported from the same channel
+ *      pair, the messages would be sent back and forth endlessly.
+ *
+ * \ingroup smpc
+ * \see     SharedMemoryImport
+ */
+class SharedMemoryExport : public Subscriber
+{
+public:
+    /**
+     * \param channel
+     *      Opened channel of the sending process.
+     * \param topic
+     *      Topic to mirror.
+     * \param id
+     *      Identifier used by SharedMemoryImport in the receiving
+     *      process.
+     * \param timeout
+     *      Time a publisher waits for free space in the channel
+     *      before the message is dropped. By default messages are
+     *      dropped immediately if the channel is full.
+     */
+    SharedMemoryExport(SharedMemoryChannel& channel,
+                       TopicRaw& topic,
+                       uint32_t id,
+                       time::Duration timeout = time::Duration::zero());
+
+    ~SharedMemoryExport() = default;
+
+    // Disable copy constructor
+    SharedMemoryExport(const SharedMemoryExport&) = delete;
+
+    // Disable copy assignment operator
+    SharedMemoryExport&
+    operator=(const SharedMemoryExport&) = delete;
+
+    /**
+     * Number of messages which could not be written into the channel.
+     */
+    inline uint32_t
+    getNumberOfDroppedMessages() const
+    {
+        return mDroppedMessages.load(std::memory_order_relaxed);
+    }
+
+private:
+    void
+    onMessage(const void* message, size_t length);
+
+    SharedMemoryChannel& mChannel;
+    const uint32_t mId;
+    const time::Duration mTimeout;
+    std::atomic<uint32_t> mDroppedMessages;
+    SubscriptionRaw mSubscription;
+};
+
+/**
+ * Republish the messages of a shared memory channel on a local topic.
+ *
+ * Example for the receiving process:
+ * \code
+ * SharedMemoryChannel channel;
+ * while (!channel.open("/payload"))
+ * {
+ *     ...
+ * }
+ * SharedMemoryReceiver receiver(channel, priority);
+ * SharedMemoryImport housekeeping(receiver, housekeepingTopic, 1);
+ * receiver.start();
+ * \endcode
+ *
+ * \ingroup smpc
+ * \see     SharedMemoryExport
+ * \see     SharedMemoryReceiver
+ */
+class SharedMemoryImport
+{
+public:
+    SharedMemoryImport(SharedMemoryReceiver& receiver, TopicRaw& topic, uint32_t id);
+
+    /**
+     * Remove the import from its receiver.
+     *
+     * Blocks while the receiver is publishing a message.
+     */
+    ~SharedMemoryImport();
+
+    // Disable copy constructor
+    SharedMemoryImport(const SharedMemoryImport&) = delete;
+
+    // Disable copy assignment operator
+    SharedMemoryImport&
+    operator=(const SharedMemoryImport&) = delete;
+
+private:
+    friend class SharedMemoryReceiver;
+
+    SharedMemoryReceiver& mReceiver;
+    TopicRaw& mTopic;
+    const uint32_t mId;
+    SharedMemoryImport* mNextImport;
+};
+
+/**
+ * Worker which reads a shared memory channel and publishes the
+ * messages on the local topics registered by SharedMemoryImport.
+ *
+ * The subscriber functions of the local topics are executed by this
+ * thread and receive the payload directly from the shared memory.
+ *
+ * \ingroup smpc
+ * \see     SharedMemoryImport
+ */
+class SharedMemoryReceiver : public rtos::Thread, private SharedMemoryChannel::Handler
+{
+public:
+    /**
+     * Create a receiver.
+     *
+     * The thread has to be started with start() before any message
+     * is forwarded. Alternatively dispatch() can be called from an
+     * existing thread.
+     */
+    explicit SharedMemoryReceiver(SharedMemoryChannel& channel,
+                                  uint8_t priority,
+                                  size_t stack = defaultStackSize,
+                                  const char* name = "smpcShm");
+
+    virtual ~SharedMemoryReceiver();
+
+    /**
+     * Wait for messages and publish them.
+     *
+     * \return  Number of received messages, zero on timeout.
+     */
+    size_t
+    dispatch(time::Duration timeout);
+
+    /**
+     * Number of received messages without a matching import.
+     */
+    inline uint32_t
+    getNumberOfUnknownMessages() const
+    {
+        return mUnknownMessages;
+    }
+
+protected:
+    virtual void
+    run() override;
+
+private:
+    friend class SharedMemoryImport;
+
+    virtual void
+    onMessage(uint32_t id, const void* message, size_t length) override;
+
+    void
+    add(SharedMemoryImport* import);
+
+    void
+    remove(SharedMemoryImport* import);
+
+    SharedMemoryChannel& mChannel;
+
+    /// Protects the list of imports.
+    rtos::Mutex mMutex;
+
+    SharedMemoryImport* mImports;
+    uint32_t mUnknownMessages;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "shared_memory_channel.h"
+
+#include <outpost/rtos/internal/time.h>
+#include <outpost/rtos/mutex_guard.h>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <atomic>
+
+using namespace outpost::smpc;
+
+constexpr uint32_t SharedMemoryChannel::invalidId;
+constexpr size_t SharedMemoryChannel::minimumCapacity;
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "Atomics in shared memory must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "Futex word must be a plain 32 bit integer");
+
+/**
+ * Control block at the beginning of the shared memory.
+ *
+ * Positions are free running byte counters, the offset in the ring
+ * buffer is the lower part of the counter. Sender and receiver owned
+ * fields are placed in separate cache lines.
+ */
+struct SharedMemoryChannel::Header
+{
+    static constexpr uint32_t magic = 0x534D5043;  // "SMPC"
+
+    std::atomic<uint32_t> mMagic;
+    uint32_t mCapacity;
+
+    /// Written by the sender.
+    alignas(64) std::atomic<uint64_t> mHead;
+    std::atomic<uint32_t> mDataSequence;
+    std::atomic<uint32_t> mReceiverWaiting;
+    std::atomic<uint32_t> mDroppedMessages;
+
+    /// Written by the receiver.
+    alignas(64) std::atomic<uint64_t> mTail;
+    std::atomic<uint32_t> mSpaceSequence;
+    std::atomic<uint32_t> mSenderWaiting;
+};
+
+constexpr uint32_t SharedMemoryChannel::Header::magic;
+
+struct SharedMemoryChannel::RecordHeader
+{
+    uint32_t mId;
+    uint32_t mLength;
+};
+
+namespace
+{
+/// Size of the control block, keeps the ring buffer cache line aligned.
+constexpr size_t headerSize = 192;
+
+/// Records are padded to this size to keep the record headers aligned.
+constexpr size_t recordAlignment = 8;
+
+outpost::time::Duration
+now()
+{
+    timespec time = outpost::rtos::getTime(CLOCK_MONOTONIC);
+    return outpost::time::Seconds(time.tv_sec) + outpost::time::Microseconds(time.tv_nsec / 1000);
+}
+
+void
+futexWait(std::atomic<uint32_t>& word, uint32_t expected, outpost::time::Duration timeout)
+{
+    if (timeout == outpost::time::Duration::infinity())
+    {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, nullptr,
+                nullptr, 0);
+    }
+    else
+    {
+        timespec relative = outpost::rtos::toRelativeTime(timeout);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &relative,
+                nullptr, 0);
+    }
+}
+
+void
+futexWake(std::atomic<uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+/**
+ * Remaining time until the deadline, zero if the deadline has passed.
+ */
+outpost::time::Duration
+getRemainingTime(outpost::time::Duration start, outpost::time::Duration timeout)
+{
+    if (timeout == outpost::time::Duration::infinity())
+    {
+        return timeout;
+    }
+
+    outpost::time::Duration elapsed = now() - start;
+    if (elapsed >= timeout)
+    {
+        return outpost::time::Duration::zero();
+    }
+    return timeout - elapsed;
+}
+}  // namespace
+
+SharedMemoryChannel::SharedMemoryChannel() :
+    mSendMutex(),
+    mHeader(nullptr),
+    mData(nullptr),
+    mMappedSize(0),
+    mMask(0),
+    mCreatedName(nullptr)
+{
+}
+
+SharedMemoryChannel::~SharedMemoryChannel()
+{
+    close();
+}
+
+bool
+SharedMemoryChannel::create(const char* name, size_t capacity)
+{
+    static_assert(sizeof(Header) <= headerSize, "Header does not fit into the reserved space");
+
+    if (isOpen() || (capacity < minimumCapacity) || ((capacity & (capacity - 1)) != 0)
+        || (capacity > UINT32_MAX))
+    {
+        return false;
+    }
+
+    int fileDescriptor = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    const size_t size = headerSize + capacity;
+    if ((ftruncate(fileDescriptor, static_cast<off_t>(size)) != 0) || !map(fileDescriptor, size))
+    {
+        ::close(fileDescriptor);
+        shm_unlink(name);
+        return false;
+    }
+    ::close(fileDescriptor);
+
+    mHeader->mCapacity = static_cast<uint32_t>(capacity);
+    mHeader->mHead.store(0);
+    mHeader->mDataSequence.store(0);
+    mHeader->mReceiverWaiting.store(0);
+    mHeader->mDroppedMessages.store(0);
+    mHeader->mTail.store(0);
+    mHeader->mSpaceSequence.store(0);
+    mHeader->mSenderWaiting.store(0);
+    mMask = capacity - 1;
+    mCreatedName = name;
+
+    // Opening processes only use the channel after the magic is visible
+    mHeader->mMagic.store(Header::magic, std::memory_order_release);
+    return true;
+}
+
+bool
+SharedMemoryChannel::open(const char* name)
+{
+    if (isOpen())
+    {
+        return false;
+    }
+
+    int fileDescriptor = shm_open(name, O_RDWR, 0);
+    if (fileDescriptor < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if ((fstat(fileDescriptor, &status) != 0) || (status.st_size < static_cast<off_t>(headerSize))
+        || !map(fileDescriptor, static_cast<size_t>(status.st_size)))
+    {
+        ::close(fileDescriptor);
+        return false;
+    }
+    ::close(fileDescriptor);
+
+    if ((mHeader->mMagic.load(std::memory_order_acquire) != Header::magic)
+        || ((headerSize + mHeader->mCapacity) != mMappedSize))
+    {
+        // Not yet initialized by the creating process
+        close();
+        return false;
+    }
+
+    mMask = mHeader->mCapacity - 1;
+    return true;
+}
+
+void
+SharedMemoryChannel::close()
+{
+    if (mHeader != nullptr)
+    {
+        munmap(mHeader, mMappedSize);
+        mHeader = nullptr;
+        mData = nullptr;
+        mMappedSize = 0;
+        mMask = 0;
+    }
+
+    if (mCreatedName != nullptr)
+    {
+        shm_unlink(mCreatedName);
+        mCreatedName = nullptr;
+    }
+}
+
+void
+SharedMemoryChannel::remove(const char* name)
+{
+    shm_unlink(name);
+}
+
+size_t
+SharedMemoryChannel::getMaximumMessageLength() const
+{
+    if (mHeader == nullptr)
+    {
+        return 0;
+    }
+
+    // Half of the ring buffer, this guarantees that a record fits
+    // even if the end of the ring buffer has to be skipped.
+    return (mHeader->mCapacity / 2) - sizeof(RecordHeader);
+}
+
+bool
+SharedMemoryChannel::send(uint32_t id, const void* message, size_t length, time::Duration timeout)
+{
+    if ((mHeader == nullptr) || (id == invalidId) || (length > getMaximumMessageLength()))
+    {
+        return false;
+    }
+
+    rtos::MutexGuard lock(mSendMutex);
+
+    const uint64_t capacity = mHeader->mCapacity;
+    const uint64_t recordSize = getRecordSize(length);
+    uint64_t head = mHeader->mHead.load(std::memory_order_relaxed);
+
+    // Records are never split, the remaining part of the ring buffer is
+    // skipped instead.
+    const uint64_t offset = head & mMask;
+    const uint64_t padding = ((offset + recordSize) > capacity) ? (capacity - offset) : 0;
+
+    if (!waitForSpace(head + padding + recordSize, timeout))
+    {
+        mHeader->mDroppedMessages.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (padding > 0)
+    {
+        RecordHeader* record = getRecord(head);
+        record->mId = invalidId;
+        record->mLength = static_cast<uint32_t>(padding - sizeof(RecordHeader));
+        head += padding;
+    }
+
+    RecordHeader* record = getRecord(head);
+    record->mId = id;
+    record->mLength = static_cast<uint32_t>(length);
+    memcpy(record + 1, message, length);
+
+    mHeader->mHead.store(head + recordSize);
+
+    // Only enter the kernel if the receiver is actually sleeping
+    if (mHeader->mReceiverWaiting.exchange(0) != 0)
+    {
+        mHeader->mDataSequence.fetch_add(1);
+        futexWake(mHeader->mDataSequence);
+    }
+    return true;
+}
+
+size_t
+SharedMemoryChannel::receive(Handler& handler, time::Duration timeout)
+{
+    if (mHeader == nullptr)
+    {
+        return 0;
+    }
+
+    uint64_t tail = mHeader->mTail.load(std::memory_order_relaxed);
+    if (!waitForData(tail, timeout))
+    {
+        return 0;
+    }
+
+    size_t numberOfMessages = 0;
+    const uint64_t head = mHeader->mHead.load(std::memory_order_acquire);
+    while (tail != head)
+    {
+        const RecordHeader* record = getRecord(tail);
+        if (record->mId != invalidId)
+        {
+            handler.onMessage(record->mId, record + 1, record->mLength);
+            numberOfMessages++;
+        }
+        tail += getRecordSize(record->mLength);
+
+        // Release the space after the handler has finished using the payload
+        mHeader->mTail.store(tail);
+        if (mHeader->mSenderWaiting.exchange(0) != 0)
+        {
+            mHeader->mSpaceSequence.fetch_add(1);
+            futexWake(mHeader->mSpaceSequence);
+        }
+    }
+    return numberOfMessages;
+}
+
+uint32_t
+SharedMemoryChannel::getNumberOfDroppedMessages() const
+{
+    if (mHeader == nullptr)
+    {
+        return 0;
+    }
+    return mHeader->mDroppedMessages.load(std::memory_order_relaxed);
+}
+
+size_t
+SharedMemoryChannel::getRecordSize(size_t length)
+{
+    return (sizeof(RecordHeader) + length + (recordAlignment - 1)) & ~(recordAlignment - 1);
+}
+
+bool
+SharedMemoryChannel::map(int fileDescriptor, size_t size)
+{
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    if (memory == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // The memory of a new shared memory object is zero initialized,
+    // which is a valid state for the atomic types.
+    mHeader = reinterpret_cast<Header*>(memory);
+    mData = reinterpret_cast<uint8_t*>(memory) + headerSize;
+    mMappedSize = size;
+    return true;
+}
+
+SharedMemoryChannel::RecordHeader*
+SharedMemoryChannel::getRecord(uint64_t position) const
+{
+    return reinterpret_cast<RecordHeader*>(mData + (position & mMask));
+}
+
+bool
+SharedMemoryChannel::waitForSpace(uint64_t end, time::Duration timeout)
+{
+    const uint64_t capacity = mHeader->mCapacity;
+    const time::Duration start = (timeout > time::Duration::zero()) ? now() : time::Duration::zero();
+    while ((end - mHeader->mTail.load(std::memory_order_acquire)) > capacity)
+    {
+        time::Duration remaining = getRemainingTime(start, timeout);
+        if (remaining == time::Duration::zero())
+        {
+            mHeader->mSenderWaiting.store(0);
+            return false;
+        }
+
+        // Announce the waiting sender before checking again, either the
+        // receiver sees the flag or this check sees the new position.
+        mHeader->mSenderWaiting.store(1);
+        const uint32_t sequence = mHeader->mSpaceSequence.load();
+        if ((end - mHeader->mTail.load()) <= capacity)
+        {
+            break;
+        }
+        futexWait(mHeader->mSpaceSequence, sequence, remaining);
+    }
+    mHeader->mSenderWaiting.store(0);
+    return true;
+}
+
+bool
+SharedMemoryChannel::waitForData(uint64_t tail, time::Duration timeout)
+{
+    const time::Duration start = (timeout > time::Duration::zero()) ? now() : time::Duration::zero();
+    while (mHeader->mHead.load(std::memory_order_acquire) == tail)
+    {
+        time::Duration remaining = getRemainingTime(start, timeout);
+        if (remaining == time::Duration::zero())
+        {
+            mHeader->mReceiverWaiting.store(0);
+            return false;
+        }
+
+        mHeader->mReceiverWaiting.store(1);
+        const uint32_t sequence = mHeader->mDataSequence.load();
+        if (mHeader->mHead.load() != tail)
+        {
+            break;
+        }
+        futexWait(mHeader->mDataSequence, sequence, remaining);
+    }
+
+    // Avoid a superfluous wake-up system call by the sender
+    mHeader->mReceiverWaiting.store(0);
+    return true;
+}
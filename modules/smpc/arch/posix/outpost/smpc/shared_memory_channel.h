@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_SHARED_MEMORY_CHANNEL_H
+#define OUTPOST_SMPC_SHARED_MEMORY_CHANNEL_H
+
+#include <outpost/rtos/mutex.h>
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Message ring buffer in POSIX shared memory.
+ *
+ * Transports messages consisting of an identifier and a variable
+ * length payload from one process to another. One process creates
+ * the channel, the other one opens it by its name. Each channel has
+ * exactly one sending and one receiving process, use two channels
+ * for a bidirectional connection. Multiple threads of the sending
+ * process may send concurrently, only one thread of the receiving
+ * process may receive.
+ *
+ * Sender and receiver only synchronize through atomic read and write
+ * positions. A futex is used to wake up a receiver waiting for data
+ * or a sender waiting for free space. The futex system call is only
+ * issued if the other side is actually waiting, the uncontended path
+ * does not need any system call.
+ *
+ * The payload is handed to the receiver directly from the shared
+ * memory without an intermediate copy.
+ *
+ * \ingroup smpc
+ * \see     SharedMemoryReceiver
+ */
+class SharedMemoryChannel
+{
+public:
+    /**
+     * Receives the messages of a channel.
+     */
+    class Handler
+    {
+    public:
+        virtual ~Handler() = default;
+
+        /**
+         * Called for every received message.
+         *
+         * \param id
+         *      Identifier given to SharedMemoryChannel::send().
+         * \param message
+         *      Payload in the shared memory. Only valid until the
+         *      function returns.
+         * \param length
+         *      Length of the payload in bytes.
+         */
+        virtual void
+        onMessage(uint32_t id, const void* message, size_t length) = 0;
+    };
+
+    /// Reserved identifier, used internally to skip the end of the ring.
+    static constexpr uint32_t invalidId = 0xFFFFFFFF;
+
+    /// Smallest capacity accepted by create().
+    static constexpr size_t minimumCapacity = 64;
+
+    SharedMemoryChannel();
+
+    /**
+     * Close the channel.
+     *
+     * \see close()
+     */
+    ~SharedMemoryChannel();
+
+    // Disable copy constructor
+    SharedMemoryChannel(const SharedMemoryChannel&) = delete;
+
+    // Disable copy assignment operator
+    SharedMemoryChannel&
+    operator=(const SharedMemoryChannel&) = delete;
+
+    /**
+     * Create a new shared memory object for the channel.
+     *
+     * \param name
+     *      Name of the shared memory object, must start with a '/'.
+     *      The string is not copied and must outlive the channel.
+     * \param capacity
+     *      Size of the ring buffer in bytes. Must be a power of two
+     *      and at least minimumCapacity.
+     *
+     * \retval true     Channel was created and is ready to use.
+     * \retval false    Invalid parameters, a shared memory object
+     *                  with this name already exists, or the
+     *                  operating system refused the request.
+     */
+    bool
+    create(const char* name, size_t capacity);
+
+    /**
+     * Open a channel created by another process.
+     *
+     * \retval false    The channel does not exist or is not yet
+     *                  completely initialized. The call may be
+     *                  repeated later.
+     */
+    bool
+    open(const char* name);
+
+    /**
+     * Unmap the shared memory.
+     *
+     * The process which has created the channel also removes the
+     * name of the shared memory object. A process which has already
+     * opened the channel can continue to use it.
+     */
+    void
+    close();
+
+    /**
+     * Remove a shared memory object left over by a terminated process.
+     */
+    static void
+    remove(const char* name);
+
+    inline bool
+    isOpen() const
+    {
+        return (mHeader != nullptr);
+    }
+
+    /**
+     * Largest payload which can be sent through this channel.
+     */
+    size_t
+    getMaximumMessageLength() const;
+
+    /**
+     * Copy a message into the channel.
+     *
+     * \param id
+     *      Identifier of the message, must not be invalidId.
+     * \param message
+     *      Payload.
+     * \param length
+     *      Length of the payload in bytes.
+     * \param timeout
+     *      Time to wait for free space if the receiver falls behind.
+     *      With a timeout of zero the function never blocks.
+     *
+     * \retval true     Message was written.
+     * \retval false    Channel is closed, the message is too long or
+     *                  no space became available within the timeout.
+     *                  Messages dropped because of missing space are
+     *                  counted.
+     */
+    bool
+    send(uint32_t id, const void* message, size_t length, time::Duration timeout);
+
+    /**
+     * Wait for messages and forward them to the handler.
+     *
+     * Forwards all messages available after the first one has
+     * arrived, but does not wait for further messages.
+     *
+     * \return  Number of forwarded messages, zero on timeout.
+     */
+    size_t
+    receive(Handler& handler, time::Duration timeout);
+
+    /**
+     * Number of messages the sending process had to drop because the
+     * ring buffer was full.
+     */
+    uint32_t
+    getNumberOfDroppedMessages() const;
+
+private:
+    struct Header;
+    struct RecordHeader;
+
+    static size_t
+    getRecordSize(size_t length);
+
+    bool
+    map(int fileDescriptor, size_t size);
+
+    RecordHeader*
+    getRecord(uint64_t position) const;
+
+    bool
+    waitForSpace(uint64_t end, time::Duration timeout);
+
+    bool
+    waitForData(uint64_t tail, time::Duration timeout);
+
+    /// Serializes multiple senders within this process.
+    rtos::Mutex mSendMutex;
+
+    Header* mHeader;
+    uint8_t* mData;
+    size_t mMappedSize;
+    uint64_t mMask;
+
+    /// Name of the shared memory object if created by this process.
+    const char* mCreatedName;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
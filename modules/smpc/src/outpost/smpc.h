@@ -21,6 +21,14 @@
  *
  */
 
+#include "smpc/async_dispatcher.h"
+#include "smpc/async_subscription.h"
+#include "smpc/deadline_monitor.h"
+#include "smpc/keyed_topic.h"
+#include "smpc/latched_topic.h"
+#include "smpc/message_filter.h"
+#include "smpc/shared_buffer_topic.h"
+#include "smpc/statistics_registry.h"
 #include "smpc/subscriber.h"
 #include "smpc/subscription.h"
 #include "smpc/subscription_raw.h"
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "async_dispatcher.h"
+
+#include <outpost/rtos/mutex_guard.h>
+
+using namespace outpost::smpc;
+
+AsyncSubscriptionBase::AsyncSubscriptionBase(AsyncDispatcher& dispatcher) :
+    mDispatcher(dispatcher),
+    mNextAsyncSubscription(nullptr)
+{
+    mDispatcher.add(this);
+}
+
+AsyncSubscriptionBase::~AsyncSubscriptionBase()
+{
+    mDispatcher.remove(this);
+}
+
+void
+AsyncSubscriptionBase::detach()
+{
+    mDispatcher.remove(this);
+}
+
+void
+AsyncSubscriptionBase::notifyDispatcher()
+{
+    mDispatcher.mPendingMessages.release();
+}
+
+AsyncDispatcher::AsyncDispatcher(uint8_t priority, size_t stack, const char* name) :
+    rtos::Thread(priority, stack, name),
+    mMutex(),
+    mPendingMessages(0),
+    mDispatchFinished(0),
+    mSubscriptions(nullptr),
+    mNumberOfSubscriptions(0),
+    mNext(nullptr),
+    mActive(nullptr),
+    mWaitingRemovals(0)
+{
+}
+
+AsyncDispatcher::~AsyncDispatcher()
+{
+}
+
+bool
+AsyncDispatcher::dispatchSingle(time::Duration timeout)
+{
+    if (!mPendingMessages.acquire(timeout))
+    {
+        return false;
+    }
+
+    // The semaphore might count messages of subscriptions which have been
+    // destroyed in the meantime, therefore the search may fail.
+    bool delivered = false;
+    mMutex.acquire();
+    for (size_t i = 0; (i < mNumberOfSubscriptions) && !delivered; ++i)
+    {
+        AsyncSubscriptionBase* it = (mNext != nullptr) ? mNext : mSubscriptions;
+        mNext = it->mNextAsyncSubscription;
+
+        // Execute the subscriber function without holding the lock, so that
+        // a slow subscriber does not block publishers and other subscriptions.
+        // remove() waits until the subscription is no longer active.
+        mActive = it;
+        mMutex.release();
+
+        delivered = it->dispatch();
+
+        mMutex.acquire();
+        mActive = nullptr;
+        for (; mWaitingRemovals > 0; --mWaitingRemovals)
+        {
+            mDispatchFinished.release();
+        }
+    }
+    mMutex.release();
+
+    return delivered;
+}
+
+void
+AsyncDispatcher::run()
+{
+    while (1)
+    {
+        dispatchSingle(time::Duration::infinity());
+    }
+}
+
+void
+AsyncDispatcher::add(AsyncSubscriptionBase* subscription)
+{
+    rtos::MutexGuard lock(mMutex);
+
+    subscription->mNextAsyncSubscription = mSubscriptions;
+    mSubscriptions = subscription;
+    mNumberOfSubscriptions++;
+}
+
+void
+AsyncDispatcher::remove(AsyncSubscriptionBase* subscription)
+{
+    mMutex.acquire();
+
+    AsyncSubscriptionBase** it = &mSubscriptions;
+    while (*it != nullptr)
+    {
+        if (*it == subscription)
+        {
+            *it = subscription->mNextAsyncSubscription;
+            mNumberOfSubscriptions--;
+            break;
+        }
+        it = &((*it)->mNextAsyncSubscription);
+    }
+
+    if (mNext == subscription)
+    {
+        mNext = subscription->mNextAsyncSubscription;
+    }
+
+    while (mActive == subscription)
+    {
+        mWaitingRemovals++;
+        mMutex.release();
+        mDispatchFinished.acquire();
+        mMutex.acquire();
+    }
+    subscription->mNextAsyncSubscription = nullptr;
+
+    mMutex.release();
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_ASYNC_DISPATCHER_H
+#define OUTPOST_SMPC_ASYNC_DISPATCHER_H
+
+#include "subscriber.h"
+
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/semaphore.h>
+#include <outpost/rtos/thread.h>
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace outpost
+{
+namespace smpc
+{
+class AsyncDispatcher;
+
+/**
+ * Non-template base class for %AsyncSubscription<>.
+ *
+ * Allows the AsyncDispatcher to drain the queues of subscriptions
+ * with different message types.
+ *
+ * \see     AsyncSubscription
+ * \ingroup smpc
+ */
+class AsyncSubscriptionBase : public Subscriber
+{
+public:
+    explicit AsyncSubscriptionBase(AsyncDispatcher& dispatcher);
+
+    /**
+     * Remove the subscription from its dispatcher, if not already done
+     * by detach().
+     */
+    virtual ~AsyncSubscriptionBase();
+
+    // Disable copy constructor
+    AsyncSubscriptionBase(const AsyncSubscriptionBase&) = delete;
+
+    // Disable copy assignment operator
+    AsyncSubscriptionBase&
+    operator=(const AsyncSubscriptionBase&) = delete;
+
+protected:
+    /**
+     * Deliver the oldest queued message to the subscriber.
+     *
+     * Called from the dispatcher thread.
+     *
+     * \retval true     A message was delivered.
+     * \retval false    The queue was empty.
+     */
+    virtual bool
+    dispatch() = 0;
+
+    /**
+     * Inform the dispatcher about a newly queued message.
+     */
+    void
+    notifyDispatcher();
+
+    /**
+     * Remove the subscription from its dispatcher.
+     *
+     * Blocks while the dispatcher is executing the subscriber function
+     * of this subscription. Has to be called by the destructor of the
+     * most derived class, before the members used by dispatch() are
+     * destroyed. Must not be called from within the subscriber function.
+     */
+    void
+    detach();
+
+private:
+    friend class AsyncDispatcher;
+
+    AsyncDispatcher& mDispatcher;
+    AsyncSubscriptionBase* mNextAsyncSubscription;
+};
+
+/**
+ * Worker which executes the subscriber functions of asynchronous
+ * subscriptions.
+ *
+ * One dispatcher can serve any number of AsyncSubscription objects
+ * with different message types. The subscriptions are served round
+ * robin, one message at a time, so that a busy topic can not starve
+ * the others. Use multiple dispatchers to distribute the subscriber
+ * functions over multiple threads.
+ *
+ * \see     AsyncSubscription
+ * \ingroup smpc
+ */
+class AsyncDispatcher : public rtos::Thread
+{
+public:
+    /**
+     * Create a dispatcher.
+     *
+     * The thread has to be started with start() before any message
+     * is delivered. Alternatively dispatchSingle() can be called
+     * from an existing thread.
+     */
+    explicit AsyncDispatcher(uint8_t priority,
+                             size_t stack = defaultStackSize,
+                             const char* name = "smpcAsync");
+
+    virtual ~AsyncDispatcher();
+
+    /**
+     * Wait for a queued message and deliver it.
+     *
+     * The subscriber function is executed without holding the lock of
+     * the dispatcher. Must only be called from a single thread, either
+     * the dispatcher thread or the thread replacing it.
+     *
+     * \param timeout
+     *      Time to wait for a message.
+     *
+     * \retval true     A message was delivered.
+     * \retval false    Timeout occurred.
+     */
+    bool
+    dispatchSingle(time::Duration timeout);
+
+protected:
+    virtual void
+    run() override;
+
+private:
+    friend class AsyncSubscriptionBase;
+
+    void
+    add(AsyncSubscriptionBase* subscription);
+
+    void
+    remove(AsyncSubscriptionBase* subscription);
+
+    /// Protects the list of subscriptions and the round robin pointer.
+    rtos::Mutex mMutex;
+
+    /// Counts the messages queued in all subscriptions.
+    rtos::Semaphore mPendingMessages;
+
+    /// Released once per waiting remove() when a subscriber function has returned.
+    rtos::Semaphore mDispatchFinished;
+
+    AsyncSubscriptionBase* mSubscriptions;
+    size_t mNumberOfSubscriptions;
+
+    /// Subscription to check first on the next call of dispatchSingle().
+    AsyncSubscriptionBase* mNext;
+
+    /// Subscription whose subscriber function is executed, nullptr if none.
+    AsyncSubscriptionBase* mActive;
+    size_t mWaitingRemovals;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
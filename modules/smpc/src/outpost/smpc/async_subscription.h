@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_ASYNC_SUBSCRIPTION_H
+#define OUTPOST_SMPC_ASYNC_SUBSCRIPTION_H
+
+#include "async_dispatcher.h"
+#include "subscription.h"
+#include "topic.h"
+
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/mutex_guard.h>
+#include <outpost/rtos/semaphore.h>
+#include <outpost/utils/functor.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Behavior of an AsyncSubscription when its queue is full.
+ */
+struct OverflowPolicy
+{
+    enum Type
+    {
+        /// Replace the oldest queued message by the new one.
+        dropOldest,
+
+        /// Discard the new message.
+        dropNewest,
+
+        /// Block the publishing thread until the dispatcher has freed a slot.
+        block
+    };
+};
+
+/**
+ * Subscription with a decoupled subscriber function.
+ *
+ * Published messages are copied into a bounded queue of \p Depth
+ * elements during the publish and the subscriber function is later
+ * executed by an AsyncDispatcher thread. A slow subscriber therefore
+ * does not add latency to the publishing thread.
+ *
+ * The message type must be copy assignable and default constructible.
+ * Use a topic of outpost::utils::SharedBufferPointer to queue a
+ * reference to a pool buffer instead of copying large messages.
+ *
+ * Messages which are discarded because of the overflow policy are
+ * counted, see getNumberOfDroppedMessages().
+ *
+ * Like Subscription the object has to be connected with either
+ * Subscription::connectSubscriptionsToTopics() or connect().
+ *
+ * \tparam  T
+ *      Type of the topic.
+ * \tparam  Depth
+ *      Number of messages which can be queued.
+ *
+ * \see     AsyncDispatcher
+ * \ingroup smpc
+ */
+template <typename T, size_t Depth>
+class AsyncSubscription : public AsyncSubscriptionBase
+{
+    static_assert(Depth > 0, "Depth must be greater than zero");
+
+public:
+    typedef typename Topic<T>::NonConstType MessageType;
+
+    /**
+     * Constructor.
+     *
+     * \param[in]    topic
+     *         Topic to subscribe to
+     * \param[in]    dispatcher
+     *         Dispatcher which executes the subscriber function.
+     * \param[in]    subscriber
+     *         Subscribing class. Must be a subclass of outpost::smpc::Subscriber.
+     * \param[in]    function
+     *         Member function pointer of the subscribing class.
+     * \param[in]    policy
+     *         Behavior if a message is published while the queue is full.
+     */
+    template <typename S>
+    AsyncSubscription(Topic<T>& topic,
+                      AsyncDispatcher& dispatcher,
+                      S* subscriber,
+                      typename Subscription::SubscriberFunction<T, S>::Type function,
+                      OverflowPolicy::Type policy = OverflowPolicy::dropNewest);
+
+    /**
+     * Destroy the subscription.
+     *
+     * Queued messages are discarded. Blocks while the dispatcher is
+     * executing the subscriber function of this subscription.
+     */
+    virtual ~AsyncSubscription();
+
+    /// \see Subscription::connect()
+    inline void
+    connect()
+    {
+        mSubscription.connect();
+    }
+
+    /// \see Subscription::disconnect()
+    inline void
+    disconnect()
+    {
+        mSubscription.disconnect();
+    }
+
+    inline bool
+    isConnected() const
+    {
+        return mSubscription.isConnected();
+    }
+
+    /**
+     * Number of messages which are queued but not yet delivered.
+     */
+    size_t
+    getNumberOfQueuedMessages() const;
+
+    /**
+     * Number of messages lost because the queue was full.
+     */
+    uint32_t
+    getNumberOfDroppedMessages() const;
+
+    /**
+     * Reset the number of dropped messages.
+     */
+    void
+    resetDroppedMessages();
+
+protected:
+    virtual bool
+    dispatch() override;
+
+private:
+    /// Called synchronously by the topic in the publishing thread.
+    void
+    onPublish(T* message);
+
+    const OverflowPolicy::Type mPolicy;
+    const Functor1<void(T*)> mFunctor;
+
+    mutable rtos::Mutex mMutex;
+
+    /// Free slots in the queue, only used by OverflowPolicy::block.
+    rtos::Semaphore mFreeSlots;
+
+    MessageType mMessages[Depth];
+    size_t mReadIndex;
+    size_t mNumberOfMessages;
+    uint32_t mDroppedMessages;
+
+    Subscription mSubscription;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+// ----------------------------------------------------------------------------
+// Implementation of the template functions
+template <typename T, size_t Depth>
+template <typename S>
+outpost::smpc::AsyncSubscription<T, Depth>::AsyncSubscription(
+        Topic<T>& topic,
+        AsyncDispatcher& dispatcher,
+        S* subscriber,
+        typename Subscription::SubscriberFunction<T, S>::Type function,
+        OverflowPolicy::Type policy) :
+    AsyncSubscriptionBase(dispatcher),
+    mPolicy(policy),
+    mFunctor(*subscriber, function),
+    mMutex(),
+    mFreeSlots(Depth),
+    mMessages(),
+    mReadIndex(0),
+    mNumberOfMessages(0),
+    mDroppedMessages(0),
+    mSubscription(topic, this, &AsyncSubscription::onPublish)
+{
+}
+
+template <typename T, size_t Depth>
+outpost::smpc::AsyncSubscription<T, Depth>::~AsyncSubscription()
+{
+    // Stop the publishers first, a blocked publisher needs the dispatcher
+    // to free a slot. The dispatcher must not access the queue afterwards.
+    mSubscription.disconnect();
+    detach();
+}
+
+template <typename T, size_t Depth>
+size_t
+outpost::smpc::AsyncSubscription<T, Depth>::getNumberOfQueuedMessages() const
+{
+    rtos::MutexGuard lock(mMutex);
+    return mNumberOfMessages;
+}
+
+template <typename T, size_t Depth>
+uint32_t
+outpost::smpc::AsyncSubscription<T, Depth>::getNumberOfDroppedMessages() const
+{
+    rtos::MutexGuard lock(mMutex);
+    return mDroppedMessages;
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::AsyncSubscription<T, Depth>::resetDroppedMessages()
+{
+    rtos::MutexGuard lock(mMutex);
+    mDroppedMessages = 0;
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::AsyncSubscription<T, Depth>::onPublish(T* message)
+{
+    if (mPolicy == OverflowPolicy::block)
+    {
+        mFreeSlots.acquire();
+    }
+
+    bool queued = false;
+    {
+        rtos::MutexGuard lock(mMutex);
+        if (mNumberOfMessages < Depth)
+        {
+            mMessages[(mReadIndex + mNumberOfMessages) % Depth] = *message;
+            mNumberOfMessages++;
+            queued = true;
+        }
+        else if (mPolicy == OverflowPolicy::dropOldest)
+        {
+            // The number of queued messages is unchanged, therefore the
+            // dispatcher is not notified again.
+            mMessages[mReadIndex] = *message;
+            mReadIndex = (mReadIndex + 1) % Depth;
+            mDroppedMessages++;
+        }
+        else
+        {
+            mDroppedMessages++;
+        }
+    }
+
+    if (queued)
+    {
+        notifyDispatcher();
+    }
+}
+
+template <typename T, size_t Depth>
+bool
+outpost::smpc::AsyncSubscription<T, Depth>::dispatch()
+{
+    MessageType message;
+    {
+        rtos::MutexGuard lock(mMutex);
+        if (mNumberOfMessages == 0)
+        {
+            return false;
+        }
+
+        message = mMessages[mReadIndex];
+
+        // Release references held by the queue (e.g. SharedBufferPointer)
+        mMessages[mReadIndex] = MessageType();
+        mReadIndex = (mReadIndex + 1) % Depth;
+        mNumberOfMessages--;
+    }
+
+    if (mPolicy == OverflowPolicy::block)
+    {
+        mFreeSlots.release();
+    }
+
+    // Execute the subscriber without holding the lock, publishers
+    // may queue new messages in the meantime.
+    mFunctor.execute(&message);
+    return true;
+}
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "deadline_monitor.h"
+
+using namespace outpost::smpc;
+
+DeadlineMonitor::DeadlineMonitor(const time::Clock& clock,
+                                 time::Duration budget,
+                                 Handler handler) :
+    mClock(clock),
+    mBudget(budget),
+    mHandler(handler),
+    mPublishes(0),
+    mMisses(0),
+    mMaximumDispatchTime(0)
+{
+}
+
+void
+DeadlineMonitor::reset()
+{
+    mPublishes.store(0, std::memory_order_relaxed);
+    mMisses.store(0, std::memory_order_relaxed);
+    mMaximumDispatchTime.store(0, std::memory_order_relaxed);
+}
+
+void
+DeadlineMonitor::check(time::Duration dispatchTime)
+{
+    mPublishes.fetch_add(1, std::memory_order_relaxed);
+
+    const int64_t microseconds = dispatchTime.microseconds();
+    int64_t current = mMaximumDispatchTime.load(std::memory_order_relaxed);
+    while ((microseconds > current)
+           && !mMaximumDispatchTime.compare_exchange_weak(
+                   current, microseconds, std::memory_order_relaxed))
+    {
+    }
+
+    if (dispatchTime > mBudget)
+    {
+        mMisses.fetch_add(1, std::memory_order_relaxed);
+        if (mHandler != nullptr)
+        {
+            mHandler(*this, dispatchTime);
+        }
+    }
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_DEADLINE_MONITOR_H
+#define OUTPOST_SMPC_DEADLINE_MONITOR_H
+
+#include <outpost/time/clock.h>
+#include <outpost/time/duration.h>
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Budget for the dispatch time of a topic.
+ *
+ * Attached to a topic with Topic::setDeadlineMonitor(). Every publish
+ * measures the time until all subscriber functions have returned.
+ * If the budget is exceeded the miss is counted and the optional
+ * handler is called.
+ *
+ * In contrast to the instrumentation this check is available in all
+ * builds and only costs a pointer check for topics without monitor.
+ *
+ * Example:
+ * \code
+ * void
+ * onDeadlineMissed(const DeadlineMonitor& monitor, outpost::time::Duration dispatchTime)
+ * {
+ *     ...
+ * }
+ *
+ * DeadlineMonitor monitor(clock, outpost::time::Microseconds(500), &onDeadlineMissed);
+ * topic.setDeadlineMonitor(&monitor);
+ * \endcode
+ *
+ * \ingroup smpc
+ * \see     Subscription::setPriority()
+ */
+class DeadlineMonitor
+{
+public:
+    /**
+     * Called by the publishing thread after a publish has exceeded
+     * the budget.
+     */
+    typedef void (*Handler)(const DeadlineMonitor& monitor, time::Duration dispatchTime);
+
+    /**
+     * Measures the dispatch time of a single publish.
+     *
+     * Does nothing if constructed without monitor.
+     */
+    class Measurement
+    {
+    public:
+        explicit inline Measurement(DeadlineMonitor* monitor) : mMonitor(monitor), mStart()
+        {
+            if (mMonitor != nullptr)
+            {
+                mStart = mMonitor->mClock.now();
+            }
+        }
+
+        inline ~Measurement()
+        {
+            if (mMonitor != nullptr)
+            {
+                mMonitor->check(mMonitor->mClock.now() - mStart);
+            }
+        }
+
+        // Disable copy constructor
+        Measurement(const Measurement&) = delete;
+
+        // Disable copy assignment operator
+        Measurement&
+        operator=(const Measurement&) = delete;
+
+    private:
+        DeadlineMonitor* const mMonitor;
+        time::SpacecraftElapsedTime mStart;
+    };
+
+    /**
+     * \param clock
+     *      Clock used for the measurements. Must outlive the monitor.
+     * \param budget
+     *      Maximum allowed dispatch time of a single publish.
+     * \param handler
+     *      Optional function called for every missed deadline.
+     */
+    DeadlineMonitor(const time::Clock& clock, time::Duration budget, Handler handler = nullptr);
+
+    // Disable copy constructor
+    DeadlineMonitor(const DeadlineMonitor&) = delete;
+
+    // Disable copy assignment operator
+    DeadlineMonitor&
+    operator=(const DeadlineMonitor&) = delete;
+
+    inline time::Duration
+    getBudget() const
+    {
+        return mBudget;
+    }
+
+    /**
+     * Number of checked publishes.
+     */
+    inline uint32_t
+    getNumberOfPublishes() const
+    {
+        return mPublishes.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Number of publishes which have exceeded the budget.
+     */
+    inline uint32_t
+    getNumberOfMisses() const
+    {
+        return mMisses.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Longest dispatch time since the last reset.
+     */
+    inline time::Duration
+    getMaximumDispatchTime() const
+    {
+        return time::Microseconds(mMaximumDispatchTime.load(std::memory_order_relaxed));
+    }
+
+    void
+    reset();
+
+private:
+    void
+    check(time::Duration dispatchTime);
+
+    const time::Clock& mClock;
+    const time::Duration mBudget;
+    const Handler mHandler;
+
+    std::atomic<uint32_t> mPublishes;
+    std::atomic<uint32_t> mMisses;
+    std::atomic<int64_t> mMaximumDispatchTime;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
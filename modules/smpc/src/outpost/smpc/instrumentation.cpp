@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "instrumentation.h"
+
+using namespace outpost::smpc;
+
+constexpr size_t DurationHistogram::numberOfBins;
+
+namespace
+{
+void
+updateMaximum(std::atomic<int64_t>& maximum, int64_t value)
+{
+    int64_t current = maximum.load(std::memory_order_relaxed);
+    while ((value > current)
+           && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+}  // namespace
+
+DurationHistogram::DurationHistogram() : mBins(), mMaximum(0)
+{
+    reset();
+}
+
+void
+DurationHistogram::add(outpost::time::Duration duration)
+{
+    int64_t microseconds = duration.microseconds();
+    if (microseconds < 0)
+    {
+        microseconds = 0;
+    }
+
+    size_t bin = 0;
+    while ((bin < numberOfBins - 1) && (microseconds >= (static_cast<int64_t>(1) << bin)))
+    {
+        bin++;
+    }
+
+    mBins[bin].fetch_add(1, std::memory_order_relaxed);
+    updateMaximum(mMaximum, microseconds);
+}
+
+void
+DurationHistogram::reset()
+{
+    for (size_t i = 0; i < numberOfBins; ++i)
+    {
+        mBins[i].store(0, std::memory_order_relaxed);
+    }
+    mMaximum.store(0, std::memory_order_relaxed);
+}
+
+uint32_t
+DurationHistogram::getNumberOfSamples() const
+{
+    uint32_t samples = 0;
+    for (size_t i = 0; i < numberOfBins; ++i)
+    {
+        samples += getCount(i);
+    }
+    return samples;
+}
+
+outpost::time::Duration
+DurationHistogram::getUpperLimit(size_t bin)
+{
+    if (bin >= numberOfBins - 1)
+    {
+        return time::Duration::maximum();
+    }
+    return time::Microseconds(static_cast<int64_t>(1) << bin);
+}
+
+// ----------------------------------------------------------------------------
+const outpost::time::Clock* instrumentation::Enabled::mClock = nullptr;
+
+instrumentation::Enabled::Stopwatch::Stopwatch() : mClock(Enabled::mClock), mStart()
+{
+    if (mClock != nullptr)
+    {
+        mStart = mClock->now();
+    }
+}
+
+bool
+instrumentation::Enabled::Stopwatch::getElapsed(time::Duration& elapsed) const
+{
+    if (mClock == nullptr)
+    {
+        return false;
+    }
+    elapsed = mClock->now() - mStart;
+    return true;
+}
+
+instrumentation::Enabled::TopicStatistics::TopicStatistics() :
+    mPublishes(0),
+    mMaximumConnectWait(0)
+{
+}
+
+void
+instrumentation::Enabled::TopicStatistics::onConnectLockAcquired(const Stopwatch& stopwatch) const
+{
+    time::Duration wait = time::Duration::zero();
+    if (stopwatch.getElapsed(wait))
+    {
+        updateMaximum(mMaximumConnectWait, wait.microseconds());
+    }
+}
+
+void
+instrumentation::Enabled::TopicStatistics::reset() const
+{
+    mPublishes.store(0, std::memory_order_relaxed);
+    mMaximumConnectWait.store(0, std::memory_order_relaxed);
+}
+
+instrumentation::Enabled::SubscriptionStatistics::SubscriptionStatistics() :
+    mCalls(0),
+    mCallbackDurations()
+{
+}
+
+void
+instrumentation::Enabled::SubscriptionStatistics::onCallbackFinished(
+        const Stopwatch& stopwatch) const
+{
+    mCalls.fetch_add(1, std::memory_order_relaxed);
+
+    time::Duration duration = time::Duration::zero();
+    if (stopwatch.getElapsed(duration))
+    {
+        mCallbackDurations.add(duration);
+    }
+}
+
+void
+instrumentation::Enabled::SubscriptionStatistics::reset() const
+{
+    mCalls.store(0, std::memory_order_relaxed);
+    mCallbackDurations.reset();
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_INSTRUMENTATION_H
+#define OUTPOST_SMPC_INSTRUMENTATION_H
+
+#include <outpost/time/clock.h>
+#include <outpost/time/duration.h>
+#include <outpost/time/time_epoch.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Histogram of durations with logarithmic bins.
+ *
+ * Bin 0 counts durations below 1us, bin n counts durations in the
+ * range [2^(n-1), 2^n) us. The last bin additionally contains all
+ * longer durations.
+ *
+ * Samples may be added concurrently from multiple threads.
+ *
+ * \ingroup smpc
+ */
+class DurationHistogram
+{
+public:
+    static constexpr size_t numberOfBins = 16;
+
+    DurationHistogram();
+
+    // Disable copy constructor
+    DurationHistogram(const DurationHistogram&) = delete;
+
+    // Disable copy assignment operator
+    DurationHistogram&
+    operator=(const DurationHistogram&) = delete;
+
+    void
+    add(time::Duration duration);
+
+    void
+    reset();
+
+    inline uint32_t
+    getCount(size_t bin) const
+    {
+        return mBins[bin].load(std::memory_order_relaxed);
+    }
+
+    uint32_t
+    getNumberOfSamples() const;
+
+    inline time::Duration
+    getMaximum() const
+    {
+        return time::Microseconds(mMaximum.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * Exclusive upper limit of the given bin.
+     *
+     * Returns time::Duration::maximum() for the last bin.
+     */
+    static time::Duration
+    getUpperLimit(size_t bin);
+
+private:
+    std::atomic<uint32_t> mBins[numberOfBins];
+
+    /// Longest duration in microseconds
+    std::atomic<int64_t> mMaximum;
+};
+
+namespace instrumentation
+{
+/**
+ * No instrumentation.
+ *
+ * All functions are empty and inlined, the instrumentation hooks in
+ * the publish path are completely removed by the compiler. The
+ * getter functions only exist to allow the same code to walk the
+ * statistics with both policies.
+ *
+ * The statistics classes are empty. Topics and subscriptions inherit
+ * from them, so they do not add to the size of these objects.
+ */
+class Disabled
+{
+public:
+    static constexpr bool enabled = false;
+
+    class Stopwatch
+    {
+    public:
+        inline Stopwatch()
+        {
+        }
+    };
+
+    class TopicStatistics
+    {
+    public:
+        inline void
+        onPublish() const
+        {
+        }
+
+        inline void
+        onConnectLockAcquired(const Stopwatch&) const
+        {
+        }
+
+        inline void
+        reset() const
+        {
+        }
+
+        inline uint32_t
+        getNumberOfPublishes() const
+        {
+            return 0;
+        }
+
+        inline time::Duration
+        getMaximumConnectWait() const
+        {
+            return time::Duration::zero();
+        }
+    };
+
+    class SubscriptionStatistics
+    {
+    public:
+        inline void
+        onCallbackFinished(const Stopwatch&) const
+        {
+        }
+
+        inline void
+        reset() const
+        {
+        }
+
+        inline uint32_t
+        getNumberOfCalls() const
+        {
+            return 0;
+        }
+
+        inline const DurationHistogram*
+        getCallbackDurations() const
+        {
+            return nullptr;
+        }
+    };
+
+    static inline void
+    setClock(const time::Clock&)
+    {
+    }
+};
+
+/**
+ * Records publish counts, callback durations and the time connect()
+ * and disconnect() wait for the topic mutex.
+ *
+ * Durations are only measured after a clock has been set with
+ * setClock(). Until then only the counters are updated.
+ */
+class Enabled
+{
+public:
+    static constexpr bool enabled = true;
+
+    /**
+     * Takes the current time on construction.
+     */
+    class Stopwatch
+    {
+    public:
+        Stopwatch();
+
+        /**
+         * Time since construction.
+         *
+         * \retval false    No clock available.
+         */
+        bool
+        getElapsed(time::Duration& elapsed) const;
+
+    private:
+        const time::Clock* const mClock;
+        time::SpacecraftElapsedTime mStart;
+    };
+
+    class TopicStatistics
+    {
+    public:
+        TopicStatistics();
+
+        inline void
+        onPublish() const
+        {
+            mPublishes.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Called by connect() and disconnect() after the topic mutex
+         * has been acquired.
+         */
+        void
+        onConnectLockAcquired(const Stopwatch& stopwatch) const;
+
+        void
+        reset() const;
+
+        inline uint32_t
+        getNumberOfPublishes() const
+        {
+            return mPublishes.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Longest time a connect() or disconnect() waited for the topic
+         * mutex. Publishing does not take the mutex and is not included.
+         */
+        inline time::Duration
+        getMaximumConnectWait() const
+        {
+            return time::Microseconds(mMaximumConnectWait.load(std::memory_order_relaxed));
+        }
+
+    private:
+        mutable std::atomic<uint32_t> mPublishes;
+        mutable std::atomic<int64_t> mMaximumConnectWait;
+    };
+
+    class SubscriptionStatistics
+    {
+    public:
+        SubscriptionStatistics();
+
+        void
+        onCallbackFinished(const Stopwatch& stopwatch) const;
+
+        void
+        reset() const;
+
+        inline uint32_t
+        getNumberOfCalls() const
+        {
+            return mCalls.load(std::memory_order_relaxed);
+        }
+
+        inline const DurationHistogram*
+        getCallbackDurations() const
+        {
+            return &mCallbackDurations;
+        }
+
+    private:
+        mutable std::atomic<uint32_t> mCalls;
+        mutable DurationHistogram mCallbackDurations;
+    };
+
+    /**
+     * Set the clock used to measure durations.
+     *
+     * Has to be called during initialization before any topic is
+     * used. The clock must outlive all topics.
+     */
+    static inline void
+    setClock(const time::Clock& clock)
+    {
+        mClock = &clock;
+    }
+
+private:
+    static const time::Clock* mClock;
+};
+
+}  // namespace instrumentation
+
+/**
+ * Instrumentation policy used by all topics and subscriptions.
+ *
+ * Selected at compile time by defining OUTPOST_SMPC_INSTRUMENTATION
+ * for the complete build. Without the define no instrumentation code
+ * is generated.
+ *
+ * \ingroup smpc
+ */
+#ifdef OUTPOST_SMPC_INSTRUMENTATION
+typedef instrumentation::Enabled InstrumentationPolicy;
+#else
+typedef instrumentation::Disabled InstrumentationPolicy;
+#endif
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_KEYED_TOPIC_H
+#define OUTPOST_SMPC_KEYED_TOPIC_H
+
+#include "read_epoch.h"
+#include "subscription.h"
+#include "topic.h"
+
+#include <outpost/base/slice.h>
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/mutex_guard.h>
+#include <outpost/utils/container/fixed_ordered_map.h>
+#include <outpost/utils/functor.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace smpc
+{
+// forward declaration
+template <typename T, typename Key>
+class KeyedSubscription;
+
+/**
+ * Base class for %KeyedTopic<> independent of the size of the index.
+ *
+ * \see     KeyedTopic
+ */
+template <typename T, typename Key>
+class KeyedTopicBase : public Topic<T>
+{
+public:
+    typedef typename Topic<T>::NonConstType NonConstType;
+
+    /// Extracts the key from a message
+    typedef Key (*KeyFunction)(const NonConstType& message);
+
+    /// Index entry, sorted by mKey. Used with outpost::FixedOrderedMap.
+    struct Entry
+    {
+        Key mKey;
+        KeyedSubscription<T, Key>* mSubscriptions;
+    };
+
+    /**
+     * Publish new data.
+     *
+     * Forwards the message to all normal subscriptions and to the
+     * keyed subscriptions with a matching key.
+     */
+    inline void
+    publish(T& message) const
+    {
+        Topic<T>::publish(message);
+        publishKeyed(message);
+    }
+
+    /**
+     * Publish a block of messages.
+     *
+     * \see Topic::publishBatch()
+     */
+    void
+    publishBatch(outpost::Slice<T> messages) const;
+
+    /**
+     * Number of different keys currently stored in the index.
+     */
+    inline size_t
+    getNumberOfKeys() const
+    {
+        ReadEpoch::Guard guard(mEpoch);
+        return mNumberOfEntries[mActive.load()];
+    }
+
+protected:
+    KeyedTopicBase(KeyFunction keyFunction,
+                   Entry* first,
+                   Entry* second,
+                   size_t maximumNumberOfKeys);
+
+    ~KeyedTopicBase() = default;
+
+private:
+    friend class KeyedSubscription<T, Key>;
+
+    void
+    publishKeyed(T& message) const;
+
+    /**
+     * Add a subscription to the index.
+     *
+     * \retval false    The index is full.
+     */
+    bool
+    insertSubscription(KeyedSubscription<T, Key>* subscription);
+
+    void
+    removeSubscription(KeyedSubscription<T, Key>* subscription);
+
+    /**
+     * Switch to the modified index.
+     *
+     * The previously active index may be modified again only after
+     * all publishers have left it, see acquireInactiveIndex().
+     */
+    void
+    activateInactiveIndex();
+
+    /**
+     * Acquire mMutex and wait until no publisher uses the inactive index.
+     *
+     * The mutex is released while waiting, other threads may connect
+     * and disconnect subscriptions in the meantime.
+     */
+    void
+    acquireInactiveIndex();
+
+    const KeyFunction mKeyFunction;
+    const size_t mMaximumNumberOfKeys;
+
+    /// Serializes modifications of the index.
+    rtos::Mutex mMutex;
+
+    /// Incremented with every switch of the index, protected by mMutex.
+    uint32_t mGeneration;
+
+    /// No publisher uses the inactive index anymore, protected by mMutex.
+    bool mInactiveIndexReleased;
+
+    /// Tracks the publishers currently using the active index.
+    ReadEpoch mEpoch;
+
+    /**
+     * Two copies of the index. Publishers only use the active one,
+     * modifications are done on the other copy which is activated
+     * afterwards.
+     */
+    Entry* const mEntries[2];
+    size_t mNumberOfEntries[2];
+    std::atomic<uint8_t> mActive;
+};
+
+/**
+ * %Topic with an index of subscriptions by key.
+ *
+ * The key is extracted once per published message and only the
+ * KeyedSubscription objects with a matching key are called. The
+ * lookup is a binary search over the sorted keys (O(log N)),
+ * independent of the number of subscriptions for other keys.
+ * Typical keys are packet identifiers or sensor channels.
+ *
+ * Normal subscriptions (with or without a MessageFilter) can be
+ * bound to a keyed topic as well and receive every message.
+ *
+ * \warning
+ *      Keyed subscriptions are only served by KeyedTopic::publish().
+ *      Publishing through a reference to the base class Topic<T>
+ *      only reaches the normal subscriptions.
+ *
+ * Example:
+ * \code
+ * uint16_t
+ * getApid(const Packet& packet)
+ * {
+ *     return packet.apid;
+ * }
+ *
+ * KeyedTopic<const Packet, uint16_t, 32> packets(&getApid);
+ * KeyedSubscription<const Packet, uint16_t> housekeeping(
+ *         packets, 0x10, this, &Housekeeping::onPacket);
+ * \endcode
+ *
+ * \tparam  T
+ *      Type of the topic.
+ * \tparam  Key
+ *      Type of the key. Must support operator== and operator<.
+ * \tparam  MaximumNumberOfKeys
+ *      Number of different keys which can be subscribed to.
+ *
+ * \ingroup smpc
+ * \see     KeyedSubscription
+ */
+template <typename T, typename Key, size_t MaximumNumberOfKeys>
+class KeyedTopic : public KeyedTopicBase<T, Key>
+{
+public:
+    typedef typename KeyedTopicBase<T, Key>::KeyFunction KeyFunction;
+    typedef typename KeyedTopicBase<T, Key>::Entry Entry;
+
+    explicit KeyedTopic(KeyFunction keyFunction) :
+        KeyedTopicBase<T, Key>(keyFunction, mFirst, mSecond, MaximumNumberOfKeys),
+        mFirst(),
+        mSecond()
+    {
+    }
+
+    /**
+     * Destroy the topic.
+     *
+     * All keyed subscriptions have to be destroyed before the topic.
+     */
+    ~KeyedTopic() = default;
+
+    // disable copy constructor
+    KeyedTopic(const KeyedTopic&) = delete;
+
+    // disable assignment operator
+    KeyedTopic&
+    operator=(const KeyedTopic&) = delete;
+
+private:
+    Entry mFirst[MaximumNumberOfKeys];
+    Entry mSecond[MaximumNumberOfKeys];
+};
+
+/**
+ * Subscription to the messages of a keyed topic with a specific key.
+ *
+ * In contrast to Subscription a keyed subscription is connected
+ * directly by the constructor and disconnected by the destructor.
+ * Both may be done while other threads are publishing.
+ *
+ * \ingroup smpc
+ * \see     KeyedTopic
+ */
+template <typename T, typename Key>
+class KeyedSubscription
+{
+public:
+    /**
+     * Create the subscription and connect it to the topic.
+     *
+     * Must not be called from within a subscriber function of the same
+     * topic, see connect().
+     */
+    template <typename S>
+    KeyedSubscription(KeyedTopicBase<T, Key>& topic,
+                      Key key,
+                      S* subscriber,
+                      typename Subscription::SubscriberFunction<T, S>::Type function);
+
+    /**
+     * Disconnect and destroy the subscription.
+     *
+     * Blocks until no publisher is executing the subscriber function.
+     */
+    ~KeyedSubscription();
+
+    // Disable copy constructor
+    KeyedSubscription(const KeyedSubscription&) = delete;
+
+    // Disable copy assignment operator
+    KeyedSubscription&
+    operator=(const KeyedSubscription&) = delete;
+
+    /**
+     * Connect the subscription to its topic.
+     *
+     * Only necessary after disconnect() or if the index of the topic
+     * was full during construction.
+     *
+     * Must not be called from within a subscriber function of the same
+     * topic. Before modifying the index it may have to wait for the
+     * publishers of the previous modification, which would include the
+     * calling publisher itself.
+     *
+     * \retval false    The index of the topic is full.
+     */
+    bool
+    connect();
+
+    /**
+     * Disconnect the subscription from its topic.
+     *
+     * Blocks until no publisher is executing the subscriber function.
+     * Must not be called from within a subscriber function of the same
+     * topic.
+     */
+    void
+    disconnect();
+
+    inline bool
+    isConnected() const
+    {
+        return mConnected;
+    }
+
+    inline Key
+    getKey() const
+    {
+        return mKey;
+    }
+
+private:
+    friend class KeyedTopicBase<T, Key>;
+
+    KeyedTopicBase<T, Key>& mTopic;
+    const Key mKey;
+    const Functor1<void(typename Topic<T>::Type*)> mFunctor;
+
+    /// Next subscription with the same key, followed by the publishers.
+    std::atomic<KeyedSubscription*> mNext;
+    bool mConnected;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+// ----------------------------------------------------------------------------
+// Implementation of the template functions
+template <typename T, typename Key>
+outpost::smpc::KeyedTopicBase<T, Key>::KeyedTopicBase(KeyFunction keyFunction,
+                                                      Entry* first,
+                                                      Entry* second,
+                                                      size_t maximumNumberOfKeys) :
+    Topic<T>(),
+    mKeyFunction(keyFunction),
+    mMaximumNumberOfKeys(maximumNumberOfKeys),
+    mMutex(),
+    mGeneration(0),
+    mInactiveIndexReleased(true),
+    mEpoch(),
+    mEntries{first, second},
+    mNumberOfEntries{0, 0},
+    mActive(0)
+{
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedTopicBase<T, Key>::publishBatch(outpost::Slice<T> messages) const
+{
+    Topic<T>::publishBatch(messages);
+    for (T& message : messages)
+    {
+        publishKeyed(message);
+    }
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedTopicBase<T, Key>::publishKeyed(T& message) const
+{
+    ReadEpoch::Guard guard(mEpoch);
+
+    const uint8_t active = mActive.load();
+    const FixedOrderedMap<Entry, Key> index(mEntries[active], mNumberOfEntries[active]);
+    const Entry* entry = index.getEntry(mKeyFunction(message));
+    if (entry != nullptr)
+    {
+        NonConstType* ptr = const_cast<NonConstType*>(&message);
+        for (KeyedSubscription<T, Key>* subscription = entry->mSubscriptions;
+             subscription != nullptr;
+             subscription = subscription->mNext.load())
+        {
+            subscription->mFunctor.execute(ptr);
+        }
+    }
+}
+
+template <typename T, typename Key>
+bool
+outpost::smpc::KeyedTopicBase<T, Key>::insertSubscription(KeyedSubscription<T, Key>* subscription)
+{
+    acquireInactiveIndex();
+
+    const uint8_t active = mActive.load();
+    const Entry* current = mEntries[active];
+    const size_t numberOfEntries = mNumberOfEntries[active];
+    Entry* next = mEntries[active ^ 1];
+
+    // Copy the index and insert the new subscription sorted by key
+    size_t n = 0;
+    size_t i = 0;
+    while ((i < numberOfEntries) && (current[i].mKey < subscription->mKey))
+    {
+        next[n++] = current[i++];
+    }
+
+    if ((i < numberOfEntries) && (current[i].mKey == subscription->mKey))
+    {
+        // Existing key, insert at the head of the list. The rest of
+        // the list is not modified.
+        subscription->mNext.store(current[i].mSubscriptions);
+        next[n].mKey = subscription->mKey;
+        next[n].mSubscriptions = subscription;
+        n++;
+        i++;
+    }
+    else
+    {
+        if (numberOfEntries >= mMaximumNumberOfKeys)
+        {
+            mMutex.release();
+            return false;
+        }
+        subscription->mNext.store(nullptr);
+        next[n].mKey = subscription->mKey;
+        next[n].mSubscriptions = subscription;
+        n++;
+    }
+
+    while (i < numberOfEntries)
+    {
+        next[n++] = current[i++];
+    }
+    mNumberOfEntries[active ^ 1] = n;
+
+    // The grace period of the previously active index is only awaited
+    // by the next modification.
+    activateInactiveIndex();
+    mMutex.release();
+    return true;
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedTopicBase<T, Key>::removeSubscription(KeyedSubscription<T, Key>* subscription)
+{
+    acquireInactiveIndex();
+
+    const uint8_t active = mActive.load();
+    const Entry* current = mEntries[active];
+    const size_t numberOfEntries = mNumberOfEntries[active];
+    Entry* next = mEntries[active ^ 1];
+
+    size_t n = 0;
+    for (size_t i = 0; i < numberOfEntries; ++i)
+    {
+        next[n] = current[i];
+        if (current[i].mKey == subscription->mKey)
+        {
+            KeyedSubscription<T, Key>* successor = subscription->mNext.load();
+            if (current[i].mSubscriptions == subscription)
+            {
+                next[n].mSubscriptions = successor;
+            }
+            else
+            {
+                KeyedSubscription<T, Key>* it = current[i].mSubscriptions;
+                while (it->mNext.load() != subscription)
+                {
+                    it = it->mNext.load();
+                }
+                it->mNext.store(successor);
+            }
+        }
+
+        // Drop keys without subscriptions
+        if (next[n].mSubscriptions != nullptr)
+        {
+            n++;
+        }
+    }
+    mNumberOfEntries[active ^ 1] = n;
+
+    activateInactiveIndex();
+    const uint32_t generation = mGeneration;
+    mMutex.release();
+
+    // Wait for publishers still executing the removed subscription
+    mEpoch.synchronize();
+
+    rtos::MutexGuard lock(mMutex);
+    if (generation == mGeneration)
+    {
+        mInactiveIndexReleased = true;
+    }
+    subscription->mNext.store(nullptr);
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedTopicBase<T, Key>::activateInactiveIndex()
+{
+    mActive.store(mActive.load() ^ 1);
+    mGeneration++;
+    mInactiveIndexReleased = false;
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedTopicBase<T, Key>::acquireInactiveIndex()
+{
+    mMutex.acquire();
+    while (!mInactiveIndexReleased)
+    {
+        const uint32_t generation = mGeneration;
+        mMutex.release();
+        mEpoch.synchronize();
+        mMutex.acquire();
+
+        // Another thread may have switched the index while waiting,
+        // in that case its grace period is still pending.
+        if (generation == mGeneration)
+        {
+            mInactiveIndexReleased = true;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, typename Key>
+template <typename S>
+outpost::smpc::KeyedSubscription<T, Key>::KeyedSubscription(
+        KeyedTopicBase<T, Key>& topic,
+        Key key,
+        S* subscriber,
+        typename Subscription::SubscriberFunction<T, S>::Type function) :
+    mTopic(topic),
+    mKey(key),
+    mFunctor(*subscriber, function),
+    mNext(nullptr),
+    mConnected(false)
+{
+    connect();
+}
+
+template <typename T, typename Key>
+outpost::smpc::KeyedSubscription<T, Key>::~KeyedSubscription()
+{
+    disconnect();
+}
+
+template <typename T, typename Key>
+bool
+outpost::smpc::KeyedSubscription<T, Key>::connect()
+{
+    if (!mConnected)
+    {
+        mConnected = mTopic.insertSubscription(this);
+    }
+    return mConnected;
+}
+
+template <typename T, typename Key>
+void
+outpost::smpc::KeyedSubscription<T, Key>::disconnect()
+{
+    if (mConnected)
+    {
+        mTopic.removeSubscription(this);
+        mConnected = false;
+    }
+}
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_LATCHED_TOPIC_H
+#define OUTPOST_SMPC_LATCHED_TOPIC_H
+
+#include "subscription.h"
+#include "topic.h"
+
+#include <outpost/base/slice.h>
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/mutex_guard.h>
+
+#include <stddef.h>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Message storage of a latched topic.
+ *
+ * \warning
+ *      This class should only be used through outpost::smpc::LatchedTopic
+ *      and never alone!
+ *
+ * \see     LatchedTopic
+ */
+class TopicLatch
+{
+public:
+    // Needed to replay the messages when connecting subscriptions
+    friend class TopicBase;
+
+protected:
+    TopicLatch() = default;
+
+    virtual ~TopicLatch() = default;
+
+    /**
+     * Forward all stored messages to the subscription, oldest first.
+     *
+     * Called with mMutex held.
+     */
+    virtual void
+    replay(const Subscription& subscription) const = 0;
+
+    static inline void
+    deliver(const Subscription& subscription, void* message)
+    {
+        subscription.execute(message);
+    }
+
+    /**
+     * Serializes storing and forwarding of messages with the replay
+     * to new subscriptions. Recursive, subscriber functions may
+     * publish on the same topic again.
+     */
+    mutable rtos::Mutex mMutex;
+};
+
+/**
+ * %Topic with a last-value cache.
+ *
+ * Keeps the last \p Depth published messages and replays them to
+ * every subscription connected later on, either by
+ * Subscription::connectSubscriptionsToTopics() or by
+ * Subscription::connect(). Subscriptions which were already
+ * connected before are not called again.
+ *
+ * Intended for state information like the current operating mode or
+ * the latest time correlation, which otherwise would have to be
+ * republished periodically for late joining components.
+ *
+ * The replay and the publication of new messages are serialized by a
+ * mutex, a new subscription receives every message exactly once and
+ * in order. In contrast to Topic concurrent publishers block each
+ * other. The subscriber functions of the replay are called by the
+ * thread connecting the subscription.
+ *
+ * \warning
+ *      The latch is only updated by LatchedTopic::publish() and
+ *      LatchedTopic::publishBatch(). Publishing through a reference
+ *      to the base class Topic<T> bypasses the cache.
+ *
+ * Example:
+ * \code
+ * LatchedTopic<const OperatingMode, 1> mode;
+ * \endcode
+ *
+ * \tparam  T
+ *      Type of the topic. The messages are copied into the cache,
+ *      the type must be default constructible and copy assignable.
+ * \tparam  Depth
+ *      Number of messages kept for the replay.
+ *
+ * \ingroup smpc
+ * \see     Topic
+ */
+template <typename T, size_t Depth>
+class LatchedTopic : private TopicLatch, public Topic<T>
+{
+public:
+    static_assert(Depth > 0, "Depth must be at least one");
+
+    typedef typename Topic<T>::NonConstType NonConstType;
+
+    LatchedTopic();
+
+    ~LatchedTopic() = default;
+
+    // disable copy constructor
+    LatchedTopic(const LatchedTopic&) = delete;
+
+    // disable assignment operator
+    LatchedTopic&
+    operator=(const LatchedTopic&) = delete;
+
+    /**
+     * Store the message and forward it to all connected subscribers.
+     */
+    void
+    publish(T& message) const;
+
+    /**
+     * Store the messages and forward them to all connected subscribers.
+     *
+     * Only the last \p Depth messages of the block are kept.
+     *
+     * \see Topic::publishBatch()
+     */
+    void
+    publishBatch(outpost::Slice<T> messages) const;
+
+    /**
+     * Number of messages which would be replayed to a new subscription.
+     */
+    size_t
+    getNumberOfLatchedMessages() const;
+
+    /**
+     * Drop all stored messages.
+     */
+    void
+    clear();
+
+private:
+    virtual void
+    replay(const Subscription& subscription) const override;
+
+    void
+    store(T& message) const;
+
+    mutable NonConstType mMessages[Depth];
+
+    /// Index of the element written next.
+    mutable size_t mNext;
+    mutable size_t mNumberOfMessages;
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+// ----------------------------------------------------------------------------
+// Implementation of the template functions
+template <typename T, size_t Depth>
+outpost::smpc::LatchedTopic<T, Depth>::LatchedTopic() :
+    TopicLatch(), Topic<T>(this), mMessages(), mNext(0), mNumberOfMessages(0)
+{
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::LatchedTopic<T, Depth>::publish(T& message) const
+{
+    rtos::MutexGuard lock(mMutex);
+    store(message);
+    Topic<T>::publish(message);
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::LatchedTopic<T, Depth>::publishBatch(outpost::Slice<T> messages) const
+{
+    rtos::MutexGuard lock(mMutex);
+    for (T& message : messages)
+    {
+        store(message);
+    }
+    Topic<T>::publishBatch(messages);
+}
+
+template <typename T, size_t Depth>
+size_t
+outpost::smpc::LatchedTopic<T, Depth>::getNumberOfLatchedMessages() const
+{
+    rtos::MutexGuard lock(mMutex);
+    return mNumberOfMessages;
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::LatchedTopic<T, Depth>::clear()
+{
+    rtos::MutexGuard lock(mMutex);
+    mNext = 0;
+    mNumberOfMessages = 0;
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::LatchedTopic<T, Depth>::replay(const Subscription& subscription) const
+{
+    size_t index = (mNext + Depth - mNumberOfMessages) % Depth;
+    for (size_t i = 0; i < mNumberOfMessages; ++i)
+    {
+        deliver(subscription, reinterpret_cast<void*>(&mMessages[index]));
+        index = (index + 1) % Depth;
+    }
+}
+
+template <typename T, size_t Depth>
+void
+outpost::smpc::LatchedTopic<T, Depth>::store(T& message) const
+{
+    mMessages[mNext] = message;
+    mNext = (mNext + 1) % Depth;
+    if (mNumberOfMessages < Depth)
+    {
+        mNumberOfMessages++;
+    }
+}
+
+#endif
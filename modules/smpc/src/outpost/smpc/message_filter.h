@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_MESSAGE_FILTER_H
+#define OUTPOST_SMPC_MESSAGE_FILTER_H
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Non-template base class for %MessageFilter<>.
+ *
+ * \see     MessageFilter
+ */
+class MessageFilterBase
+{
+public:
+    MessageFilterBase() = default;
+
+    virtual ~MessageFilterBase() = default;
+
+    /**
+     * \retval true     Message is forwarded to the subscriber.
+     * \retval false    Message is skipped.
+     */
+    virtual bool
+    matchesTypeUnsafe(const void* message) const = 0;
+};
+
+/**
+ * Predicate evaluated by the topic before a message is forwarded
+ * to a subscription.
+ *
+ * Filtering in the topic avoids the call of subscriber functions
+ * which would discard the message anyway. The predicate is called
+ * from the publishing thread and must be thread-safe if the topic
+ * is used by multiple publishers.
+ *
+ * Example:
+ * \code
+ * class HighTemperature : public MessageFilter<Temperature>
+ * {
+ * public:
+ *     virtual bool
+ *     matches(const Temperature& message) const override
+ *     {
+ *         return message.value > 80;
+ *     }
+ * };
+ *
+ * HighTemperature filter;
+ * Subscription subscription(topic, this, &Alarm::onTemperature, filter);
+ * \endcode
+ *
+ * \tparam  T
+ *      Message type of the topic without const qualifier.
+ *
+ * \ingroup smpc
+ * \see     Subscription
+ */
+template <typename T>
+class MessageFilter : public MessageFilterBase
+{
+public:
+    virtual bool
+    matches(const T& message) const = 0;
+
+    virtual bool
+    matchesTypeUnsafe(const void* message) const override
+    {
+        return matches(*reinterpret_cast<const T*>(message));
+    }
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
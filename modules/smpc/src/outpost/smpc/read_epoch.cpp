@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "read_epoch.h"
+
+#include <outpost/rtos/thread.h>
+
+outpost::smpc::ReadEpoch::ReadEpoch() : mPhase(0), mReaders{{0}, {0}}
+{
+}
+
+void
+outpost::smpc::ReadEpoch::synchronize() const
+{
+    // A reader which entered before the call is counted in one of the two
+    // counters until it leaves. Observing each counter at zero once is
+    // therefore sufficient, even if other writers switch the phase in
+    // between. Switching the phase first directs new readers to the other
+    // counter, so that they can not starve the writer.
+    const uint_fast8_t first = mPhase.load();
+    for (uint_fast8_t i = 0; i < 2; ++i)
+    {
+        const uint_fast8_t counter = first ^ i;
+        mPhase.store(counter ^ 1);
+
+        while (mReaders[counter].load() != 0)
+        {
+            // Sleep instead of yield: a yield would not allow lower priority
+            // readers to leave their critical section on a RTOS.
+            rtos::Thread::sleep(time::Milliseconds(1));
+        }
+    }
+}
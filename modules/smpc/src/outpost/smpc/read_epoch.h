@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_READ_EPOCH_H
+#define OUTPOST_SMPC_READ_EPOCH_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Grace period tracking for lock-free readers.
+ *
+ * Readers (the publishing threads) announce themselves by incrementing
+ * the counter of the current phase and never block. A writer that has
+ * unpublished a list of subscriptions calls synchronize() to wait until
+ * every reader that could still hold a reference into that list has
+ * left. Afterwards the list elements may be modified or destroyed.
+ *
+ * Two counters are used so that a continuous stream of new readers
+ * can not starve the writer: new readers always use the counter of the
+ * current phase while the writer drains the counter of the previous
+ * phase.
+ *
+ * \ingroup smpc
+ */
+class ReadEpoch
+{
+public:
+    /**
+     * RAII-style read-side critical section.
+     */
+    class Guard
+    {
+    public:
+        explicit inline Guard(const ReadEpoch& epoch) : mEpoch(epoch), mPhase(epoch.enter())
+        {
+        }
+
+        // Disable copy constructor
+        Guard(const Guard&) = delete;
+
+        // Disable copy assignment operator
+        Guard&
+        operator=(const Guard&) = delete;
+
+        inline ~Guard()
+        {
+            mEpoch.leave(mPhase);
+        }
+
+    private:
+        const ReadEpoch& mEpoch;
+        const uint_fast8_t mPhase;
+    };
+
+    ReadEpoch();
+
+    // Disable copy constructor
+    ReadEpoch(const ReadEpoch&) = delete;
+
+    // Disable copy assignment operator
+    ReadEpoch&
+    operator=(const ReadEpoch&) = delete;
+
+    /**
+     * Wait until all readers which entered before the call have left.
+     *
+     * May be called by several writers concurrently. Never call this
+     * function from within a read-side critical section of the same
+     * object, it would wait for itself.
+     */
+    void
+    synchronize() const;
+
+private:
+    inline uint_fast8_t
+    enter() const
+    {
+        uint_fast8_t phase = mPhase.load();
+        mReaders[phase].fetch_add(1);
+        return phase;
+    }
+
+    inline void
+    leave(uint_fast8_t phase) const
+    {
+        mReaders[phase].fetch_sub(1);
+    }
+
+    mutable std::atomic<uint_fast8_t> mPhase;
+    mutable std::atomic<uint32_t> mReaders[2];
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
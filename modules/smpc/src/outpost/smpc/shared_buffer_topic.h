@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_SHARED_BUFFER_TOPIC_H
+#define OUTPOST_SMPC_SHARED_BUFFER_TOPIC_H
+
+#include "topic.h"
+
+#include <outpost/utils/container/shared_buffer.h>
+
+namespace outpost
+{
+namespace smpc
+{
+/**
+ * Zero-copy topic for variable length data.
+ *
+ * Distributes references to pool buffers instead of raw pointers.
+ * In contrast to TopicRaw the data remains valid after the
+ * subscriber function has returned as long as the subscriber holds
+ * a copy of the pointer. Copying a outpost::utils::SharedBufferPointer
+ * only increments the reference count of the buffer, the data itself
+ * is never copied.
+ *
+ * Subscriber functions have the signature:
+ *
+ * \code
+ * void onPacket(const outpost::utils::SharedBufferPointer* packet);
+ * \endcode
+ *
+ * Both outpost::utils::SharedBufferPointer and
+ * outpost::utils::SharedChildPointer can be published. A child
+ * pointer is delivered with its offset, length and type. A copy
+ * made by the subscriber keeps the whole underlying buffer alive.
+ *
+ * Together with AsyncSubscription the queued elements are only
+ * references to the buffer:
+ *
+ * \code
+ * AsyncSubscription<const outpost::utils::SharedBufferPointer, 8> subscription(
+ *         topic, dispatcher, this, &Logger::onPacket);
+ * \endcode
+ *
+ * \ingroup smpc
+ * \see     Topic
+ * \see     TopicRaw
+ */
+class SharedBufferTopic : public Topic<const utils::SharedBufferPointer>
+{
+public:
+    SharedBufferTopic() = default;
+
+    ~SharedBufferTopic() = default;
+
+    // disable copy constructor
+    SharedBufferTopic(const SharedBufferTopic&) = delete;
+
+    // disable assignment operator
+    SharedBufferTopic&
+    operator=(const SharedBufferTopic&) = delete;
+
+    /**
+     * Publish a buffer.
+     *
+     * Invalid buffers are not forwarded to the subscribers.
+     *
+     * \retval true     Buffer was forwarded to the subscribers.
+     * \retval false    Buffer is invalid.
+     */
+    inline bool
+    publish(const utils::SharedBufferPointer& buffer) const
+    {
+        if (!buffer.isValid())
+        {
+            return false;
+        }
+        Topic<const utils::SharedBufferPointer>::publish(buffer);
+        return true;
+    }
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "statistics_registry.h"
+
+#include "subscription.h"
+#include "subscription_raw.h"
+#include "topic.h"
+#include "topic_raw.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+using namespace outpost::smpc;
+
+namespace
+{
+class Printer : public StatisticsRegistry::Visitor
+{
+public:
+    virtual void
+    visitTopic(const TopicBase& topic, const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        printTopic("topic", &topic, statistics);
+    }
+
+    virtual void
+    visitSubscription(const Subscription& subscription,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        printSubscription(&subscription, statistics);
+    }
+
+    virtual void
+    visitTopic(const TopicRaw& topic, const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        printTopic("raw topic", &topic, statistics);
+    }
+
+    virtual void
+    visitSubscription(const SubscriptionRaw& subscription,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        printSubscription(&subscription, statistics);
+    }
+
+private:
+    static void
+    printTopic(const char* kind,
+               const void* topic,
+               const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        printf("%s %p: publishes %" PRIu32 ", max. connect wait %" PRId64 " us\n",
+               kind,
+               topic,
+               statistics.getNumberOfPublishes(),
+               statistics.getMaximumConnectWait().microseconds());
+    }
+
+    static void
+    printSubscription(const void* subscription,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        printf("  subscription %p: calls %" PRIu32, subscription, statistics.getNumberOfCalls());
+
+        const DurationHistogram* histogram = statistics.getCallbackDurations();
+        if (histogram != nullptr)
+        {
+            printf(", max. %" PRId64 " us\n   ", histogram->getMaximum().microseconds());
+            for (size_t i = 0; i < DurationHistogram::numberOfBins; ++i)
+            {
+                printf(" %" PRIu32, histogram->getCount(i));
+            }
+        }
+        printf("\n");
+    }
+};
+}  // namespace
+
+void
+StatisticsRegistry::walk(Visitor& visitor)
+{
+    for (TopicBase* topic = TopicBase::listOfAllTopics; topic != nullptr;
+         topic = topic->getNext())
+    {
+        visitor.visitTopic(*topic, topic->getStatistics());
+        for (Subscription* subscription = Subscription::listOfAllSubscriptions;
+             subscription != nullptr;
+             subscription = subscription->getNext())
+        {
+            if (subscription->mTopic == topic)
+            {
+                visitor.visitSubscription(*subscription, subscription->getStatistics());
+            }
+        }
+    }
+
+    for (TopicRaw* topic = TopicRaw::listOfAllTopics; topic != nullptr; topic = topic->getNext())
+    {
+        visitor.visitTopic(*topic, topic->getStatistics());
+        for (SubscriptionRaw* subscription = SubscriptionRaw::listOfAllSubscriptions;
+             subscription != nullptr;
+             subscription = subscription->getNext())
+        {
+            if (subscription->mTopic == topic)
+            {
+                visitor.visitSubscription(*subscription, subscription->getStatistics());
+            }
+        }
+    }
+}
+
+void
+StatisticsRegistry::print()
+{
+    if (!InstrumentationPolicy::enabled)
+    {
+        printf("smpc instrumentation disabled\n");
+        return;
+    }
+
+    Printer printer;
+    walk(printer);
+}
+
+void
+StatisticsRegistry::reset()
+{
+    for (TopicBase* topic = TopicBase::listOfAllTopics; topic != nullptr;
+         topic = topic->getNext())
+    {
+        topic->getStatistics().reset();
+    }
+    for (Subscription* subscription = Subscription::listOfAllSubscriptions;
+         subscription != nullptr;
+         subscription = subscription->getNext())
+    {
+        subscription->getStatistics().reset();
+    }
+
+    for (TopicRaw* topic = TopicRaw::listOfAllTopics; topic != nullptr; topic = topic->getNext())
+    {
+        topic->getStatistics().reset();
+    }
+    for (SubscriptionRaw* subscription = SubscriptionRaw::listOfAllSubscriptions;
+         subscription != nullptr;
+         subscription = subscription->getNext())
+    {
+        subscription->getStatistics().reset();
+    }
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_SMPC_STATISTICS_REGISTRY_H
+#define OUTPOST_SMPC_STATISTICS_REGISTRY_H
+
+#include "instrumentation.h"
+
+namespace outpost
+{
+namespace smpc
+{
+// forward declarations
+class TopicBase;
+class TopicRaw;
+class Subscription;
+class SubscriptionRaw;
+
+/**
+ * Access to the statistics of all topics and subscriptions.
+ *
+ * The statistics are only recorded if the library is build with
+ * OUTPOST_SMPC_INSTRUMENTATION, otherwise all values are zero.
+ *
+ * \warning
+ *      Walking the topics is not thread-safe with respect to threads
+ *      creating or destroying topics and/or subscriptions.
+ *
+ * \see     InstrumentationPolicy
+ * \ingroup smpc
+ */
+class StatisticsRegistry
+{
+public:
+    typedef InstrumentationPolicy::TopicStatistics TopicStatistics;
+    typedef InstrumentationPolicy::SubscriptionStatistics SubscriptionStatistics;
+
+    /**
+     * Receives the statistics during walk().
+     *
+     * Every topic is followed by all subscriptions bound to it.
+     */
+    class Visitor
+    {
+    public:
+        virtual ~Visitor() = default;
+
+        virtual void
+        visitTopic(const TopicBase& topic, const TopicStatistics& statistics) = 0;
+
+        virtual void
+        visitSubscription(const Subscription& subscription,
+                          const SubscriptionStatistics& statistics) = 0;
+
+        virtual void
+        visitTopic(const TopicRaw& topic, const TopicStatistics& statistics) = 0;
+
+        virtual void
+        visitSubscription(const SubscriptionRaw& subscription,
+                          const SubscriptionStatistics& statistics) = 0;
+    };
+
+    /**
+     * Walk over all typed and raw topics.
+     */
+    static void
+    walk(Visitor& visitor);
+
+    /**
+     * Print the statistics of all topics to stdout.
+     */
+    static void
+    print();
+
+    /**
+     * Reset the statistics of all topics and subscriptions.
+     */
+    static void
+    reset();
+};
+
+}  // namespace smpc
+}  // namespace outpost
+
+#endif
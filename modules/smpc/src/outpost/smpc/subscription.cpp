@@ -15,35 +15,85 @@
 
 outpost::smpc::Subscription* outpost::smpc::Subscription::listOfAllSubscriptions = 0;
 
+constexpr uint8_t outpost::smpc::Subscription::defaultPriority;
+
 outpost::smpc::Subscription::~Subscription()
 {
+    disconnect();
     removeFromList(&Subscription::listOfAllSubscriptions, this);
+}
+
+void
+outpost::smpc::Subscription::connect()
+{
+    if (!mConnected)
+    {
+        mTopic->insertSubscription(this);
+        mConnected = true;
+    }
+}
 
-    // TODO
-    releaseAllSubscriptions();
-    connectSubscriptionsToTopics();
+void
+outpost::smpc::Subscription::disconnect()
+{
+    if (mConnected)
+    {
+        mTopic->removeSubscription(this);
+        mConnected = false;
+    }
 }
 
 void
 outpost::smpc::Subscription::connectSubscriptionsToTopics()
 {
-    // Reset the lists in the topics
+    // Reset the lists in the topics. Afterwards no publisher accesses
+    // the subscriptions anymore.
     TopicBase::clearSubscriptions();
 
+    // Prepend to the lists first, sorting afterwards avoids a search of
+    // the insert position for every subscription.
     for (Subscription* it = Subscription::listOfAllSubscriptions; it != 0; it = it->getNext())
     {
-        it->mNextTopicSubscription = it->mTopic->mSubscriptions;
-        it->mTopic->mSubscriptions = it;
+        it->mNextTopicSubscription.store(it->mTopic->mPendingSubscriptions);
+        it->mTopic->mPendingSubscriptions = it;
     }
+    TopicBase::sortPendingSubscriptions();
+
+    TopicBase::publishSubscriptions();
 }
 
 void
 outpost::smpc::Subscription::releaseAllSubscriptions()
 {
+    TopicBase::clearSubscriptions();
+
     for (Subscription* it = Subscription::listOfAllSubscriptions; it != 0; it = it->getNext())
     {
-        it->mNextTopicSubscription = 0;
+        it->mNextTopicSubscription.store(nullptr);
+        it->mPreviousTopicSubscription = nullptr;
+        it->mConnected = false;
     }
+}
 
-    TopicBase::clearSubscriptions();
+void
+outpost::smpc::Subscription::executeBatch(void* messages,
+                                          size_t numberOfMessages,
+                                          size_t elementSize) const
+{
+    if (mBatchDispatcher != nullptr)
+    {
+        mBatchDispatcher(mBatchSubscriber, mBatchFunction, messages, numberOfMessages);
+    }
+    else
+    {
+        uint8_t* message = reinterpret_cast<uint8_t*>(messages);
+        for (size_t i = 0; i < numberOfMessages; ++i)
+        {
+            if ((mFilter == nullptr) || mFilter->matchesTypeUnsafe(message))
+            {
+                mFunctor.execute(message);
+            }
+            message += elementSize;
+        }
+    }
 }
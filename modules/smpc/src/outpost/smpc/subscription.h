@@ -15,11 +15,17 @@
 #ifndef OUTPOST_SMPC_SUBSCRIPTION_H
 #define OUTPOST_SMPC_SUBSCRIPTION_H
 
+#include "message_filter.h"
 #include "subscriber.h"
 #include "topic.h"
 
+#include <outpost/base/slice.h>
 #include <outpost/utils/functor.h>
 
+#include <atomic>
+#include <new>
+#include <type_traits>
+
 namespace outpost
 {
 namespace smpc
@@ -39,13 +45,19 @@ namespace smpc
  * \ingroup smpc
  * \author  Fabian Greif
  */
-class Subscription : public ImplicitList<Subscription>
+class Subscription : public ImplicitList<Subscription>,
+                     private InstrumentationPolicy::SubscriptionStatistics
 {
 public:
     friend class TopicBase;
     friend class TestingTopicBase;  // for unit tests
     friend class SubscriptionRaw;
     friend class ImplicitList<Subscription>;
+    friend class StatisticsRegistry;
+    friend class TopicLatch;
+
+    /// Priority of all subscriptions unless changed by setPriority().
+    static constexpr uint8_t defaultPriority = 128;
 
     template <typename T, typename S>
     struct SubscriberFunction
@@ -53,6 +65,12 @@ public:
         typedef void (S::*Type)(typename Topic<T>::Type* message);
     };
 
+    template <typename T, typename S>
+    struct BatchSubscriberFunction
+    {
+        typedef void (S::*Type)(outpost::Slice<typename Topic<T>::Type> messages);
+    };
+
     /**
      * Constructor.
      *
@@ -68,26 +86,143 @@ public:
     template <typename T, typename S>
     Subscription(Topic<T>& topic, S* subscriber, typename SubscriberFunction<T, S>::Type function);
 
+    /**
+     * Constructor for a filtered subscription.
+     *
+     * The filter is evaluated by the publishing thread, the
+     * subscriber function is only called for matching messages.
+     *
+     * \param[in]    topic
+     *         Topic to subscribe to
+     * \param[in]    subscriber
+     *         Subscribing class. Must be a subclass of outpost::smpc::Subscriber.
+     * \param[in]    function
+     *         Member function pointer of the subscribing class.
+     * \param[in]    filter
+     *         Predicate for the messages. Must outlive the subscription.
+     */
+    template <typename T, typename S>
+    Subscription(Topic<T>& topic,
+                 S* subscriber,
+                 typename SubscriberFunction<T, S>::Type function,
+                 const MessageFilter<typename Topic<T>::NonConstType>& filter);
+
+    /**
+     * Constructor for a batched subscriber.
+     *
+     * The subscriber function receives all messages of a call to
+     * Topic::publishBatch() with a single call. Messages published
+     * with Topic::publish() are delivered as a slice with one element.
+     *
+     * \param[in]    topic
+     *         Topic to subscribe to
+     * \param[in]    subscriber
+     *         Subscribing class. Must be a subclass of outpost::smpc::Subscriber.
+     * \param[in]    function
+     *         Member function pointer of the subscribing class.
+     */
+    template <typename T, typename S>
+    Subscription(Topic<T>& topic,
+                 S* subscriber,
+                 typename BatchSubscriberFunction<T, S>::Type function);
+
     /**
      * Destroy the subscription
      *
+     * Only unlinks this subscription from its topic, other topics
+     * and subscriptions are not affected. Publishers may run
+     * concurrently. Same restrictions as disconnect().
+     *
+     * A subscription may outlive its topic, the topic disconnects it
+     * when it is destroyed. Such a subscription has to be destroyed
+     * before connectSubscriptionsToTopics() is called again.
+     *
      * \warning
-     *     The destruction and creation of subscriptions during the normal
-     *     runtime is not thread-safe. If topics need to be
-     *     destroyed outside the initialization of the application
-     *     it is necessary to hold all other threads which
-     *     might also create or destroy topics and/or subscriptions.
+     *     The creation and destruction of subscriptions is not
+     *     thread-safe with respect to other threads creating or
+     *     destroying topics and/or subscriptions.
      */
     ~Subscription();
 
+    /**
+     * Connect this subscription to its topic.
+     *
+     * Allows to add subscriptions during the normal runtime without
+     * calling connectSubscriptionsToTopics(). The subscription
+     * receives all messages published after this function has
+     * returned. Does nothing if the subscription is already connected.
+     *
+     * For a LatchedTopic the stored messages are forwarded to the
+     * subscriber function before this function returns.
+     *
+     * O(n) in the number of subscriptions of the topic, publishers may
+     * run concurrently.
+     */
+    void
+    connect();
+
+    /**
+     * Disconnect this subscription from its topic.
+     *
+     * After this function has returned the subscription will not be
+     * called anymore. Blocks until no publisher of the topic is
+     * executing a subscriber function, therefore it must not be called
+     * from within a subscriber function of the same topic.
+     *
+     * O(1), publishers may run concurrently.
+     */
+    void
+    disconnect();
+
+    /**
+     * Check if the subscription is connected to its topic.
+     */
+    inline bool
+    isConnected() const
+    {
+        return mConnected;
+    }
+
+    /**
+     * Set the priority of this subscription.
+     *
+     * A topic calls its subscriptions in the order of descending
+     * priority, e.g. a watchdog with a high priority is served before
+     * a logger with a low priority. Subscriptions with the same
+     * priority are called in an unspecified order.
+     *
+     * The priority is applied when the subscription is connected to
+     * its topic, therefore it has to be set before calling
+     * connectSubscriptionsToTopics() or connect().
+     */
+    inline void
+    setPriority(uint8_t priority)
+    {
+        mPriority = priority;
+    }
+
+    inline uint8_t
+    getPriority() const
+    {
+        return mPriority;
+    }
+
     /**
      * Connect all subscriptions to it's assigned topic.
      *
      * Has to be called at program startup to initialize the
-     * Publisher<>Subscriber protocol.
+     * Publisher<>Subscriber protocol. May be called while other
+     * threads are publishing. Messages published while the lists
+     * are rebuilt are not delivered.
+     *
+     * Subscriptions which were not connected before receive the
+     * messages stored by LatchedTopic instances.
+     *
+     * Must not be called concurrently with connect() or disconnect().
      *
      * \internal
-     * Builds the internal linked lists.
+     * Builds the internal linked lists and publishes them as one
+     * snapshot per topic after all publishers have left the old ones.
      */
     static void
     connectSubscriptionsToTopics();
@@ -112,9 +247,25 @@ protected:
     inline void
     execute(void* message) const
     {
-        mFunctor.execute(message);
+        if (mBatchDispatcher != nullptr)
+        {
+            mBatchDispatcher(mBatchSubscriber, mBatchFunction, message, 1);
+        }
+        else if ((mFilter == nullptr) || mFilter->matchesTypeUnsafe(message))
+        {
+            mFunctor.execute(message);
+        }
     }
 
+    /**
+     * Relay multiple messages to the subscribing component.
+     *
+     * Subscribers without a batched subscriber function are called
+     * once per message.
+     */
+    void
+    executeBatch(void* messages, size_t numberOfMessages, size_t elementSize) const;
+
 private:
     // Disable default constructor
     Subscription();
@@ -134,7 +285,29 @@ private:
      * subscriptions to their corresponding topics.
      */
     TopicBase* const mTopic;
-    Subscription* mNextTopicSubscription;
+
+    /// Forward link used by the publishers.
+    std::atomic<Subscription*> mNextTopicSubscription;
+
+    /// Backward link, only used when modifying the list.
+    Subscription* mPreviousTopicSubscription;
+
+    bool mConnected;
+
+    /// Subscriptions with a higher priority are called first.
+    uint8_t mPriority;
+
+    /**
+     * Statistics of the instrumentation policy.
+     *
+     * Inherited instead of being a member, the empty statistics of the
+     * disabled policy then do not take any space.
+     */
+    inline const InstrumentationPolicy::SubscriptionStatistics&
+    getStatistics() const
+    {
+        return *this;
+    }
 
     /**
      * Base-type to cast all member function pointers to. The correct type
@@ -145,7 +318,36 @@ private:
      */
     typedef void (Subscriber::*Function)(void*);
 
+    /**
+     * Storage for batched subscriber functions.
+     *
+     * Holds the member function pointer with its original type, which is
+     * only known to dispatchBatch(). The pointer is never cast to a
+     * member function pointer of a different signature.
+     */
+    typedef std::aligned_storage<sizeof(Function), alignof(Function)>::type BatchFunction;
+
+    typedef void (*BatchDispatcher)(Subscriber* subscriber,
+                                    const BatchFunction& function,
+                                    void* messages,
+                                    size_t numberOfMessages);
+
+    template <typename T, typename S>
+    static void
+    dispatchBatch(Subscriber* subscriber,
+                  const BatchFunction& function,
+                  void* messages,
+                  size_t numberOfMessages);
+
     const Functor1<void(void*)> mFunctor;
+
+    /// Optional predicate, nullptr if all messages are forwarded.
+    const MessageFilterBase* const mFilter;
+
+    /// Only set for batched subscribers, otherwise nullptr.
+    const BatchDispatcher mBatchDispatcher;
+    Subscriber* const mBatchSubscriber;
+    BatchFunction mBatchFunction;
 };
 
 }  // namespace smpc
@@ -158,10 +360,82 @@ outpost::smpc::Subscription::Subscription(Topic<T>& topic,
                                           S* subscriber,
                                           typename SubscriberFunction<T, S>::Type function) :
     ImplicitList<Subscription>(listOfAllSubscriptions, this),
+    InstrumentationPolicy::SubscriptionStatistics(),
+    mTopic(&topic),
+    mNextTopicSubscription(nullptr),
+    mPreviousTopicSubscription(nullptr),
+    mConnected(false),
+    mPriority(defaultPriority),
+    mFunctor(*reinterpret_cast<Subscriber*>(subscriber), reinterpret_cast<Function>(function)),
+    mFilter(nullptr),
+    mBatchDispatcher(nullptr),
+    mBatchSubscriber(nullptr),
+    mBatchFunction()
+{
+}
+
+template <typename T, typename S>
+outpost::smpc::Subscription::Subscription(
+        Topic<T>& topic,
+        S* subscriber,
+        typename SubscriberFunction<T, S>::Type function,
+        const MessageFilter<typename Topic<T>::NonConstType>& filter) :
+    ImplicitList<Subscription>(listOfAllSubscriptions, this),
+    InstrumentationPolicy::SubscriptionStatistics(),
+    mTopic(&topic),
+    mNextTopicSubscription(nullptr),
+    mPreviousTopicSubscription(nullptr),
+    mConnected(false),
+    mPriority(defaultPriority),
+    mFunctor(*reinterpret_cast<Subscriber*>(subscriber), reinterpret_cast<Function>(function)),
+    mFilter(&filter),
+    mBatchDispatcher(nullptr),
+    mBatchSubscriber(nullptr),
+    mBatchFunction()
+{
+}
+
+template <typename T, typename S>
+outpost::smpc::Subscription::Subscription(Topic<T>& topic,
+                                          S* subscriber,
+                                          typename BatchSubscriberFunction<T, S>::Type function) :
+    ImplicitList<Subscription>(listOfAllSubscriptions, this),
+    InstrumentationPolicy::SubscriptionStatistics(),
     mTopic(&topic),
-    mNextTopicSubscription(0),
-    mFunctor(*reinterpret_cast<Subscriber*>(subscriber), reinterpret_cast<Function>(function))
+    mNextTopicSubscription(nullptr),
+    mPreviousTopicSubscription(nullptr),
+    mConnected(false),
+    mPriority(defaultPriority),
+    mFunctor(),
+    mFilter(nullptr),
+    mBatchDispatcher(&Subscription::dispatchBatch<T, S>),
+    mBatchSubscriber(reinterpret_cast<Subscriber*>(subscriber)),
+    mBatchFunction()
 {
+    typedef typename BatchSubscriberFunction<T, S>::Type Type;
+    static_assert((sizeof(Type) <= sizeof(BatchFunction))
+                          && (alignof(Type) <= alignof(BatchFunction)),
+                  "Unsupported member function pointer type");
+    new (&mBatchFunction) Type(function);
+}
+
+template <typename T, typename S>
+void
+outpost::smpc::Subscription::dispatchBatch(Subscriber* subscriber,
+                                           const BatchFunction& function,
+                                           void* messages,
+                                           size_t numberOfMessages)
+{
+    typedef typename Topic<T>::Type Type;
+    typedef typename Topic<T>::NonConstType NonConstType;
+
+    S* object = reinterpret_cast<S*>(subscriber);
+    typename BatchSubscriberFunction<T, S>::Type originalFunction =
+            *static_cast<const typename BatchSubscriberFunction<T, S>::Type*>(
+                    static_cast<const void*>(&function));
+
+    (object->*originalFunction)(outpost::Slice<Type>::unsafe(
+            reinterpret_cast<NonConstType*>(messages), numberOfMessages));
 }
 
 #endif
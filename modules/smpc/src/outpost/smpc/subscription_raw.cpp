@@ -17,10 +17,28 @@ outpost::smpc::SubscriptionRaw* outpost::smpc::SubscriptionRaw::listOfAllSubscri
 
 outpost::smpc::SubscriptionRaw::~SubscriptionRaw()
 {
+    disconnect();
     removeFromList(&SubscriptionRaw::listOfAllSubscriptions, this);
+}
+
+void
+outpost::smpc::SubscriptionRaw::connect()
+{
+    if (!mConnected)
+    {
+        mTopic->insertSubscription(this);
+        mConnected = true;
+    }
+}
 
-    releaseAllSubscriptions();
-    connectSubscriptionsToTopics();
+void
+outpost::smpc::SubscriptionRaw::disconnect()
+{
+    if (mConnected)
+    {
+        mTopic->removeSubscription(this);
+        mConnected = false;
+    }
 }
 
 void
@@ -30,18 +48,29 @@ outpost::smpc::SubscriptionRaw::connectSubscriptionsToTopics()
 
     for (SubscriptionRaw* it = listOfAllSubscriptions; it != 0; it = it->getNext())
     {
-        it->mNextTopicSubscription = it->mTopic->mSubscriptions;
-        it->mTopic->mSubscriptions = it;
+        SubscriptionRaw* head = it->mTopic->mPendingSubscriptions;
+        it->mNextTopicSubscription.store(head);
+        it->mPreviousTopicSubscription = 0;
+        if (head != 0)
+        {
+            head->mPreviousTopicSubscription = it;
+        }
+        it->mTopic->mPendingSubscriptions = it;
+        it->mConnected = true;
     }
+
+    TopicRaw::publishSubscriptions();
 }
 
 void
 outpost::smpc::SubscriptionRaw::releaseAllSubscriptions()
 {
+    TopicRaw::clearSubscriptions();
+
     for (SubscriptionRaw* it = listOfAllSubscriptions; it != 0; it = it->getNext())
     {
-        it->mNextTopicSubscription = 0;
+        it->mNextTopicSubscription.store(0);
+        it->mPreviousTopicSubscription = 0;
+        it->mConnected = false;
     }
-
-    TopicRaw::clearSubscriptions();
 }
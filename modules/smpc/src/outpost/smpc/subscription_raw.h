@@ -21,6 +21,8 @@
 
 #include <stddef.h>
 
+#include <atomic>
+
 namespace outpost
 {
 namespace smpc
@@ -41,10 +43,12 @@ namespace smpc
  * \author  Fabian Greif
  */
 class SubscriptionRaw : public ImplicitList<SubscriptionRaw>,
-                        protected Functor2<void(const void* message, size_t length)>
+                        protected Functor2<void(const void* message, size_t length)>,
+                        private InstrumentationPolicy::SubscriptionStatistics
 {
 public:
     friend class TopicRaw;
+    friend class StatisticsRegistry;
 
     /**
      * Constructor.
@@ -64,22 +68,53 @@ public:
     /**
      * Destroy the subscription
      *
-     * \warning    The destruction and creation of subscriptions during the normal
-     *             runtime is not thread-safe. If topics need to be
-     *             destroyed outside the initialization of the application
-     *             it is necessary to hold all other threads which
-     *             might also create or destroy topics and/or subscriptions.
+     * Only unlinks this subscription from its topic. Publishers may
+     * run concurrently.
+     *
+     * \warning    The creation and destruction of subscriptions is not
+     *             thread-safe with respect to other threads creating or
+     *             destroying topics and/or subscriptions.
      */
     ~SubscriptionRaw();
 
+    /**
+     * Connect this subscription to its topic.
+     *
+     * \see Subscription::connect()
+     */
+    void
+    connect();
+
+    /**
+     * Disconnect this subscription from its topic.
+     *
+     * \see Subscription::disconnect()
+     */
+    void
+    disconnect();
+
+    /**
+     * Check if the subscription is connected to its topic.
+     */
+    inline bool
+    isConnected() const
+    {
+        return mConnected;
+    }
+
     /**
      * Connect all subscriptions to it's assigned topic.
      *
      * Has to be called at program startup to initialize the
-     * Publisher<>Subscriber protocol.
+     * Publisher<>Subscriber protocol. May be called while other
+     * threads are publishing. Messages published while the lists
+     * are rebuilt are not delivered.
+     *
+     * Must not be called concurrently with connect() or disconnect().
      *
      * \internal
-     * Builds the internal linked lists.
+     * Builds the internal linked lists and publishes them as one
+     * snapshot per topic after all publishers have left the old ones.
      */
     static void
     connectSubscriptionsToTopics();
@@ -112,7 +147,21 @@ private:
     // Used by Subscription::connect to map the subscriptions to
     // their corresponding topics.
     TopicRaw* const mTopic;
-    SubscriptionRaw* mNextTopicSubscription;
+    std::atomic<SubscriptionRaw*> mNextTopicSubscription;
+    SubscriptionRaw* mPreviousTopicSubscription;
+    bool mConnected;
+
+    /**
+     * Statistics of the instrumentation policy.
+     *
+     * Inherited instead of being a member, the empty statistics of the
+     * disabled policy then do not take any space.
+     */
+    inline const InstrumentationPolicy::SubscriptionStatistics&
+    getStatistics() const
+    {
+        return *this;
+    }
 };
 
 // ----------------------------------------------------------------------------
@@ -123,8 +172,11 @@ SubscriptionRaw::SubscriptionRaw(TopicRaw& topic,
                                  typename FunctionType<S>::Type function) :
     ImplicitList<SubscriptionRaw>(listOfAllSubscriptions, this),
     Functor2<void(const void* message, size_t length)>(*subscriber, function),
+    InstrumentationPolicy::SubscriptionStatistics(),
     mTopic(&topic),
-    mNextTopicSubscription(0)
+    mNextTopicSubscription(0),
+    mPreviousTopicSubscription(0),
+    mConnected(false)
 {
 }
 
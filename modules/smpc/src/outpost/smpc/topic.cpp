@@ -13,6 +13,7 @@
 
 #include "topic.h"
 
+#include "latched_topic.h"
 #include "subscription.h"
 
 #include <outpost/rtos/mutex_guard.h>
@@ -21,24 +22,83 @@ outpost::smpc::TopicBase* outpost::smpc::TopicBase::listOfAllTopics = nullptr;
 
 outpost::smpc::TopicBase::TopicBase() :
     ImplicitList<TopicBase>(listOfAllTopics, this),
-    mSubscriptions(nullptr)
+    InstrumentationPolicy::TopicStatistics(),
+    mMutex(),
+    mEpoch(),
+    mSubscriptions(nullptr),
+    mPendingSubscriptions(nullptr),
+    mLatch(nullptr),
+    mDeadlineMonitor(nullptr)
+{
+}
+
+outpost::smpc::TopicBase::TopicBase(TopicLatch* latch) :
+    ImplicitList<TopicBase>(listOfAllTopics, this),
+    InstrumentationPolicy::TopicStatistics(),
+    mMutex(),
+    mEpoch(),
+    mSubscriptions(nullptr),
+    mPendingSubscriptions(nullptr),
+    mLatch(latch),
+    mDeadlineMonitor(nullptr)
 {
 }
 
 outpost::smpc::TopicBase::~TopicBase()
 {
     removeFromList(&TopicBase::listOfAllTopics, this);
+
+    // Detach the remaining subscriptions, so that their destructors do not
+    // access the topic anymore.
+    Subscription* subscription;
+    {
+        rtos::MutexGuard lock(mMutex);
+        subscription = mSubscriptions.load();
+        mSubscriptions.store(nullptr);
+    }
+    mEpoch.synchronize();
+
+    while (subscription != nullptr)
+    {
+        Subscription* next = subscription->mNextTopicSubscription.load();
+        subscription->mNextTopicSubscription.store(nullptr);
+        subscription->mPreviousTopicSubscription = nullptr;
+        subscription->mConnected = false;
+        subscription = next;
+    }
 }
 
 void
 outpost::smpc::TopicBase::publishTypeUnsafe(void* message) const
 {
-    rtos::MutexGuard lock(mMutex);
+    ReadEpoch::Guard guard(mEpoch);
+    DeadlineMonitor::Measurement measurement(mDeadlineMonitor.load(std::memory_order_acquire));
+    getStatistics().onPublish();
 
-    for (Subscription* subscription = mSubscriptions; subscription != nullptr;
-         subscription = subscription->mNextTopicSubscription)
+    for (Subscription* subscription = mSubscriptions.load(); subscription != nullptr;
+         subscription = subscription->mNextTopicSubscription.load())
     {
+        InstrumentationPolicy::Stopwatch stopwatch;
         subscription->execute(message);
+        subscription->getStatistics().onCallbackFinished(stopwatch);
+    }
+}
+
+void
+outpost::smpc::TopicBase::publishBatchTypeUnsafe(void* messages,
+                                                 size_t numberOfMessages,
+                                                 size_t elementSize) const
+{
+    ReadEpoch::Guard guard(mEpoch);
+    DeadlineMonitor::Measurement measurement(mDeadlineMonitor.load(std::memory_order_acquire));
+    getStatistics().onPublish();
+
+    for (Subscription* subscription = mSubscriptions.load(); subscription != nullptr;
+         subscription = subscription->mNextTopicSubscription.load())
+    {
+        InstrumentationPolicy::Stopwatch stopwatch;
+        subscription->executeBatch(messages, numberOfMessages, elementSize);
+        subscription->getStatistics().onCallbackFinished(stopwatch);
     }
 }
 
@@ -47,6 +107,214 @@ outpost::smpc::TopicBase::clearSubscriptions()
 {
     for (TopicBase* it = listOfAllTopics; it != nullptr; it = it->getNext())
     {
-        it->mSubscriptions = nullptr;
+        it->mSubscriptions.store(nullptr);
+        it->mPendingSubscriptions = nullptr;
     }
+
+    for (TopicBase* it = listOfAllTopics; it != nullptr; it = it->getNext())
+    {
+        it->mEpoch.synchronize();
+    }
+}
+
+void
+outpost::smpc::TopicBase::publishSubscriptions()
+{
+    for (TopicBase* it = listOfAllTopics; it != nullptr; it = it->getNext())
+    {
+        if (it->mLatch != nullptr)
+        {
+            // Replay and publication of the list must not be interleaved
+            // with a latched publish, otherwise a new subscription could
+            // miss a message or receive it twice.
+            rtos::MutexGuard lock(it->mLatch->mMutex);
+            it->activatePendingSubscriptions();
+        }
+        else
+        {
+            it->activatePendingSubscriptions();
+        }
+    }
+}
+
+void
+outpost::smpc::TopicBase::sortPendingSubscriptions()
+{
+    for (TopicBase* it = listOfAllTopics; it != nullptr; it = it->getNext())
+    {
+        it->mPendingSubscriptions = sortByPriority(it->mPendingSubscriptions);
+
+        Subscription* previous = nullptr;
+        for (Subscription* subscription = it->mPendingSubscriptions; subscription != nullptr;
+             subscription = subscription->mNextTopicSubscription.load())
+        {
+            subscription->mPreviousTopicSubscription = previous;
+            previous = subscription;
+        }
+    }
+}
+
+outpost::smpc::Subscription*
+outpost::smpc::TopicBase::sortByPriority(Subscription* head)
+{
+    // Merge sort on the forward links, the lists are not yet visible to
+    // the publishers.
+    if ((head == nullptr) || (head->mNextTopicSubscription.load() == nullptr))
+    {
+        return head;
+    }
+
+    Subscription* middle = head;
+    for (Subscription* end = head->mNextTopicSubscription.load();
+         (end != nullptr) && (end->mNextTopicSubscription.load() != nullptr);
+         end = end->mNextTopicSubscription.load()->mNextTopicSubscription.load())
+    {
+        middle = middle->mNextTopicSubscription.load();
+    }
+    Subscription* first = head;
+    Subscription* second = middle->mNextTopicSubscription.load();
+    middle->mNextTopicSubscription.store(nullptr);
+
+    first = sortByPriority(first);
+    second = sortByPriority(second);
+
+    Subscription* result = nullptr;
+    Subscription* last = nullptr;
+    while ((first != nullptr) || (second != nullptr))
+    {
+        Subscription* next;
+        if ((second == nullptr) || ((first != nullptr) && (first->mPriority >= second->mPriority)))
+        {
+            next = first;
+            first = first->mNextTopicSubscription.load();
+        }
+        else
+        {
+            next = second;
+            second = second->mNextTopicSubscription.load();
+        }
+
+        if (last != nullptr)
+        {
+            last->mNextTopicSubscription.store(next);
+        }
+        else
+        {
+            result = next;
+        }
+        last = next;
+    }
+    last->mNextTopicSubscription.store(nullptr);
+    return result;
+}
+
+void
+outpost::smpc::TopicBase::activatePendingSubscriptions()
+{
+    for (Subscription* subscription = mPendingSubscriptions; subscription != nullptr;
+         subscription = subscription->mNextTopicSubscription.load())
+    {
+        if (!subscription->mConnected && (mLatch != nullptr))
+        {
+            mLatch->replay(*subscription);
+        }
+        subscription->mConnected = true;
+    }
+    mSubscriptions.store(mPendingSubscriptions);
+}
+
+void
+outpost::smpc::TopicBase::insertSubscription(Subscription* subscription)
+{
+    if (mLatch != nullptr)
+    {
+        rtos::MutexGuard lock(mLatch->mMutex);
+        mLatch->replay(*subscription);
+        linkSubscription(subscription);
+    }
+    else
+    {
+        linkSubscription(subscription);
+    }
+}
+
+void
+outpost::smpc::TopicBase::linkSubscription(Subscription* subscription)
+{
+    InstrumentationPolicy::Stopwatch stopwatch;
+    rtos::MutexGuard lock(mMutex);
+    getStatistics().onConnectLockAcquired(stopwatch);
+
+    Subscription* previous = findPredecessor(mSubscriptions.load(), subscription->mPriority);
+    Subscription* next = (previous != nullptr) ? previous->mNextTopicSubscription.load()
+                                               : mSubscriptions.load();
+
+    subscription->mPreviousTopicSubscription = previous;
+    subscription->mNextTopicSubscription.store(next);
+    if (next != nullptr)
+    {
+        next->mPreviousTopicSubscription = subscription;
+    }
+
+    // Make the subscription visible to the publishers. The forward link
+    // of the new subscription is already valid at this point.
+    if (previous != nullptr)
+    {
+        previous->mNextTopicSubscription.store(subscription);
+    }
+    else
+    {
+        mSubscriptions.store(subscription);
+    }
+}
+
+outpost::smpc::Subscription*
+outpost::smpc::TopicBase::findPredecessor(Subscription* head, uint8_t priority)
+{
+    // A new subscription is placed in front of all subscriptions with
+    // the same priority. Without priorities this keeps the order of the
+    // previous implementation.
+    Subscription* previous = nullptr;
+    for (Subscription* it = head; (it != nullptr) && (it->mPriority > priority);
+         it = it->mNextTopicSubscription.load())
+    {
+        previous = it;
+    }
+    return previous;
+}
+
+void
+outpost::smpc::TopicBase::removeSubscription(Subscription* subscription)
+{
+    {
+        InstrumentationPolicy::Stopwatch stopwatch;
+        rtos::MutexGuard lock(mMutex);
+        getStatistics().onConnectLockAcquired(stopwatch);
+
+        Subscription* previous = subscription->mPreviousTopicSubscription;
+        Subscription* next = subscription->mNextTopicSubscription.load();
+        if (previous != nullptr)
+        {
+            previous->mNextTopicSubscription.store(next);
+        }
+        else
+        {
+            mSubscriptions.store(next);
+        }
+
+        if (next != nullptr)
+        {
+            next->mPreviousTopicSubscription = previous;
+        }
+    }
+
+    // Publishers which are currently executing the removed subscription
+    // still follow its forward link. Wait until they have left before
+    // the links are reset. The mutex is not held while waiting, otherwise
+    // a subscriber function modifying the list would block the publisher
+    // this function is waiting for.
+    mEpoch.synchronize();
+
+    subscription->mNextTopicSubscription.store(nullptr);
+    subscription->mPreviousTopicSubscription = nullptr;
 }
@@ -14,18 +14,27 @@
 #ifndef OUTPOST_SMPC_TOPIC_H
 #define OUTPOST_SMPC_TOPIC_H
 
+#include "deadline_monitor.h"
+#include "instrumentation.h"
+#include "read_epoch.h"
+
+#include <outpost/base/slice.h>
 #include <outpost/rtos/mutex.h>
 #include <outpost/utils/container/implicit_list.h>
 #include <outpost/utils/meta.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+
 namespace outpost
 {
 namespace smpc
 {
 // forward declaration
 class Subscription;
+class TopicLatch;
 
 /**
  * Non-template base class for %Topic<>.
@@ -37,7 +46,8 @@ class Subscription;
  * \see     Topic
  * \author  Fabian Greif
  */
-class TopicBase : protected ImplicitList<TopicBase>
+class TopicBase : protected ImplicitList<TopicBase>,
+                  private InstrumentationPolicy::TopicStatistics
 {
 public:
     // Needed to allow Subscription() to append itself to the
@@ -45,15 +55,30 @@ public:
     friend class Subscription;
     friend class ImplicitList<TopicBase>;
     friend class TestingTopicBase;
+    friend class StatisticsRegistry;
 
     /**
      * Constructor.
      */
     TopicBase();
 
+    /**
+     * Constructor for topics which replay stored messages to
+     * subscriptions connected later on.
+     *
+     * \param latch
+     *      Storage for the messages. Must outlive the topic.
+     *
+     * \see LatchedTopic
+     */
+    explicit TopicBase(TopicLatch* latch);
+
     /**
      * Destroy the topic.
      *
+     * Subscriptions still connected to the topic are disconnected.
+     * They must not be connected again afterwards.
+     *
      * \warning
      *         The destruction and creation of topic during the normal
      *         runtime is not thread-safe. If topics need to be
@@ -74,24 +99,158 @@ public:
      * Publish new data.
      *
      * Forwards the pointer to all connected subscribers. This
-     * function is thread safe.
+     * function is thread safe and lock-free: concurrent publishers
+     * on the same topic do not block each other.
      */
     void
     publishTypeUnsafe(void* message) const;
 
+    /**
+     * Publish multiple messages.
+     *
+     * Batched subscribers receive all messages with a single call,
+     * other subscribers are called once per message.
+     *
+     * \param messages
+     *      Pointer to the first message.
+     * \param numberOfMessages
+     *      Number of consecutive messages.
+     * \param elementSize
+     *      Size of a single message in bytes.
+     */
+    void
+    publishBatchTypeUnsafe(void* messages, size_t numberOfMessages, size_t elementSize) const;
+
+    /**
+     * Check the dispatch time of every publish against a budget.
+     *
+     * The time from the start of a publish until the last subscriber
+     * function has returned is measured. Publishes exceeding the
+     * budget of the monitor are counted and reported by the monitor.
+     *
+     * May be called while other threads publish on the topic. The
+     * monitor is published with release semantics, publishers see
+     * it fully initialized.
+     *
+     * \param monitor
+     *      Monitor to use, nullptr disables the check. Must outlive
+     *      the topic. A monitor can be shared by multiple topics.
+     */
+    inline void
+    setDeadlineMonitor(DeadlineMonitor* monitor)
+    {
+        mDeadlineMonitor.store(monitor, std::memory_order_release);
+    }
+
 protected:
     /// List of all topics currently active.
     static TopicBase* listOfAllTopics;
 
 private:
+    /**
+     * Unpublish the subscription lists of all topics.
+     *
+     * Waits until no publisher uses the old lists anymore. Afterwards
+     * the subscriptions can be relinked safely.
+     */
     static void
     clearSubscriptions();
 
-    /// Used to protect the publish() method
-    mutable rtos::Mutex mMutex;
+    /**
+     * Make the lists build up in mPendingSubscriptions visible to
+     * the publishers.
+     *
+     * Subscriptions which have not been connected before receive the
+     * messages stored by latched topics first.
+     */
+    static void
+    publishSubscriptions();
 
-    /// Pointer to the list of subscriptions
-    Subscription* mSubscriptions;
+    /**
+     * Sort the lists build up in mPendingSubscriptions by descending
+     * priority.
+     *
+     * The sort is stable, subscriptions with the same priority keep
+     * their order. O(n log n) in the number of subscriptions per topic.
+     */
+    static void
+    sortPendingSubscriptions();
+
+    static Subscription*
+    sortByPriority(Subscription* head);
+
+    void
+    activatePendingSubscriptions();
+
+    /**
+     * Insert a single subscription in front of all subscriptions with
+     * the same or a lower priority.
+     *
+     * O(n) in the number of subscriptions of the topic, publishers may
+     * run concurrently. Latched topics replay the stored messages to
+     * the subscription first.
+     */
+    void
+    insertSubscription(Subscription* subscription);
+
+    void
+    linkSubscription(Subscription* subscription);
+
+    /**
+     * Find the insert position for a subscription with the given
+     * priority.
+     *
+     * \return  Subscription after which the new subscription has to
+     *          be inserted, nullptr to insert at the head of the list.
+     */
+    static Subscription*
+    findPredecessor(Subscription* head, uint8_t priority);
+
+    /**
+     * Unlink a single subscription from the list.
+     *
+     * O(1) plus one grace period, publishers may run concurrently.
+     * After the function returns no publisher accesses the
+     * subscription anymore.
+     */
+    void
+    removeSubscription(Subscription* subscription);
+
+    /// Serializes modifications of the list of subscriptions.
+    rtos::Mutex mMutex;
+
+    /// Tracks the publishers currently iterating over mSubscriptions.
+    ReadEpoch mEpoch;
+
+    /**
+     * Pointer to the list of subscriptions.
+     *
+     * Publishers only follow the forward links. Subscriptions are
+     * inserted fully initialized and unlinked subscriptions are only
+     * modified after a grace period has passed.
+     */
+    std::atomic<Subscription*> mSubscriptions;
+
+    /// List of subscriptions build by Subscription::connectSubscriptionsToTopics().
+    Subscription* mPendingSubscriptions;
+
+    /// Only set for latched topics, otherwise nullptr.
+    TopicLatch* const mLatch;
+
+    /// Optional check of the dispatch time, nullptr if disabled.
+    std::atomic<DeadlineMonitor*> mDeadlineMonitor;
+
+    /**
+     * Statistics of the instrumentation policy.
+     *
+     * Inherited instead of being a member, the empty statistics of the
+     * disabled policy then do not take any space.
+     */
+    inline const InstrumentationPolicy::TopicStatistics&
+    getStatistics() const
+    {
+        return *this;
+    }
 };
 
 /**
@@ -119,6 +278,8 @@ public:
     // Needed to allow up-casting in smpc::Subscription constructor
     friend class Subscription;
 
+    using TopicBase::setDeadlineMonitor;
+
     /// Type of the data distributed by this topic.
     typedef T Type;
     typedef typename outpost::remove_const<T>::type NonConstType;
@@ -133,6 +294,9 @@ public:
     /**
      * Destroy the topic.
      *
+     * Subscriptions still connected to the topic are disconnected.
+     * They must not be connected again afterwards.
+     *
      * \warning
      *      The destruction and creation of topics during the normal
      *      runtime is not thread-safe. If topics need to be
@@ -167,6 +331,33 @@ public:
         NonConstType* ptr = const_cast<NonConstType*>(&message);
         TopicBase::publishTypeUnsafe(reinterpret_cast<void*>(ptr));
     }
+
+    /**
+     * Publish a block of messages.
+     *
+     * Subscribers with a batched subscriber function receive the
+     * complete block with a single call. All other subscribers are
+     * called once for every message in the block.
+     *
+     * Cheaper than calling publish() for every message as the list of
+     * subscriptions is only entered once.
+     */
+    inline void
+    publishBatch(outpost::Slice<T> messages) const
+    {
+        if (messages.getNumberOfElements() > 0)
+        {
+            NonConstType* ptr = const_cast<NonConstType*>(messages.begin());
+            TopicBase::publishBatchTypeUnsafe(reinterpret_cast<void*>(ptr),
+                                              messages.getNumberOfElements(),
+                                              sizeof(T));
+        }
+    }
+
+protected:
+    inline explicit Topic(TopicLatch* latch) : TopicBase(latch)
+    {
+    }
 };
 
 }  // namespace smpc
@@ -21,24 +21,50 @@ outpost::smpc::TopicRaw* outpost::smpc::TopicRaw::listOfAllTopics = 0;
 
 outpost::smpc::TopicRaw::TopicRaw() :
     ImplicitList<TopicRaw>(listOfAllTopics, this),
-    mSubscriptions(0)
+    InstrumentationPolicy::TopicStatistics(),
+    mMutex(),
+    mEpoch(),
+    mSubscriptions(0),
+    mPendingSubscriptions(0)
 {
 }
 
 outpost::smpc::TopicRaw::~TopicRaw()
 {
     removeFromList(&TopicRaw::listOfAllTopics, this);
+
+    // Detach the remaining subscriptions, so that their destructors do not
+    // access the topic anymore.
+    SubscriptionRaw* subscription;
+    {
+        rtos::MutexGuard lock(mMutex);
+        subscription = mSubscriptions.load();
+        mSubscriptions.store(0);
+    }
+    mEpoch.synchronize();
+
+    while (subscription != 0)
+    {
+        SubscriptionRaw* next = subscription->mNextTopicSubscription.load();
+        subscription->mNextTopicSubscription.store(0);
+        subscription->mPreviousTopicSubscription = 0;
+        subscription->mConnected = false;
+        subscription = next;
+    }
 }
 
 void
 outpost::smpc::TopicRaw::publish(const void* message, size_t length)
 {
-    rtos::MutexGuard lock(mMutex);
+    ReadEpoch::Guard guard(mEpoch);
+    getStatistics().onPublish();
 
-    for (SubscriptionRaw* subscription = mSubscriptions; subscription != 0;
-         subscription = subscription->mNextTopicSubscription)
+    for (SubscriptionRaw* subscription = mSubscriptions.load(); subscription != 0;
+         subscription = subscription->mNextTopicSubscription.load())
     {
+        InstrumentationPolicy::Stopwatch stopwatch;
         subscription->execute(message, length);
+        subscription->getStatistics().onCallbackFinished(stopwatch);
     }
 }
 
@@ -47,6 +73,72 @@ outpost::smpc::TopicRaw::clearSubscriptions()
 {
     for (TopicRaw* it = listOfAllTopics; it != 0; it = it->getNext())
     {
-        it->mSubscriptions = 0;
+        it->mSubscriptions.store(0);
+        it->mPendingSubscriptions = 0;
     }
+
+    for (TopicRaw* it = listOfAllTopics; it != 0; it = it->getNext())
+    {
+        it->mEpoch.synchronize();
+    }
+}
+
+void
+outpost::smpc::TopicRaw::publishSubscriptions()
+{
+    for (TopicRaw* it = listOfAllTopics; it != 0; it = it->getNext())
+    {
+        it->mSubscriptions.store(it->mPendingSubscriptions);
+    }
+}
+
+void
+outpost::smpc::TopicRaw::insertSubscription(SubscriptionRaw* subscription)
+{
+    InstrumentationPolicy::Stopwatch stopwatch;
+    rtos::MutexGuard lock(mMutex);
+    getStatistics().onConnectLockAcquired(stopwatch);
+
+    SubscriptionRaw* head = mSubscriptions.load();
+    subscription->mPreviousTopicSubscription = 0;
+    subscription->mNextTopicSubscription.store(head);
+    if (head != 0)
+    {
+        head->mPreviousTopicSubscription = subscription;
+    }
+
+    mSubscriptions.store(subscription);
+}
+
+void
+outpost::smpc::TopicRaw::removeSubscription(SubscriptionRaw* subscription)
+{
+    {
+        InstrumentationPolicy::Stopwatch stopwatch;
+        rtos::MutexGuard lock(mMutex);
+        getStatistics().onConnectLockAcquired(stopwatch);
+
+        SubscriptionRaw* previous = subscription->mPreviousTopicSubscription;
+        SubscriptionRaw* next = subscription->mNextTopicSubscription.load();
+        if (previous != 0)
+        {
+            previous->mNextTopicSubscription.store(next);
+        }
+        else
+        {
+            mSubscriptions.store(next);
+        }
+
+        if (next != 0)
+        {
+            next->mPreviousTopicSubscription = previous;
+        }
+    }
+
+    // Wait for publishers still executing the removed subscription. The
+    // mutex is released before, see TopicBase::removeSubscription().
+    mEpoch.synchronize();
+
+    subscription->mNextTopicSubscription.store(0);
+    subscription->mPreviousTopicSubscription = 0;
 }
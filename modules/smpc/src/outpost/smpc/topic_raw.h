@@ -14,6 +14,9 @@
 #ifndef OUTPOST_SMPC_TOPIC_RAW_H
 #define OUTPOST_SMPC_TOPIC_RAW_H
 
+#include "instrumentation.h"
+#include "read_epoch.h"
+
 #include <outpost/rtos/mutex.h>
 #include <outpost/utils/container/implicit_list.h>
 #include <outpost/utils/meta.h>
@@ -21,6 +24,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <atomic>
+
 namespace outpost
 {
 namespace smpc
@@ -44,13 +49,15 @@ class SubscriptionRaw;
  * \ingroup smpc
  * \author  Fabian Greif
  */
-class TopicRaw : protected ImplicitList<TopicRaw>
+class TopicRaw : protected ImplicitList<TopicRaw>,
+                 private InstrumentationPolicy::TopicStatistics
 {
 public:
     // Needed to allow SubscriptionRaw() to append itself to the
     // subscription list
     friend class SubscriptionRaw;
     friend class ImplicitList<TopicRaw>;
+    friend class StatisticsRegistry;
 
     /**
      * Create a new raw topic.
@@ -60,6 +67,9 @@ public:
     /**
      * Destroy the topic.
      *
+     * Subscriptions still connected to the topic are disconnected.
+     * They must not be connected again afterwards.
+     *
      * \warning
      *         The destruction and creation of topics during the normal
      *         runtime is not thread-safe. If topics need to be
@@ -72,7 +82,8 @@ public:
     /**
      * Publish new data.
      *
-     * Forwards the pointer to all connected subscribers.
+     * Forwards the pointer to all connected subscribers. This
+     * function is thread safe and lock-free.
      */
     void
     publish(const void* message, size_t length);
@@ -85,17 +96,59 @@ private:
     TopicRaw&
     operator=(const TopicRaw&);
 
+    /**
+     * Unpublish the subscription lists of all topics and wait until
+     * no publisher uses them anymore.
+     */
     static void
     clearSubscriptions();
 
+    /**
+     * Make the lists build up in mPendingSubscriptions visible to
+     * the publishers.
+     */
+    static void
+    publishSubscriptions();
+
+    /**
+     * Insert a single subscription at the head of the list (O(1)).
+     */
+    void
+    insertSubscription(SubscriptionRaw* subscription);
+
+    /**
+     * Unlink a single subscription from the list (O(1)) and wait
+     * until no publisher accesses it anymore.
+     */
+    void
+    removeSubscription(SubscriptionRaw* subscription);
+
     /// List of all raw topics currently active.
     static TopicRaw* listOfAllTopics;
 
-    /// Mutex used to protect the publish() method.
+    /// Serializes modifications of the list of subscriptions.
     rtos::Mutex mMutex;
 
+    /// Tracks the publishers currently iterating over mSubscriptions.
+    ReadEpoch mEpoch;
+
     /// Pointer to the list of mSubscriptions
-    SubscriptionRaw* mSubscriptions;
+    std::atomic<SubscriptionRaw*> mSubscriptions;
+
+    /// List of subscriptions build by SubscriptionRaw::connectSubscriptionsToTopics().
+    SubscriptionRaw* mPendingSubscriptions;
+
+    /**
+     * Statistics of the instrumentation policy.
+     *
+     * Inherited instead of being a member, the empty statistics of the
+     * disabled policy then do not take any space.
+     */
+    inline const InstrumentationPolicy::TopicStatistics&
+    getStatistics() const
+    {
+        return *this;
+    }
 };
 
 }  // namespace smpc
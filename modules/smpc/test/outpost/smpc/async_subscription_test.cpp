@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/async_dispatcher.h>
+#include <outpost/smpc/async_subscription.h>
+#include <outpost/smpc/topic.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+class Recorder : public Subscriber
+{
+public:
+    void
+    onReceive(const uint32_t* value)
+    {
+        mValues.push_back(*value);
+    }
+
+    std::vector<uint32_t> mValues;
+};
+
+/// Blocks in the subscriber function until released by the test.
+class BlockingRecorder : public Subscriber
+{
+public:
+    BlockingRecorder() : mEntered(false), mRelease(false), mReturned(false)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        mEntered.store(true);
+        while (!mRelease.load())
+        {
+            std::this_thread::yield();
+        }
+        mReturned.store(true);
+    }
+
+    std::atomic<bool> mEntered;
+    std::atomic<bool> mRelease;
+    std::atomic<bool> mReturned;
+};
+
+class AsyncSubscriptionTest : public testing::Test
+{
+public:
+    AsyncSubscriptionTest() : mDispatcher(0)
+    {
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    /// Deliver all queued messages from the test thread.
+    size_t
+    dispatchAll()
+    {
+        size_t count = 0;
+        while (mDispatcher.dispatchSingle(outpost::time::Duration::zero()))
+        {
+            count++;
+        }
+        return count;
+    }
+
+    Topic<const uint32_t> mTopic;
+    Recorder mRecorder;
+    AsyncDispatcher mDispatcher;
+};
+}  // namespace
+
+TEST_F(AsyncSubscriptionTest, shouldDeliverMessagesFromDispatcher)
+{
+    AsyncSubscription<const uint32_t, 4> subscription(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publish(1);
+    mTopic.publish(2);
+
+    EXPECT_TRUE(mRecorder.mValues.empty());
+    EXPECT_EQ(2U, subscription.getNumberOfQueuedMessages());
+
+    EXPECT_EQ(2U, dispatchAll());
+    ASSERT_EQ(2U, mRecorder.mValues.size());
+    EXPECT_EQ(1U, mRecorder.mValues[0]);
+    EXPECT_EQ(2U, mRecorder.mValues[1]);
+    EXPECT_EQ(0U, subscription.getNumberOfQueuedMessages());
+    EXPECT_EQ(0U, subscription.getNumberOfDroppedMessages());
+}
+
+TEST_F(AsyncSubscriptionTest, shouldDropNewestMessagesWhenFull)
+{
+    AsyncSubscription<const uint32_t, 2> subscription(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive, OverflowPolicy::dropNewest);
+    Subscription::connectSubscriptionsToTopics();
+
+    for (uint32_t i = 1; i <= 5; ++i)
+    {
+        mTopic.publish(i);
+    }
+
+    EXPECT_EQ(3U, subscription.getNumberOfDroppedMessages());
+    EXPECT_EQ(2U, dispatchAll());
+    ASSERT_EQ(2U, mRecorder.mValues.size());
+    EXPECT_EQ(1U, mRecorder.mValues[0]);
+    EXPECT_EQ(2U, mRecorder.mValues[1]);
+
+    subscription.resetDroppedMessages();
+    EXPECT_EQ(0U, subscription.getNumberOfDroppedMessages());
+}
+
+TEST_F(AsyncSubscriptionTest, shouldDropOldestMessagesWhenFull)
+{
+    AsyncSubscription<const uint32_t, 2> subscription(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive, OverflowPolicy::dropOldest);
+    Subscription::connectSubscriptionsToTopics();
+
+    for (uint32_t i = 1; i <= 5; ++i)
+    {
+        mTopic.publish(i);
+    }
+
+    EXPECT_EQ(3U, subscription.getNumberOfDroppedMessages());
+    EXPECT_EQ(2U, dispatchAll());
+    ASSERT_EQ(2U, mRecorder.mValues.size());
+    EXPECT_EQ(4U, mRecorder.mValues[0]);
+    EXPECT_EQ(5U, mRecorder.mValues[1]);
+}
+
+TEST_F(AsyncSubscriptionTest, shouldServeSubscriptionsRoundRobin)
+{
+    Recorder other;
+    AsyncSubscription<const uint32_t, 8> subscription1(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive);
+
+    Topic<const uint32_t> otherTopic;
+    AsyncSubscription<const uint32_t, 8> subscription2(
+            otherTopic, mDispatcher, &other, &Recorder::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        mTopic.publish(i);
+    }
+    otherTopic.publish(100);
+
+    // The single message of the second topic must not wait for the
+    // complete queue of the first topic.
+    EXPECT_TRUE(mDispatcher.dispatchSingle(outpost::time::Duration::zero()));
+    EXPECT_TRUE(mDispatcher.dispatchSingle(outpost::time::Duration::zero()));
+    EXPECT_EQ(1U, mRecorder.mValues.size());
+    EXPECT_EQ(1U, other.mValues.size());
+
+    EXPECT_EQ(3U, dispatchAll());
+    EXPECT_EQ(4U, mRecorder.mValues.size());
+}
+
+TEST_F(AsyncSubscriptionTest, shouldNotDeliverAfterDestruction)
+{
+    {
+        AsyncSubscription<const uint32_t, 4> subscription(
+                mTopic, mDispatcher, &mRecorder, &Recorder::onReceive);
+        subscription.connect();
+        EXPECT_TRUE(subscription.isConnected());
+
+        mTopic.publish(1);
+    }
+
+    mTopic.publish(2);
+    EXPECT_EQ(0U, dispatchAll());
+    EXPECT_TRUE(mRecorder.mValues.empty());
+}
+
+TEST_F(AsyncSubscriptionTest, shouldBlockPublisherWhenFull)
+{
+    static const uint32_t numberOfMessages = 1000;
+
+    AsyncSubscription<const uint32_t, 4> subscription(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive, OverflowPolicy::block);
+    Subscription::connectSubscriptionsToTopics();
+
+    std::thread publisher([this]() {
+        for (uint32_t i = 0; i < numberOfMessages; ++i)
+        {
+            mTopic.publish(i);
+        }
+    });
+
+    for (uint32_t i = 0; i < numberOfMessages; ++i)
+    {
+        ASSERT_TRUE(mDispatcher.dispatchSingle(outpost::time::Seconds(5)));
+        EXPECT_LE(subscription.getNumberOfQueuedMessages(), 4U);
+    }
+    publisher.join();
+
+    ASSERT_EQ(numberOfMessages, mRecorder.mValues.size());
+    for (uint32_t i = 0; i < numberOfMessages; ++i)
+    {
+        EXPECT_EQ(i, mRecorder.mValues[i]);
+    }
+    EXPECT_EQ(0U, subscription.getNumberOfDroppedMessages());
+}
+
+TEST_F(AsyncSubscriptionTest, shouldDeliverWhilePublishing)
+{
+    static const uint32_t numberOfMessages = 1000;
+
+    AsyncSubscription<const uint32_t, 16> subscription(
+            mTopic, mDispatcher, &mRecorder, &Recorder::onReceive, OverflowPolicy::dropNewest);
+    Subscription::connectSubscriptionsToTopics();
+
+    std::atomic<bool> running(true);
+    std::thread dispatcher([this, &running]() {
+        while (running.load())
+        {
+            mDispatcher.dispatchSingle(outpost::time::Milliseconds(1));
+        }
+    });
+
+    for (uint32_t i = 0; i < numberOfMessages; ++i)
+    {
+        mTopic.publish(i);
+    }
+
+    for (int i = 0; (i < 5000) && (subscription.getNumberOfQueuedMessages() > 0); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    running.store(false);
+    dispatcher.join();
+
+    // Every message was either delivered in order or counted as dropped
+    EXPECT_EQ(numberOfMessages,
+              mRecorder.mValues.size() + subscription.getNumberOfDroppedMessages());
+    for (size_t i = 1; i < mRecorder.mValues.size(); ++i)
+    {
+        EXPECT_LT(mRecorder.mValues[i - 1], mRecorder.mValues[i]);
+    }
+}
+
+TEST_F(AsyncSubscriptionTest, shouldNotHoldDispatcherWhileExecutingSubscriber)
+{
+    BlockingRecorder blocking;
+    std::unique_ptr<AsyncSubscription<const uint32_t, 4>> subscription(
+            new AsyncSubscription<const uint32_t, 4>(
+                    mTopic, mDispatcher, &blocking, &BlockingRecorder::onReceive));
+    subscription->connect();
+    mTopic.publish(1);
+
+    std::thread dispatcher([this]() { dispatchAll(); });
+    while (!blocking.mEntered.load())
+    {
+        std::this_thread::yield();
+    }
+
+    // Adding and removing other subscriptions is possible while the
+    // subscriber function is executed.
+    {
+        AsyncSubscription<const uint32_t, 4> other(
+                mTopic, mDispatcher, &mRecorder, &Recorder::onReceive);
+        other.connect();
+        mTopic.publish(2);
+    }
+
+    // The destruction has to wait for the subscriber function to return
+    std::atomic<bool> destroyed(false);
+    std::thread destroyer([&subscription, &destroyed]() {
+        subscription.reset();
+        destroyed.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(destroyed.load());
+
+    blocking.mRelease.store(true);
+    destroyer.join();
+    dispatcher.join();
+
+    EXPECT_TRUE(blocking.mReturned.load());
+    EXPECT_TRUE(destroyed.load());
+    EXPECT_TRUE(mRecorder.mValues.empty());
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Topics and subscriptions compiled with the instrumentation enabled.
+ *
+ * The policy changes the layout of the topics and subscriptions. This
+ * file is therefore only compiled into the separate runner
+ * 'runner_instrumentation' which builds the module with
+ * OUTPOST_SMPC_INSTRUMENTATION defined (see SConstruct). In the default
+ * runner it is empty.
+ */
+
+#ifdef OUTPOST_SMPC_INSTRUMENTATION
+
+#include <outpost/smpc/instrumentation.h>
+#include <outpost/smpc/statistics_registry.h>
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/subscription_raw.h>
+#include <outpost/smpc/topic.h>
+#include <outpost/smpc/topic_raw.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+#include <unittest/smpc/testing_subscription_raw.h>
+#include <unittest/time/testing_clock.h>
+
+#include <stdint.h>
+
+using namespace outpost::smpc;
+using outpost::time::Duration;
+using outpost::time::Microseconds;
+
+static_assert(InstrumentationPolicy::enabled, "Instrumentation must be enabled");
+
+namespace
+{
+// Must outlive all topics, the clock is never unregistered.
+unittest::time::TestingClock testingClock;
+
+class SlowSubscriber : public Subscriber
+{
+public:
+    explicit SlowSubscriber(Duration duration) : mDuration(duration)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        testingClock.incrementBy(mDuration);
+    }
+
+    void
+    onReceiveRaw(const void*, size_t)
+    {
+        testingClock.incrementBy(mDuration);
+    }
+
+    Duration mDuration;
+};
+
+class Collector : public StatisticsRegistry::Visitor
+{
+public:
+    Collector() :
+        mPublishes(0),
+        mCalls(0),
+        mHistogram(nullptr),
+        mRawPublishes(0),
+        mRawCalls(0),
+        mRawHistogram(nullptr)
+    {
+    }
+
+    virtual void
+    visitTopic(const TopicBase&, const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        mPublishes += statistics.getNumberOfPublishes();
+    }
+
+    virtual void
+    visitSubscription(const Subscription&,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        mCalls += statistics.getNumberOfCalls();
+        mHistogram = statistics.getCallbackDurations();
+    }
+
+    virtual void
+    visitTopic(const TopicRaw&, const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        mRawPublishes += statistics.getNumberOfPublishes();
+    }
+
+    virtual void
+    visitSubscription(const SubscriptionRaw&,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        mRawCalls += statistics.getNumberOfCalls();
+        mRawHistogram = statistics.getCallbackDurations();
+    }
+
+    uint32_t mPublishes;
+    uint32_t mCalls;
+    const DurationHistogram* mHistogram;
+    uint32_t mRawPublishes;
+    uint32_t mRawCalls;
+    const DurationHistogram* mRawHistogram;
+};
+
+class InstrumentationEnabledTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        InstrumentationPolicy::setClock(testingClock);
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+        unittest::smpc::TestingSubscriptionRaw::releaseAllSubscriptions();
+    }
+};
+}  // namespace
+
+TEST_F(InstrumentationEnabledTest, shouldCountPublishesAndCalls)
+{
+    Topic<const uint32_t> topic;
+    SlowSubscriber subscriber(Microseconds(100));
+    Subscription subscription(topic, &subscriber, &SlowSubscriber::onReceive);
+
+    Subscription::connectSubscriptionsToTopics();
+    StatisticsRegistry::reset();
+
+    topic.publish(1);
+    topic.publish(2);
+    topic.publish(3);
+
+    Collector collector;
+    StatisticsRegistry::walk(collector);
+
+    EXPECT_EQ(3U, collector.mPublishes);
+    EXPECT_EQ(3U, collector.mCalls);
+    ASSERT_TRUE(collector.mHistogram != nullptr);
+    // 100us are sorted into the [64, 128) bin
+    EXPECT_EQ(3U, collector.mHistogram->getCount(7));
+    EXPECT_EQ(Microseconds(100), collector.mHistogram->getMaximum());
+}
+
+TEST_F(InstrumentationEnabledTest, shouldCountRawPublishesAndCalls)
+{
+    TopicRaw topic;
+    SlowSubscriber subscriber(Microseconds(20));
+    SubscriptionRaw subscription(topic, &subscriber, &SlowSubscriber::onReceiveRaw);
+
+    SubscriptionRaw::connectSubscriptionsToTopics();
+    StatisticsRegistry::reset();
+
+    topic.publish(nullptr, 0);
+    topic.publish(nullptr, 0);
+
+    Collector collector;
+    StatisticsRegistry::walk(collector);
+
+    EXPECT_EQ(2U, collector.mRawPublishes);
+    EXPECT_EQ(2U, collector.mRawCalls);
+    ASSERT_TRUE(collector.mRawHistogram != nullptr);
+    // 20us are sorted into the [16, 32) bin
+    EXPECT_EQ(2U, collector.mRawHistogram->getCount(5));
+}
+
+TEST_F(InstrumentationEnabledTest, shouldResetCounters)
+{
+    Topic<const uint32_t> topic;
+    SlowSubscriber subscriber(Microseconds(1));
+    Subscription subscription(topic, &subscriber, &SlowSubscriber::onReceive);
+
+    subscription.connect();
+    topic.publish(1);
+    StatisticsRegistry::reset();
+
+    Collector collector;
+    StatisticsRegistry::walk(collector);
+
+    EXPECT_EQ(0U, collector.mPublishes);
+    EXPECT_EQ(0U, collector.mCalls);
+    ASSERT_TRUE(collector.mHistogram != nullptr);
+    EXPECT_EQ(0U, collector.mHistogram->getNumberOfSamples());
+}
+
+#endif
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/instrumentation.h>
+#include <outpost/smpc/statistics_registry.h>
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/subscription_raw.h>
+#include <outpost/smpc/topic.h>
+#include <outpost/smpc/topic_raw.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+#include <unittest/smpc/testing_subscription_raw.h>
+#include <unittest/time/testing_clock.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <type_traits>
+
+using namespace outpost::smpc;
+using outpost::time::Duration;
+using outpost::time::Microseconds;
+
+namespace
+{
+// Must outlive all topics, the clock is never unregistered.
+unittest::time::TestingClock testingClock;
+
+class SlowSubscriber : public Subscriber
+{
+public:
+    explicit SlowSubscriber(Duration duration) : mDuration(duration)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        testingClock.incrementBy(mDuration);
+    }
+
+    void
+    onReceiveRaw(const void*, size_t)
+    {
+        testingClock.incrementBy(mDuration);
+    }
+
+    Duration mDuration;
+};
+
+class Collector : public StatisticsRegistry::Visitor
+{
+public:
+    Collector(const void* topic, const Subscription* subscription) :
+        mTopic(topic),
+        mSubscription(subscription),
+        mPublishes(0),
+        mCalls(0),
+        mHistogram(nullptr),
+        mRawTopics(0)
+    {
+    }
+
+    virtual void
+    visitTopic(const TopicBase& topic, const StatisticsRegistry::TopicStatistics& statistics)
+    {
+        if (static_cast<const void*>(&topic) == mTopic)
+        {
+            mPublishes = statistics.getNumberOfPublishes();
+        }
+    }
+
+    virtual void
+    visitSubscription(const Subscription& subscription,
+                      const StatisticsRegistry::SubscriptionStatistics& statistics)
+    {
+        if (&subscription == mSubscription)
+        {
+            mCalls = statistics.getNumberOfCalls();
+            mHistogram = statistics.getCallbackDurations();
+        }
+    }
+
+    virtual void
+    visitTopic(const TopicRaw&, const StatisticsRegistry::TopicStatistics&)
+    {
+        mRawTopics++;
+    }
+
+    virtual void
+    visitSubscription(const SubscriptionRaw&, const StatisticsRegistry::SubscriptionStatistics&)
+    {
+    }
+
+    const void* mTopic;
+    const Subscription* mSubscription;
+    uint32_t mPublishes;
+    uint32_t mCalls;
+    const DurationHistogram* mHistogram;
+    size_t mRawTopics;
+};
+
+// Data members of the topics and subscriptions without the statistics,
+// has to be kept in sync with the classes.
+struct TopicBaseLayout : outpost::ImplicitList<TopicBaseLayout>
+{
+    outpost::rtos::Mutex mMutex;
+    ReadEpoch mEpoch;
+    std::atomic<Subscription*> mSubscriptions;
+    Subscription* mPendingSubscriptions;
+    TopicLatch* const mLatch;
+    std::atomic<DeadlineMonitor*> mDeadlineMonitor;
+};
+
+struct TopicRawLayout : outpost::ImplicitList<TopicRawLayout>
+{
+    outpost::rtos::Mutex mMutex;
+    ReadEpoch mEpoch;
+    std::atomic<SubscriptionRaw*> mSubscriptions;
+    SubscriptionRaw* mPendingSubscriptions;
+};
+
+struct SubscriptionLayout : outpost::ImplicitList<SubscriptionLayout>
+{
+    TopicBase* const mTopic;
+    std::atomic<Subscription*> mNextTopicSubscription;
+    Subscription* mPreviousTopicSubscription;
+    bool mConnected;
+    uint8_t mPriority;
+    const outpost::Functor1<void(void*)> mFunctor;
+    const MessageFilterBase* const mFilter;
+    void (*const mBatchDispatcher)();
+    Subscriber* const mBatchSubscriber;
+    void (Subscriber::*mBatchFunction)(void*);
+};
+
+struct SubscriptionRawLayout : outpost::ImplicitList<SubscriptionRawLayout>,
+                               outpost::Functor2<void(const void* message, size_t length)>
+{
+    TopicRaw* const mTopic;
+    std::atomic<SubscriptionRaw*> mNextTopicSubscription;
+    SubscriptionRaw* mPreviousTopicSubscription;
+    bool mConnected;
+};
+}  // namespace
+
+#ifndef OUTPOST_SMPC_INSTRUMENTATION
+// Without instrumentation the statistics must not add to the size of
+// the topics and subscriptions.
+static_assert(std::is_empty<InstrumentationPolicy::TopicStatistics>::value,
+              "Disabled topic statistics must be empty");
+static_assert(std::is_empty<InstrumentationPolicy::SubscriptionStatistics>::value,
+              "Disabled subscription statistics must be empty");
+static_assert(sizeof(TopicBase) == sizeof(TopicBaseLayout), "Statistics enlarge TopicBase");
+static_assert(sizeof(TopicRaw) == sizeof(TopicRawLayout), "Statistics enlarge TopicRaw");
+static_assert(sizeof(Subscription) == sizeof(SubscriptionLayout),
+              "Statistics enlarge Subscription");
+static_assert(sizeof(SubscriptionRaw) == sizeof(SubscriptionRawLayout),
+              "Statistics enlarge SubscriptionRaw");
+#endif
+
+TEST(DurationHistogramTest, shouldSortDurationsIntoLogarithmicBins)
+{
+    DurationHistogram histogram;
+
+    histogram.add(Duration::zero());
+    histogram.add(Microseconds(1));
+    histogram.add(Microseconds(3));
+    histogram.add(Microseconds(4));
+    histogram.add(Microseconds(1000));
+    histogram.add(outpost::time::Seconds(10));
+
+    EXPECT_EQ(1U, histogram.getCount(0));
+    EXPECT_EQ(1U, histogram.getCount(1));
+    EXPECT_EQ(1U, histogram.getCount(2));
+    EXPECT_EQ(1U, histogram.getCount(3));
+    EXPECT_EQ(1U, histogram.getCount(10));
+    EXPECT_EQ(1U, histogram.getCount(DurationHistogram::numberOfBins - 1));
+    EXPECT_EQ(6U, histogram.getNumberOfSamples());
+    EXPECT_EQ(outpost::time::Seconds(10), histogram.getMaximum());
+
+    histogram.reset();
+    EXPECT_EQ(0U, histogram.getNumberOfSamples());
+    EXPECT_EQ(Duration::zero(), histogram.getMaximum());
+}
+
+TEST(DurationHistogramTest, upperLimitMatchesBins)
+{
+    EXPECT_EQ(Microseconds(1), DurationHistogram::getUpperLimit(0));
+    EXPECT_EQ(Microseconds(1024), DurationHistogram::getUpperLimit(10));
+    EXPECT_EQ(Duration::maximum(),
+              DurationHistogram::getUpperLimit(DurationHistogram::numberOfBins - 1));
+}
+
+TEST(InstrumentationTest, enabledPolicyMeasuresWithClock)
+{
+    instrumentation::Enabled::setClock(testingClock);
+
+    instrumentation::Enabled::SubscriptionStatistics statistics;
+    {
+        instrumentation::Enabled::Stopwatch stopwatch;
+        testingClock.incrementBy(Microseconds(300));
+        statistics.onCallbackFinished(stopwatch);
+    }
+
+    EXPECT_EQ(1U, statistics.getNumberOfCalls());
+    EXPECT_EQ(1U, statistics.getCallbackDurations()->getCount(9));
+    EXPECT_EQ(Microseconds(300), statistics.getCallbackDurations()->getMaximum());
+
+    instrumentation::Enabled::TopicStatistics topicStatistics;
+    {
+        instrumentation::Enabled::Stopwatch stopwatch;
+        testingClock.incrementBy(Microseconds(20));
+        topicStatistics.onConnectLockAcquired(stopwatch);
+    }
+    topicStatistics.onPublish();
+    EXPECT_EQ(1U, topicStatistics.getNumberOfPublishes());
+    EXPECT_EQ(Microseconds(20), topicStatistics.getMaximumConnectWait());
+
+    topicStatistics.reset();
+    statistics.reset();
+    EXPECT_EQ(0U, topicStatistics.getNumberOfPublishes());
+    EXPECT_EQ(0U, statistics.getNumberOfCalls());
+}
+
+TEST(InstrumentationTest, registryReportsTopicStatistics)
+{
+    InstrumentationPolicy::setClock(testingClock);
+
+    Topic<const uint32_t> topic;
+    SlowSubscriber subscriber(Microseconds(100));
+    Subscription subscription(topic, &subscriber, &SlowSubscriber::onReceive);
+
+    TopicRaw rawTopic;
+    SubscriptionRaw rawSubscription(rawTopic, &subscriber, &SlowSubscriber::onReceiveRaw);
+
+    Subscription::connectSubscriptionsToTopics();
+    SubscriptionRaw::connectSubscriptionsToTopics();
+    StatisticsRegistry::reset();
+
+    topic.publish(1);
+    topic.publish(2);
+    rawTopic.publish(nullptr, 0);
+
+    Collector collector(&topic, &subscription);
+    StatisticsRegistry::walk(collector);
+    EXPECT_LE(1U, collector.mRawTopics);
+
+    if (InstrumentationPolicy::enabled)
+    {
+        EXPECT_EQ(2U, collector.mPublishes);
+        EXPECT_EQ(2U, collector.mCalls);
+        ASSERT_TRUE(collector.mHistogram != nullptr);
+        // 100us are sorted into the [64, 128) bin
+        EXPECT_EQ(2U, collector.mHistogram->getCount(7));
+    }
+    else
+    {
+        EXPECT_EQ(0U, collector.mPublishes);
+        EXPECT_EQ(0U, collector.mCalls);
+        EXPECT_TRUE(collector.mHistogram == nullptr);
+    }
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    unittest::smpc::TestingSubscriptionRaw::releaseAllSubscriptions();
+}
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/keyed_topic.h>
+#include <outpost/smpc/message_filter.h>
+#include <outpost/smpc/subscription.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+struct Packet
+{
+    uint16_t apid;
+    uint32_t sequenceCount;
+};
+
+uint16_t
+getApid(const Packet& packet)
+{
+    return packet.apid;
+}
+
+class PacketReceiver : public Subscriber
+{
+public:
+    PacketReceiver() : mReceived(0)
+    {
+    }
+
+    void
+    onPacket(const Packet* packet)
+    {
+        mReceived++;
+        mSequenceCounts.push_back(packet->sequenceCount);
+    }
+
+    size_t mReceived;
+    std::vector<uint32_t> mSequenceCounts;
+};
+
+class EvenSequenceCount : public MessageFilter<Packet>
+{
+public:
+    virtual bool
+    matches(const Packet& packet) const override
+    {
+        return (packet.sequenceCount % 2) == 0;
+    }
+};
+
+class KeyedTopicTest : public testing::Test
+{
+public:
+    KeyedTopicTest() : mTopic(&getApid)
+    {
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    void
+    publish(uint16_t apid, uint32_t sequenceCount)
+    {
+        Packet packet = {apid, sequenceCount};
+        mTopic.publish(packet);
+    }
+
+    KeyedTopic<const Packet, uint16_t, 4> mTopic;
+};
+}  // namespace
+
+TEST(MessageFilterTest, shouldOnlyForwardMatchingMessages)
+{
+    Topic<const Packet> topic;
+    PacketReceiver all;
+    PacketReceiver even;
+    EvenSequenceCount filter;
+
+    Subscription subscription1(topic, &all, &PacketReceiver::onPacket);
+    Subscription subscription2(topic, &even, &PacketReceiver::onPacket, filter);
+    Subscription::connectSubscriptionsToTopics();
+
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        Packet packet = {1, i};
+        topic.publish(packet);
+    }
+
+    EXPECT_EQ(6U, all.mReceived);
+    ASSERT_EQ(3U, even.mReceived);
+    EXPECT_EQ(0U, even.mSequenceCounts[0]);
+    EXPECT_EQ(2U, even.mSequenceCounts[1]);
+    EXPECT_EQ(4U, even.mSequenceCounts[2]);
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST(MessageFilterTest, shouldFilterBatches)
+{
+    Topic<const Packet> topic;
+    PacketReceiver even;
+    EvenSequenceCount filter;
+
+    Subscription subscription(topic, &even, &PacketReceiver::onPacket, filter);
+    Subscription::connectSubscriptionsToTopics();
+
+    Packet packets[5] = {{1, 0}, {1, 1}, {1, 2}, {1, 3}, {1, 4}};
+    topic.publishBatch(outpost::asSlice(packets));
+
+    EXPECT_EQ(3U, even.mReceived);
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST_F(KeyedTopicTest, shouldOnlyCallMatchingKeys)
+{
+    PacketReceiver housekeeping;
+    PacketReceiver science;
+    KeyedSubscription<const Packet, uint16_t> subscription1(
+            mTopic, 0x10, &housekeeping, &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription2(
+            mTopic, 0x20, &science, &PacketReceiver::onPacket);
+
+    EXPECT_TRUE(subscription1.isConnected());
+    EXPECT_TRUE(subscription2.isConnected());
+    EXPECT_EQ(2U, mTopic.getNumberOfKeys());
+
+    publish(0x20, 1);
+    publish(0x10, 2);
+    publish(0x30, 3);
+    publish(0x20, 4);
+
+    EXPECT_EQ(1U, housekeeping.mReceived);
+    ASSERT_EQ(2U, science.mReceived);
+    EXPECT_EQ(1U, science.mSequenceCounts[0]);
+    EXPECT_EQ(4U, science.mSequenceCounts[1]);
+}
+
+TEST_F(KeyedTopicTest, shouldCallAllSubscriptionsOfAKey)
+{
+    PacketReceiver receivers[3];
+    KeyedSubscription<const Packet, uint16_t> subscription1(
+            mTopic, 7, &receivers[0], &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription2(
+            mTopic, 7, &receivers[1], &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription3(
+            mTopic, 7, &receivers[2], &PacketReceiver::onPacket);
+
+    EXPECT_EQ(1U, mTopic.getNumberOfKeys());
+
+    publish(7, 1);
+    for (auto& receiver : receivers)
+    {
+        EXPECT_EQ(1U, receiver.mReceived);
+    }
+
+    // Remove from the middle of the list
+    subscription2.disconnect();
+    publish(7, 2);
+    EXPECT_EQ(2U, receivers[0].mReceived);
+    EXPECT_EQ(1U, receivers[1].mReceived);
+    EXPECT_EQ(2U, receivers[2].mReceived);
+}
+
+TEST_F(KeyedTopicTest, shouldRemoveKeyWithoutSubscriptions)
+{
+    PacketReceiver receiver;
+    {
+        KeyedSubscription<const Packet, uint16_t> subscription(
+                mTopic, 3, &receiver, &PacketReceiver::onPacket);
+        EXPECT_EQ(1U, mTopic.getNumberOfKeys());
+    }
+    EXPECT_EQ(0U, mTopic.getNumberOfKeys());
+
+    publish(3, 1);
+    EXPECT_EQ(0U, receiver.mReceived);
+}
+
+TEST_F(KeyedTopicTest, shouldRejectKeysIfIndexIsFull)
+{
+    PacketReceiver receiver;
+    KeyedSubscription<const Packet, uint16_t> subscription1(
+            mTopic, 4, &receiver, &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription2(
+            mTopic, 1, &receiver, &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription3(
+            mTopic, 3, &receiver, &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription4(
+            mTopic, 2, &receiver, &PacketReceiver::onPacket);
+    KeyedSubscription<const Packet, uint16_t> subscription5(
+            mTopic, 5, &receiver, &PacketReceiver::onPacket);
+
+    EXPECT_FALSE(subscription5.isConnected());
+    EXPECT_EQ(4U, mTopic.getNumberOfKeys());
+
+    // An additional subscription for an existing key is possible
+    KeyedSubscription<const Packet, uint16_t> subscription6(
+            mTopic, 2, &receiver, &PacketReceiver::onPacket);
+    EXPECT_TRUE(subscription6.isConnected());
+
+    for (uint16_t apid = 1; apid <= 5; ++apid)
+    {
+        publish(apid, apid);
+    }
+    EXPECT_EQ(5U, receiver.mReceived);
+
+    subscription1.disconnect();
+    EXPECT_TRUE(subscription5.connect());
+}
+
+TEST_F(KeyedTopicTest, normalSubscriptionsReceiveAllMessages)
+{
+    PacketReceiver keyed;
+    PacketReceiver all;
+    KeyedSubscription<const Packet, uint16_t> subscription1(
+            mTopic, 1, &keyed, &PacketReceiver::onPacket);
+    Subscription subscription2(mTopic, &all, &PacketReceiver::onPacket);
+    Subscription::connectSubscriptionsToTopics();
+
+    Packet packets[3] = {{1, 0}, {2, 1}, {1, 2}};
+    mTopic.publishBatch(outpost::asSlice(packets));
+
+    EXPECT_EQ(2U, keyed.mReceived);
+    EXPECT_EQ(3U, all.mReceived);
+}
+
+TEST_F(KeyedTopicTest, subscribeWhilePublishing)
+{
+    class Counter : public Subscriber
+    {
+    public:
+        Counter() : mReceived(0)
+        {
+        }
+
+        void
+        onPacket(const Packet*)
+        {
+            mReceived.fetch_add(1);
+        }
+
+        std::atomic<uint32_t> mReceived;
+    };
+
+    Counter permanent;
+    KeyedSubscription<const Packet, uint16_t> subscription(
+            mTopic, 1, &permanent, &Counter::onPacket);
+
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> published(0);
+    std::thread publisher([&]() {
+        while (running.load())
+        {
+            Packet packet = {1, 0};
+            mTopic.publish(packet);
+            published.fetch_add(1);
+        }
+    });
+
+    for (int i = 0; i < 100; ++i)
+    {
+        Counter temporary;
+        KeyedSubscription<const Packet, uint16_t> shortLived(
+                mTopic, static_cast<uint16_t>(i % 3), &temporary, &Counter::onPacket);
+    }
+
+    running.store(false);
+    publisher.join();
+
+    EXPECT_EQ(published.load(), permanent.mReceived.load());
+}
+
+TEST_F(KeyedTopicTest, subscribeFromMultipleThreadsWhilePublishing)
+{
+    static const size_t numberOfWriters = 3;
+
+    class Counter : public Subscriber
+    {
+    public:
+        Counter() : mReceived(0)
+        {
+        }
+
+        void
+        onPacket(const Packet*)
+        {
+            mReceived.fetch_add(1);
+        }
+
+        std::atomic<uint32_t> mReceived;
+    };
+
+    Counter permanent;
+    KeyedSubscription<const Packet, uint16_t> subscription(
+            mTopic, 1, &permanent, &Counter::onPacket);
+
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> published(0);
+    std::thread publisher([&]() {
+        while (running.load())
+        {
+            Packet packet = {1, 0};
+            mTopic.publish(packet);
+            published.fetch_add(1);
+        }
+    });
+
+    // Modifications of several writers overlap with the grace periods of
+    // the previous ones.
+    std::vector<std::thread> writers;
+    for (size_t i = 0; i < numberOfWriters; ++i)
+    {
+        writers.emplace_back([this, i]() {
+            Counter temporary;
+            for (int k = 0; k < 50; ++k)
+            {
+                KeyedSubscription<const Packet, uint16_t> shortLived(
+                        mTopic, static_cast<uint16_t>(i + 1), &temporary, &Counter::onPacket);
+                EXPECT_TRUE(shortLived.isConnected());
+            }
+        });
+    }
+
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    running.store(false);
+    publisher.join();
+
+    EXPECT_EQ(published.load(), permanent.mReceived.load());
+    EXPECT_EQ(1U, mTopic.getNumberOfKeys());
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/latched_topic.h>
+#include <outpost/smpc/subscription.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+class Receiver : public Subscriber
+{
+public:
+    void
+    onReceive(const uint32_t* value)
+    {
+        mValues.push_back(*value);
+    }
+
+    std::vector<uint32_t> mValues;
+};
+
+class LatchedTopicTest : public testing::Test
+{
+public:
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    LatchedTopic<const uint32_t, 3> mTopic;
+};
+}  // namespace
+
+TEST_F(LatchedTopicTest, shouldReplayNothingWithoutMessages)
+{
+    Receiver receiver;
+    Subscription subscription(mTopic, &receiver, &Receiver::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    EXPECT_EQ(0U, mTopic.getNumberOfLatchedMessages());
+    EXPECT_TRUE(receiver.mValues.empty());
+}
+
+TEST_F(LatchedTopicTest, shouldReplayLastMessagesToNewSubscription)
+{
+    Receiver early;
+    Subscription subscription1(mTopic, &early, &Receiver::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    for (uint32_t i = 1; i <= 5; ++i)
+    {
+        mTopic.publish(i);
+    }
+    EXPECT_EQ(3U, mTopic.getNumberOfLatchedMessages());
+
+    Receiver late;
+    Subscription subscription2(mTopic, &late, &Receiver::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    // The already connected subscription is not called again
+    EXPECT_EQ(5U, early.mValues.size());
+    ASSERT_EQ(3U, late.mValues.size());
+    EXPECT_EQ(3U, late.mValues[0]);
+    EXPECT_EQ(4U, late.mValues[1]);
+    EXPECT_EQ(5U, late.mValues[2]);
+
+    mTopic.publish(6);
+    EXPECT_EQ(6U, early.mValues.size());
+    ASSERT_EQ(4U, late.mValues.size());
+    EXPECT_EQ(6U, late.mValues[3]);
+}
+
+TEST_F(LatchedTopicTest, shouldReplayOnIncrementalConnect)
+{
+    uint32_t values[4] = {10, 20, 30, 40};
+    mTopic.publishBatch(outpost::asSlice(values));
+
+    Receiver receiver;
+    Subscription subscription(mTopic, &receiver, &Receiver::onReceive);
+    subscription.connect();
+
+    ASSERT_EQ(3U, receiver.mValues.size());
+    EXPECT_EQ(20U, receiver.mValues[0]);
+    EXPECT_EQ(40U, receiver.mValues[2]);
+
+    // Reconnecting replays the cache again
+    subscription.disconnect();
+    subscription.connect();
+    EXPECT_EQ(6U, receiver.mValues.size());
+}
+
+TEST_F(LatchedTopicTest, shouldNotReplayAfterClear)
+{
+    mTopic.publish(1);
+    mTopic.clear();
+
+    Receiver receiver;
+    Subscription subscription(mTopic, &receiver, &Receiver::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    EXPECT_TRUE(receiver.mValues.empty());
+}
+
+TEST_F(LatchedTopicTest, lateJoinerReceivesEveryMessageOnce)
+{
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> published(0);
+    std::thread publisher([&]() {
+        uint32_t value = 0;
+        while (running.load() || (value < 100))
+        {
+            value++;
+            mTopic.publish(value);
+            published.store(value);
+        }
+    });
+
+    while (published.load() < 10)
+    {
+        std::this_thread::yield();
+    }
+
+    Receiver receiver;
+    Subscription subscription(mTopic, &receiver, &Receiver::onReceive);
+    subscription.connect();
+
+    running.store(false);
+    publisher.join();
+    subscription.disconnect();
+
+    // Replay and live messages form a gapless sequence without duplicates
+    ASSERT_LE(3U, receiver.mValues.size());
+    for (size_t i = 1; i < receiver.mValues.size(); ++i)
+    {
+        EXPECT_EQ(receiver.mValues[i - 1] + 1, receiver.mValues[i]);
+    }
+    EXPECT_EQ(published.load(), receiver.mValues.back());
+}
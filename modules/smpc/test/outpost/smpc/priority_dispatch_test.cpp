@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/deadline_monitor.h>
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/topic.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+#include <unittest/time/testing_clock.h>
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+using namespace outpost::smpc;
+using outpost::time::Duration;
+using outpost::time::Microseconds;
+
+namespace
+{
+std::vector<int> callOrder;
+
+class OrderedSubscriber : public Subscriber
+{
+public:
+    explicit OrderedSubscriber(int id) : mId(id)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        callOrder.push_back(mId);
+    }
+
+    const int mId;
+};
+
+class PriorityDispatchTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        callOrder.clear();
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    Topic<const uint32_t> mTopic;
+};
+
+class SlowSubscriber : public Subscriber
+{
+public:
+    SlowSubscriber(unittest::time::TestingClock& clock, Duration duration) :
+        mClock(clock),
+        mDuration(duration)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        mClock.incrementBy(mDuration);
+    }
+
+    unittest::time::TestingClock& mClock;
+    Duration mDuration;
+};
+
+const DeadlineMonitor* missedMonitor = nullptr;
+Duration missedDispatchTime = Duration::zero();
+
+void
+onDeadlineMissed(const DeadlineMonitor& monitor, Duration dispatchTime)
+{
+    missedMonitor = &monitor;
+    missedDispatchTime = dispatchTime;
+}
+}  // namespace
+
+TEST_F(PriorityDispatchTest, shouldCallHigherPriorityFirst)
+{
+    OrderedSubscriber logger(1);
+    OrderedSubscriber watchdog(2);
+    OrderedSubscriber control(3);
+
+    Subscription subscription1(mTopic, &logger, &OrderedSubscriber::onReceive);
+    Subscription subscription2(mTopic, &watchdog, &OrderedSubscriber::onReceive);
+    Subscription subscription3(mTopic, &control, &OrderedSubscriber::onReceive);
+
+    subscription1.setPriority(10);
+    subscription2.setPriority(250);
+    EXPECT_EQ(Subscription::defaultPriority, subscription3.getPriority());
+
+    Subscription::connectSubscriptionsToTopics();
+    mTopic.publish(1);
+
+    ASSERT_EQ(3U, callOrder.size());
+    EXPECT_EQ(2, callOrder[0]);
+    EXPECT_EQ(3, callOrder[1]);
+    EXPECT_EQ(1, callOrder[2]);
+}
+
+TEST_F(PriorityDispatchTest, shouldKeepOrderForIncrementalConnect)
+{
+    OrderedSubscriber low(1);
+    OrderedSubscriber high(2);
+    OrderedSubscriber middle(3);
+
+    Subscription subscription1(mTopic, &low, &OrderedSubscriber::onReceive);
+    Subscription subscription2(mTopic, &high, &OrderedSubscriber::onReceive);
+    Subscription subscription3(mTopic, &middle, &OrderedSubscriber::onReceive);
+    subscription1.setPriority(1);
+    subscription2.setPriority(200);
+    subscription3.setPriority(100);
+
+    subscription1.connect();
+    subscription2.connect();
+    subscription3.connect();
+    mTopic.publish(1);
+
+    ASSERT_EQ(3U, callOrder.size());
+    EXPECT_EQ(2, callOrder[0]);
+    EXPECT_EQ(3, callOrder[1]);
+    EXPECT_EQ(1, callOrder[2]);
+
+    // Remove from the middle and add again
+    callOrder.clear();
+    subscription3.disconnect();
+    mTopic.publish(2);
+    subscription3.connect();
+    mTopic.publish(3);
+
+    std::vector<int> expected = {2, 1, 2, 3, 1};
+    EXPECT_EQ(expected, callOrder);
+}
+
+TEST_F(PriorityDispatchTest, shouldSortManySubscriptions)
+{
+    static const int numberOfSubscriptions = 40;
+
+    std::vector<std::unique_ptr<OrderedSubscriber>> subscribers;
+    std::vector<std::unique_ptr<Subscription>> subscriptions;
+    for (int i = 0; i < numberOfSubscriptions; ++i)
+    {
+        subscribers.emplace_back(new OrderedSubscriber(i));
+        subscriptions.emplace_back(
+                new Subscription(mTopic, subscribers.back().get(), &OrderedSubscriber::onReceive));
+        subscriptions.back()->setPriority(static_cast<uint8_t>((i * 7) % 5));
+    }
+
+    Subscription::connectSubscriptionsToTopics();
+    mTopic.publish(1);
+
+    ASSERT_EQ(static_cast<size_t>(numberOfSubscriptions), callOrder.size());
+    for (size_t i = 1; i < callOrder.size(); ++i)
+    {
+        EXPECT_GE(subscriptions[callOrder[i - 1]]->getPriority(),
+                  subscriptions[callOrder[i]]->getPriority());
+    }
+}
+
+TEST_F(PriorityDispatchTest, shouldCountDeadlineMisses)
+{
+    unittest::time::TestingClock testingClock;
+    DeadlineMonitor monitor(testingClock, Microseconds(100), &onDeadlineMissed);
+    mTopic.setDeadlineMonitor(&monitor);
+
+    SlowSubscriber subscriber(testingClock, Microseconds(60));
+    Subscription subscription1(mTopic, &subscriber, &SlowSubscriber::onReceive);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publish(1);
+    EXPECT_EQ(1U, monitor.getNumberOfPublishes());
+    EXPECT_EQ(0U, monitor.getNumberOfMisses());
+    EXPECT_EQ(Microseconds(60), monitor.getMaximumDispatchTime());
+
+    Subscription subscription2(mTopic, &subscriber, &SlowSubscriber::onReceive);
+    subscription2.connect();
+
+    missedMonitor = nullptr;
+    mTopic.publish(2);
+    EXPECT_EQ(2U, monitor.getNumberOfPublishes());
+    EXPECT_EQ(1U, monitor.getNumberOfMisses());
+    EXPECT_EQ(Microseconds(120), monitor.getMaximumDispatchTime());
+    EXPECT_EQ(&monitor, missedMonitor);
+    EXPECT_EQ(Microseconds(120), missedDispatchTime);
+
+    uint32_t values[2] = {3, 4};
+    mTopic.publishBatch(outpost::asSlice(values));
+    EXPECT_EQ(2U, monitor.getNumberOfMisses());
+
+    monitor.reset();
+    EXPECT_EQ(0U, monitor.getNumberOfMisses());
+    EXPECT_EQ(Duration::zero(), monitor.getMaximumDispatchTime());
+
+    mTopic.setDeadlineMonitor(nullptr);
+    mTopic.publish(5);
+    EXPECT_EQ(0U, monitor.getNumberOfPublishes());
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/topic.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+struct Sample
+{
+    uint16_t channel;
+    int32_t value;
+};
+
+class SampleReceiver : public Subscriber
+{
+public:
+    SampleReceiver() : mCalls(0)
+    {
+    }
+
+    void
+    onSample(const Sample* sample)
+    {
+        mCalls++;
+        mValues.push_back(sample->value);
+    }
+
+    void
+    onSamples(outpost::Slice<const Sample> samples)
+    {
+        mCalls++;
+        for (const Sample& sample : samples)
+        {
+            mValues.push_back(sample.value);
+        }
+    }
+
+    size_t mCalls;
+    std::vector<int32_t> mValues;
+};
+
+class PublishBatchTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        for (size_t i = 0; i < numberOfSamples; ++i)
+        {
+            mSamples[i].channel = 1;
+            mSamples[i].value = static_cast<int32_t>(i * 10);
+        }
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    static constexpr size_t numberOfSamples = 5;
+
+    Topic<const Sample> mTopic;
+    Sample mSamples[numberOfSamples];
+};
+
+constexpr size_t PublishBatchTest::numberOfSamples;
+}  // namespace
+
+TEST_F(PublishBatchTest, batchedSubscriberIsCalledOncePerBatch)
+{
+    SampleReceiver receiver;
+    Subscription subscription(mTopic, &receiver, &SampleReceiver::onSamples);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publishBatch(outpost::asSlice(mSamples));
+
+    EXPECT_EQ(1U, receiver.mCalls);
+    ASSERT_EQ(numberOfSamples, receiver.mValues.size());
+    for (size_t i = 0; i < numberOfSamples; ++i)
+    {
+        EXPECT_EQ(mSamples[i].value, receiver.mValues[i]);
+    }
+}
+
+TEST_F(PublishBatchTest, singleSubscriberIsCalledPerSample)
+{
+    SampleReceiver receiver;
+    Subscription subscription(mTopic, &receiver, &SampleReceiver::onSample);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publishBatch(outpost::asSlice(mSamples));
+
+    EXPECT_EQ(numberOfSamples, receiver.mCalls);
+    ASSERT_EQ(numberOfSamples, receiver.mValues.size());
+    for (size_t i = 0; i < numberOfSamples; ++i)
+    {
+        EXPECT_EQ(mSamples[i].value, receiver.mValues[i]);
+    }
+}
+
+TEST_F(PublishBatchTest, batchedSubscriberReceivesSinglePublish)
+{
+    SampleReceiver receiver;
+    Subscription subscription(mTopic, &receiver, &SampleReceiver::onSamples);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publish(mSamples[3]);
+
+    EXPECT_EQ(1U, receiver.mCalls);
+    ASSERT_EQ(1U, receiver.mValues.size());
+    EXPECT_EQ(30, receiver.mValues[0]);
+}
+
+TEST_F(PublishBatchTest, mixedSubscribers)
+{
+    SampleReceiver batched;
+    SampleReceiver single;
+    Subscription subscription1(mTopic, &batched, &SampleReceiver::onSamples);
+    Subscription subscription2(mTopic, &single, &SampleReceiver::onSample);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publishBatch(outpost::asSlice(mSamples).first(3));
+
+    EXPECT_EQ(1U, batched.mCalls);
+    EXPECT_EQ(3U, single.mCalls);
+    EXPECT_EQ(batched.mValues, single.mValues);
+}
+
+TEST_F(PublishBatchTest, emptyBatchIsNotForwarded)
+{
+    SampleReceiver receiver;
+    Subscription subscription(mTopic, &receiver, &SampleReceiver::onSamples);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publishBatch(outpost::Slice<const Sample>::empty());
+
+    EXPECT_EQ(0U, receiver.mCalls);
+}
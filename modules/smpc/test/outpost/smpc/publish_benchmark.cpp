@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Throughput of Topic::publish() with concurrent publishers and of
+ * Topic::publishBatch() compared to publishing every sample.
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include <outpost/rtos/mutex.h>
+#include <outpost/rtos/mutex_guard.h>
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/topic.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+static const uint32_t messagesPerThread = 200000;
+
+class Heartbeat : public Subscriber
+{
+public:
+    void
+    onHeartbeat(const uint32_t* value)
+    {
+        mLast = *value;
+    }
+
+    volatile uint32_t mLast = 0;
+};
+
+class SampleSink : public Subscriber
+{
+public:
+    void
+    onSample(const uint32_t* value)
+    {
+        mSum = mSum + *value;
+    }
+
+    void
+    onSamples(outpost::Slice<const uint32_t> values)
+    {
+        uint32_t sum = 0;
+        for (uint32_t value : values)
+        {
+            sum += value;
+        }
+        mSum = mSum + sum;
+    }
+
+    volatile uint32_t mSum = 0;
+};
+
+static const size_t samplesPerRun = 4 * 1024 * 1024;
+
+/**
+ * Returns the number of samples per second delivered to the subscribers.
+ */
+template <typename Function>
+double
+measureSamples(Function function)
+{
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return samplesPerRun / elapsed.count();
+}
+
+/**
+ * Returns the number of publishes per second achieved by all threads.
+ *
+ * When \p lock is given every publish is additionally serialized by
+ * that mutex. This mimics the previous implementation which acquired a
+ * per topic mutex.
+ */
+double
+measure(Topic<const uint32_t>& topic, size_t numberOfThreads, outpost::rtos::Mutex* lock)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < numberOfThreads; ++i)
+    {
+        threads.emplace_back([&topic, lock]() {
+            for (uint32_t value = 0; value < messagesPerThread; ++value)
+            {
+                if (lock != nullptr)
+                {
+                    outpost::rtos::MutexGuard guard(*lock);
+                    topic.publish(value);
+                }
+                else
+                {
+                    topic.publish(value);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (numberOfThreads * messagesPerThread) / elapsed.count();
+}
+}  // namespace
+
+TEST(PublishBenchmark, DISABLED_publishesPerSecond)
+{
+    Topic<const uint32_t> topic;
+    Heartbeat watchdog;
+    Heartbeat logger;
+    Subscription subscription1(topic, &watchdog, &Heartbeat::onHeartbeat);
+    Subscription subscription2(topic, &logger, &Heartbeat::onHeartbeat);
+
+    Subscription::connectSubscriptionsToTopics();
+
+    outpost::rtos::Mutex mutex;
+
+    printf("threads   lock-free [1/s]   mutex [1/s]\n");
+    for (size_t threads = 1; threads <= 16; threads *= 2)
+    {
+        double lockFree = measure(topic, threads, nullptr);
+        double locked = measure(topic, threads, &mutex);
+        printf("%7zu   %15.0f   %11.0f\n", threads, lockFree, locked);
+    }
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST(PublishBenchmark, DISABLED_samplesPerSecondBatched)
+{
+    static const size_t numberOfSubscribers = 4;
+    static const size_t maximumBatchSize = 1024;
+
+    std::vector<uint32_t> samples(maximumBatchSize);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i] = static_cast<uint32_t>(i);
+    }
+
+    Topic<const uint32_t> single;
+    Topic<const uint32_t> batched;
+    SampleSink sinks[numberOfSubscribers];
+    std::vector<Subscription*> subscriptions;
+    for (size_t i = 0; i < numberOfSubscribers; ++i)
+    {
+        subscriptions.push_back(new Subscription(single, &sinks[i], &SampleSink::onSample));
+        subscriptions.push_back(new Subscription(batched, &sinks[i], &SampleSink::onSamples));
+    }
+    Subscription::connectSubscriptionsToTopics();
+
+    printf("batch size   publish() [1/s]   publishBatch() [1/s]   speedup\n");
+    for (size_t batchSize = 1; batchSize <= maximumBatchSize; batchSize *= 4)
+    {
+        outpost::Slice<const uint32_t> batch =
+                outpost::Slice<const uint32_t>::unsafe(samples.data(), batchSize);
+
+        double perSample = measureSamples([&]() {
+            for (size_t n = 0; n < samplesPerRun; n += batchSize)
+            {
+                for (const uint32_t& sample : batch)
+                {
+                    single.publish(sample);
+                }
+            }
+        });
+        double perBatch = measureSamples([&]() {
+            for (size_t n = 0; n < samplesPerRun; n += batchSize)
+            {
+                batched.publishBatch(batch);
+            }
+        });
+        printf("%10zu   %15.0f   %20.0f   %7.1f\n",
+               batchSize,
+               perSample,
+               perBatch,
+               perBatch / perSample);
+    }
+
+    for (Subscription* subscription : subscriptions)
+    {
+        delete subscription;
+    }
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
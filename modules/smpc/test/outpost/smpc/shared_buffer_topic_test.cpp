@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/shared_buffer_topic.h>
+#include <outpost/smpc/subscription.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+using namespace outpost::smpc;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedChildPointer;
+
+namespace
+{
+class PacketStore : public Subscriber
+{
+public:
+    PacketStore() : mReceived(0)
+    {
+    }
+
+    void
+    onPacket(const SharedBufferPointer* packet)
+    {
+        mReceived++;
+        mLast = *packet;
+        mLastWasChild = packet->isChild();
+    }
+
+    size_t mReceived;
+    SharedBufferPointer mLast;
+    bool mLastWasChild = false;
+};
+
+class SharedBufferTopicTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        ASSERT_TRUE(mPool.allocate(mPacket));
+        for (size_t i = 0; i < mPacket.getLength(); ++i)
+        {
+            mPacket[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+    }
+
+    outpost::utils::SharedBufferPool<16, 2> mPool;
+    SharedBufferPointer mPacket;
+    SharedBufferTopic mTopic;
+};
+}  // namespace
+
+TEST_F(SharedBufferTopicTest, subscribersShareTheSameBuffer)
+{
+    PacketStore store1;
+    PacketStore store2;
+    Subscription subscription1(mTopic, &store1, &PacketStore::onPacket);
+    Subscription subscription2(mTopic, &store2, &PacketStore::onPacket);
+    Subscription::connectSubscriptionsToTopics();
+
+    EXPECT_TRUE(mTopic.publish(mPacket));
+    EXPECT_EQ(1U, store1.mReceived);
+    EXPECT_EQ(1U, store2.mReceived);
+
+    // No copies of the data, only references
+    EXPECT_TRUE(store1.mLast == mPacket);
+    EXPECT_TRUE(store2.mLast == mPacket);
+    EXPECT_EQ(3U, mPacket->getReferenceCount());
+    EXPECT_EQ(1U, mPool.numberOfFreeElements());
+}
+
+TEST_F(SharedBufferTopicTest, bufferStaysValidAfterPublisherReleasedIt)
+{
+    PacketStore store;
+    Subscription subscription(mTopic, &store, &PacketStore::onPacket);
+    Subscription::connectSubscriptionsToTopics();
+
+    mTopic.publish(mPacket);
+    mPacket = SharedBufferPointer();
+
+    ASSERT_TRUE(store.mLast.isValid());
+    EXPECT_EQ(1U, store.mLast->getReferenceCount());
+    EXPECT_EQ(7U, store.mLast[7]);
+    EXPECT_EQ(1U, mPool.numberOfFreeElements());
+
+    store.mLast = SharedBufferPointer();
+    EXPECT_EQ(2U, mPool.numberOfFreeElements());
+}
+
+TEST_F(SharedBufferTopicTest, shouldPublishChildPointer)
+{
+    PacketStore store;
+    Subscription subscription(mTopic, &store, &PacketStore::onPacket);
+    Subscription::connectSubscriptionsToTopics();
+
+    SharedChildPointer payload;
+    ASSERT_TRUE(mPacket.getChild(payload, 5, 4, 8));
+
+    EXPECT_TRUE(mTopic.publish(payload));
+    EXPECT_TRUE(store.mLastWasChild);
+    EXPECT_EQ(8U, store.mLast.getLength());
+    EXPECT_EQ(5U, store.mLast.getType());
+    EXPECT_EQ(4U, store.mLast[0]);
+
+    outpost::Slice<uint8_t> data = store.mLast.asSlice();
+    EXPECT_EQ(8U, data.getNumberOfElements());
+    EXPECT_EQ(11U, data[7]);
+}
+
+TEST_F(SharedBufferTopicTest, shouldNotForwardInvalidBuffer)
+{
+    PacketStore store;
+    Subscription subscription(mTopic, &store, &PacketStore::onPacket);
+    Subscription::connectSubscriptionsToTopics();
+
+    EXPECT_FALSE(mTopic.publish(SharedBufferPointer()));
+    EXPECT_EQ(0U, store.mReceived);
+}
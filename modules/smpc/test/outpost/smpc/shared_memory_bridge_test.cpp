@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/shared_memory_bridge.h>
+#include <outpost/smpc/shared_memory_channel.h>
+#include <outpost/smpc/subscription_raw.h>
+#include <outpost/smpc/topic_raw.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription_raw.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+static constexpr uint32_t numberOfTransferredMessages = 2000;
+
+class Collector : public SharedMemoryChannel::Handler
+{
+public:
+    virtual void
+    onMessage(uint32_t id, const void* message, size_t length) override
+    {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(message);
+        mIds.push_back(id);
+        mMessages.push_back(std::vector<uint8_t>(data, data + length));
+    }
+
+    std::vector<uint32_t> mIds;
+    std::vector<std::vector<uint8_t>> mMessages;
+};
+
+/**
+ * Checks that the sequence numbers at the start of the messages are
+ * consecutive.
+ */
+class SequenceChecker : public Subscriber
+{
+public:
+    SequenceChecker() : mReceived(0), mErrors(0)
+    {
+    }
+
+    void
+    onMessage(const void* message, size_t length)
+    {
+        uint32_t sequence = 0;
+        if (length >= sizeof(sequence))
+        {
+            memcpy(&sequence, message, sizeof(sequence));
+        }
+
+        if ((length < sizeof(sequence)) || (sequence != mReceived)
+            || (length != (sizeof(sequence) + (sequence % 100))))
+        {
+            mErrors++;
+        }
+        mReceived++;
+    }
+
+    uint32_t mReceived;
+    uint32_t mErrors;
+};
+
+class SharedMemoryChannelTest : public testing::Test
+{
+public:
+    SharedMemoryChannelTest()
+    {
+        snprintf(mName, sizeof(mName), "/outpost-smpc-test-%d", static_cast<int>(getpid()));
+    }
+
+    virtual void
+    SetUp() override
+    {
+        SharedMemoryChannel::remove(mName);
+    }
+
+    virtual void
+    TearDown() override
+    {
+        unittest::smpc::TestingSubscriptionRaw::releaseAllSubscriptions();
+    }
+
+    char mName[64];
+};
+
+/**
+ * Sending side running in the child process.
+ */
+int
+runSender(const char* name)
+{
+    SharedMemoryChannel channel;
+    if (!channel.open(name))
+    {
+        return 1;
+    }
+
+    TopicRaw topic;
+    SharedMemoryExport bridge(channel, topic, 7, outpost::time::Duration::infinity());
+    SubscriptionRaw::connectSubscriptionsToTopics();
+
+    uint8_t buffer[128] = {};
+    for (uint32_t i = 0; i < numberOfTransferredMessages; ++i)
+    {
+        memcpy(buffer, &i, sizeof(i));
+        topic.publish(buffer, sizeof(i) + (i % 100));
+    }
+
+    return (bridge.getNumberOfDroppedMessages() == 0) ? 0 : 2;
+}
+}  // namespace
+
+TEST_F(SharedMemoryChannelTest, shouldRejectInvalidCapacity)
+{
+    SharedMemoryChannel channel;
+    EXPECT_FALSE(channel.create(mName, 1000));
+    EXPECT_FALSE(channel.create(mName, 32));
+    EXPECT_FALSE(channel.isOpen());
+}
+
+TEST_F(SharedMemoryChannelTest, shouldNotOpenMissingChannel)
+{
+    SharedMemoryChannel channel;
+    EXPECT_FALSE(channel.open(mName));
+}
+
+TEST_F(SharedMemoryChannelTest, shouldTransferMessages)
+{
+    SharedMemoryChannel sender;
+    SharedMemoryChannel receiver;
+    ASSERT_TRUE(sender.create(mName, 256));
+    ASSERT_TRUE(receiver.open(mName));
+    EXPECT_EQ(120U, receiver.getMaximumMessageLength());
+
+    const char first[] = "housekeeping";
+    const uint8_t second[3] = {1, 2, 3};
+    EXPECT_TRUE(sender.send(1, first, sizeof(first), outpost::time::Duration::zero()));
+    EXPECT_TRUE(sender.send(2, second, sizeof(second), outpost::time::Duration::zero()));
+    EXPECT_TRUE(sender.send(3, nullptr, 0, outpost::time::Duration::zero()));
+
+    Collector collector;
+    ASSERT_EQ(3U, receiver.receive(collector, outpost::time::Duration::zero()));
+    EXPECT_EQ(1U, collector.mIds[0]);
+    EXPECT_EQ(0, memcmp(first, collector.mMessages[0].data(), sizeof(first)));
+    EXPECT_EQ(2U, collector.mIds[1]);
+    EXPECT_EQ(3U, collector.mMessages[1].size());
+    EXPECT_EQ(3U, collector.mIds[2]);
+    EXPECT_TRUE(collector.mMessages[2].empty());
+
+    EXPECT_EQ(0U, receiver.receive(collector, outpost::time::Milliseconds(1)));
+}
+
+TEST_F(SharedMemoryChannelTest, shouldRejectTooLongMessages)
+{
+    SharedMemoryChannel sender;
+    ASSERT_TRUE(sender.create(mName, 64));
+
+    uint8_t data[64] = {};
+    EXPECT_FALSE(sender.send(1, data, sender.getMaximumMessageLength() + 1,
+                             outpost::time::Duration::zero()));
+    EXPECT_FALSE(sender.send(SharedMemoryChannel::invalidId, data, 1,
+                             outpost::time::Duration::zero()));
+    EXPECT_TRUE(sender.send(1, data, sender.getMaximumMessageLength(),
+                            outpost::time::Duration::zero()));
+}
+
+TEST_F(SharedMemoryChannelTest, shouldDropMessagesIfFull)
+{
+    SharedMemoryChannel sender;
+    SharedMemoryChannel receiver;
+    ASSERT_TRUE(sender.create(mName, 64));
+    ASSERT_TRUE(receiver.open(mName));
+
+    // Each record needs 16 bytes
+    uint8_t data[8] = {};
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(sender.send(1, data, sizeof(data), outpost::time::Duration::zero()));
+    }
+    EXPECT_FALSE(sender.send(1, data, sizeof(data), outpost::time::Milliseconds(1)));
+    EXPECT_EQ(1U, receiver.getNumberOfDroppedMessages());
+
+    Collector collector;
+    EXPECT_EQ(4U, receiver.receive(collector, outpost::time::Duration::zero()));
+    EXPECT_TRUE(sender.send(1, data, sizeof(data), outpost::time::Duration::zero()));
+}
+
+TEST_F(SharedMemoryChannelTest, shouldWrapAroundBetweenThreads)
+{
+    SharedMemoryChannel sender;
+    SharedMemoryChannel receiver;
+    ASSERT_TRUE(sender.create(mName, 512));
+    ASSERT_TRUE(receiver.open(mName));
+
+    TopicRaw topic;
+    SequenceChecker checker;
+    SubscriptionRaw subscription(topic, &checker, &SequenceChecker::onMessage);
+    SubscriptionRaw::connectSubscriptionsToTopics();
+
+    SharedMemoryReceiver dispatcher(receiver, 0);
+    SharedMemoryImport bridge(dispatcher, topic, 7);
+
+    std::thread thread([&]() {
+        uint8_t buffer[128] = {};
+        for (uint32_t i = 0; i < numberOfTransferredMessages; ++i)
+        {
+            memcpy(buffer, &i, sizeof(i));
+            sender.send(7, buffer, sizeof(i) + (i % 100), outpost::time::Duration::infinity());
+        }
+    });
+
+    while (checker.mReceived < numberOfTransferredMessages)
+    {
+        if (dispatcher.dispatch(outpost::time::Seconds(5)) == 0)
+        {
+            break;
+        }
+    }
+    thread.join();
+
+    EXPECT_EQ(numberOfTransferredMessages, checker.mReceived);
+    EXPECT_EQ(0U, checker.mErrors);
+    EXPECT_EQ(0U, dispatcher.getNumberOfUnknownMessages());
+}
+
+TEST_F(SharedMemoryChannelTest, shouldCountUnknownMessages)
+{
+    SharedMemoryChannel sender;
+    SharedMemoryChannel receiver;
+    ASSERT_TRUE(sender.create(mName, 256));
+    ASSERT_TRUE(receiver.open(mName));
+
+    SharedMemoryReceiver dispatcher(receiver, 0);
+    EXPECT_TRUE(sender.send(5, nullptr, 0, outpost::time::Duration::zero()));
+    EXPECT_EQ(1U, dispatcher.dispatch(outpost::time::Duration::zero()));
+    EXPECT_EQ(1U, dispatcher.getNumberOfUnknownMessages());
+}
+
+TEST_F(SharedMemoryChannelTest, shouldBridgeTopicsBetweenProcesses)
+{
+    SharedMemoryChannel channel;
+    ASSERT_TRUE(channel.create(mName, 1024));
+
+    TopicRaw topic;
+    SequenceChecker checker;
+    SubscriptionRaw subscription(topic, &checker, &SequenceChecker::onMessage);
+    SubscriptionRaw::connectSubscriptionsToTopics();
+
+    SharedMemoryReceiver receiver(channel, 0);
+    SharedMemoryImport bridge(receiver, topic, 7);
+
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0)
+    {
+        _exit(runSender(mName));
+    }
+
+    while (checker.mReceived < numberOfTransferredMessages)
+    {
+        if (receiver.dispatch(outpost::time::Seconds(5)) == 0)
+        {
+            break;
+        }
+    }
+
+    int status = -1;
+    ASSERT_EQ(child, waitpid(child, &status, 0));
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(0, WEXITSTATUS(status));
+
+    EXPECT_EQ(numberOfTransferredMessages, checker.mReceived);
+    EXPECT_EQ(0U, checker.mErrors);
+}
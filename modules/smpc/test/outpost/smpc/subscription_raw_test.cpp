@@ -209,3 +209,24 @@ TEST_F(SubscriptionRawTest, receiveFourWithDelete2)
     delete subscription1;
     delete subscription2;
 }
+
+TEST_F(SubscriptionRawTest, connectAndDisconnectAtRuntime)
+{
+    SubscriptionRaw subscription0(topic, &component, &Component::onReceiveData0);
+
+    unittest::smpc::TestingSubscriptionRaw::connectSubscriptionsToTopics();
+
+    SubscriptionRaw subscription1(topic, &component, &Component::onReceiveData1);
+    subscription1.connect();
+
+    topic.publish(&data, sizeof(data));
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_TRUE(component.received[1]);
+
+    component.reset();
+    subscription0.disconnect();
+
+    topic.publish(&data, sizeof(data));
+    EXPECT_FALSE(component.received[0]);
+    EXPECT_TRUE(component.received[1]);
+}
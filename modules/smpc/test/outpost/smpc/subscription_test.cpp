@@ -207,3 +207,92 @@ TEST_F(SubscriptionTest, receiveFourWithDelete2)
     delete subscription1;
     delete subscription2;
 }
+
+TEST_F(SubscriptionTest, connectSingleSubscriptionAtRuntime)
+{
+    outpost::smpc::Subscription subscription0(topic, &component, &Component::onReceiveData0);
+
+    unittest::smpc::TestingSubscription::connectSubscriptionsToTopics();
+
+    outpost::smpc::Subscription subscription1(topic, &component, &Component::onReceiveData1);
+    EXPECT_FALSE(subscription1.isConnected());
+
+    topic.publish(data);
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_FALSE(component.received[1]);
+
+    component.reset();
+    subscription1.connect();
+    EXPECT_TRUE(subscription1.isConnected());
+
+    topic.publish(data);
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_TRUE(component.received[1]);
+}
+
+TEST_F(SubscriptionTest, disconnectSingleSubscription)
+{
+    outpost::smpc::Subscription subscription0(topic, &component, &Component::onReceiveData0);
+    outpost::smpc::Subscription subscription1(topic, &component, &Component::onReceiveData1);
+    outpost::smpc::Subscription subscription2(topic, &component, &Component::onReceiveData2);
+
+    unittest::smpc::TestingSubscription::connectSubscriptionsToTopics();
+
+    subscription1.disconnect();
+    EXPECT_FALSE(subscription1.isConnected());
+
+    topic.publish(data);
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_FALSE(component.received[1]);
+    EXPECT_TRUE(component.received[2]);
+
+    component.reset();
+    subscription0.disconnect();
+    subscription2.disconnect();
+
+    topic.publish(data);
+    EXPECT_FALSE(component.received[0]);
+    EXPECT_FALSE(component.received[1]);
+    EXPECT_FALSE(component.received[2]);
+
+    // Reconnect in a different order
+    subscription2.connect();
+    subscription0.connect();
+
+    topic.publish(data);
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_FALSE(component.received[1]);
+    EXPECT_TRUE(component.received[2]);
+}
+
+TEST_F(SubscriptionTest, shouldNotAffectOtherTopicsOnDelete)
+{
+    outpost::smpc::Topic<const Data> otherTopic;
+    outpost::smpc::Subscription subscription0(otherTopic, &component, &Component::onReceiveData0);
+    outpost::smpc::Subscription* subscription1 =
+            new outpost::smpc::Subscription(topic, &component, &Component::onReceiveData1);
+
+    unittest::smpc::TestingSubscription::connectSubscriptionsToTopics();
+
+    delete subscription1;
+
+    otherTopic.publish(data);
+    topic.publish(data);
+    EXPECT_TRUE(component.received[0]);
+    EXPECT_FALSE(component.received[1]);
+}
+
+TEST_F(SubscriptionTest, shouldOutliveTopic)
+{
+    outpost::smpc::Topic<const Data>* shortLivedTopic = new outpost::smpc::Topic<const Data>;
+    outpost::smpc::Subscription subscription0(
+            *shortLivedTopic, &component, &Component::onReceiveData0);
+    subscription0.connect();
+    EXPECT_TRUE(subscription0.isConnected());
+
+    delete shortLivedTopic;
+    EXPECT_FALSE(subscription0.isConnected());
+
+    // Must not access the topic anymore
+    subscription0.disconnect();
+}
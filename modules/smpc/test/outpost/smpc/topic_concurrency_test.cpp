@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/smpc/subscription.h>
+#include <outpost/smpc/topic.h>
+
+#include <unittest/harness.h>
+#include <unittest/smpc/testing_subscription.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace outpost::smpc;
+
+namespace
+{
+class Counter : public Subscriber
+{
+public:
+    Counter() : mReceived(0)
+    {
+    }
+
+    void
+    onReceive(const uint32_t*)
+    {
+        mReceived.fetch_add(1);
+    }
+
+    std::atomic<uint32_t> mReceived;
+};
+}  // namespace
+
+TEST(TopicConcurrencyTest, publishWhileReconnecting)
+{
+    static const size_t numberOfPublishers = 4;
+    static const uint32_t messagesPerPublisher = 20000;
+
+    Topic<const uint32_t> topic;
+    Counter counter;
+    Subscription subscription(topic, &counter, &Counter::onReceive);
+
+    Subscription::connectSubscriptionsToTopics();
+
+    std::atomic<bool> running(true);
+    std::vector<std::thread> publishers;
+    for (size_t i = 0; i < numberOfPublishers; ++i)
+    {
+        publishers.emplace_back([&topic]() {
+            for (uint32_t value = 0; value < messagesPerPublisher; ++value)
+            {
+                topic.publish(value);
+            }
+        });
+    }
+
+    std::thread writer([&running]() {
+        while (running.load())
+        {
+            Subscription::connectSubscriptionsToTopics();
+        }
+    });
+
+    for (auto& publisher : publishers)
+    {
+        publisher.join();
+    }
+    running.store(false);
+    writer.join();
+
+    // Messages published while the lists are rebuilt may be lost, but
+    // never delivered twice.
+    EXPECT_LE(counter.mReceived.load(), numberOfPublishers * messagesPerPublisher);
+
+    counter.mReceived.store(0);
+    uint32_t value = 1;
+    topic.publish(value);
+    EXPECT_EQ(1U, counter.mReceived.load());
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST(TopicConcurrencyTest, publishFromMultipleThreads)
+{
+    static const size_t numberOfPublishers = 8;
+    static const uint32_t messagesPerPublisher = 10000;
+
+    Topic<const uint32_t> topic;
+    Counter counter1;
+    Counter counter2;
+    Subscription subscription1(topic, &counter1, &Counter::onReceive);
+    Subscription subscription2(topic, &counter2, &Counter::onReceive);
+
+    Subscription::connectSubscriptionsToTopics();
+
+    std::vector<std::thread> publishers;
+    for (size_t i = 0; i < numberOfPublishers; ++i)
+    {
+        publishers.emplace_back([&topic]() {
+            for (uint32_t value = 0; value < messagesPerPublisher; ++value)
+            {
+                topic.publish(value);
+            }
+        });
+    }
+
+    for (auto& publisher : publishers)
+    {
+        publisher.join();
+    }
+
+    EXPECT_EQ(numberOfPublishers * messagesPerPublisher, counter1.mReceived.load());
+    EXPECT_EQ(numberOfPublishers * messagesPerPublisher, counter2.mReceived.load());
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST(TopicConcurrencyTest, createAndDestroySubscriptionsWhilePublishing)
+{
+    static const size_t numberOfPublishers = 4;
+
+    Topic<const uint32_t> topic;
+    Counter permanent;
+    Subscription subscription(topic, &permanent, &Counter::onReceive);
+
+    Subscription::connectSubscriptionsToTopics();
+
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> published(0);
+    std::vector<std::thread> publishers;
+    for (size_t i = 0; i < numberOfPublishers; ++i)
+    {
+        publishers.emplace_back([&topic, &running, &published]() {
+            uint32_t value = 0;
+            while (running.load())
+            {
+                topic.publish(value);
+                published.fetch_add(1);
+                value++;
+            }
+        });
+    }
+
+    for (int i = 0; i < 200; ++i)
+    {
+        Counter temporary;
+        Subscription* shortLived = new Subscription(topic, &temporary, &Counter::onReceive);
+        shortLived->connect();
+        delete shortLived;
+    }
+
+    running.store(false);
+    for (auto& publisher : publishers)
+    {
+        publisher.join();
+    }
+
+    // The permanent subscription must never miss a message.
+    EXPECT_EQ(published.load(), permanent.mReceived.load());
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
+
+TEST(TopicConcurrencyTest, disconnectFromMultipleThreadsWhilePublishing)
+{
+    static const size_t numberOfWriters = 3;
+
+    Topic<const uint32_t> topic;
+    Counter permanent;
+    Subscription subscription(topic, &permanent, &Counter::onReceive);
+
+    Subscription::connectSubscriptionsToTopics();
+
+    std::atomic<bool> running(true);
+    std::atomic<uint32_t> published(0);
+    std::thread publisher([&topic, &running, &published]() {
+        uint32_t value = 0;
+        while (running.load())
+        {
+            topic.publish(value);
+            published.fetch_add(1);
+            value++;
+        }
+    });
+
+    // Creating subscriptions is not thread-safe, only connect and
+    // disconnect them concurrently. Grace periods of several writers overlap.
+    Counter counters[numberOfWriters];
+    std::vector<std::unique_ptr<Subscription>> subscriptions;
+    for (size_t i = 0; i < numberOfWriters; ++i)
+    {
+        subscriptions.emplace_back(new Subscription(topic, &counters[i], &Counter::onReceive));
+    }
+
+    std::vector<std::thread> writers;
+    for (size_t i = 0; i < numberOfWriters; ++i)
+    {
+        Subscription* own = subscriptions[i].get();
+        writers.emplace_back([own]() {
+            for (int k = 0; k < 50; ++k)
+            {
+                own->connect();
+                own->disconnect();
+            }
+        });
+    }
+
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    running.store(false);
+    publisher.join();
+
+    EXPECT_EQ(published.load(), permanent.mReceived.load());
+
+    unittest::smpc::TestingSubscription::releaseAllSubscriptions();
+}
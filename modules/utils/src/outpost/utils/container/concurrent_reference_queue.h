@@ -0,0 +1,752 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_UTILS_CONCURRENT_REFERENCE_QUEUE_H
+#define OUTPOST_UTILS_CONCURRENT_REFERENCE_QUEUE_H
+
+#include "reference_queue.h"
+
+#include <outpost/base/slice.h>
+#include <outpost/rtos/clock.h>
+#include <outpost/rtos/semaphore.h>
+#include <outpost/time/duration.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+namespace outpost
+{
+namespace utils
+{
+namespace reference_queue
+{
+/**
+ * Sleeping threads of one side (senders or receivers) of a queue.
+ *
+ * Threads only go to sleep after an operation has failed. The other side
+ * only touches the semaphore if a thread is registered as waiting, so the
+ * operating system is not involved as long as the queue is neither empty
+ * nor full.
+ */
+class WaitList
+{
+public:
+    WaitList() : mWaiting(0), mSignal(outpost::rtos::BinarySemaphore::State::acquired)
+    {
+    }
+
+    // Disable copy constructor
+    WaitList(const WaitList&) = delete;
+
+    // Disable copy assignment operator
+    WaitList&
+    operator=(const WaitList&) = delete;
+
+    /**
+     * Retries \p operation until it succeeds or the timeout expires.
+     *
+     * \param operation
+     *      Non-blocking operation returning true on success.
+     * \param timeout
+     *      Maximum time to wait, zero for a single try.
+     */
+    template <typename Operation>
+    bool
+    wait(Operation operation, outpost::time::Duration timeout);
+
+    /**
+     * Wakes a waiting thread, if any.
+     *
+     * Must be called after every operation which might allow a waiting
+     * thread to proceed.
+     */
+    inline void
+    notify()
+    {
+        // Orders the preceding update of the queue before reading the
+        // number of waiting threads, pairs with the fence in wait().
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (mWaiting.load(std::memory_order_relaxed) > 0)
+        {
+            mSignal.release();
+        }
+    }
+
+private:
+    std::atomic<uint32_t> mWaiting;
+    outpost::rtos::BinarySemaphore mSignal;
+};
+}  // namespace reference_queue
+
+/**
+ * \ingroup SharedBuffer
+ * \brief Lock-free queue for a single sender and a single receiver.
+ *
+ * Drop-in replacement for ReferenceQueue if only one thread sends and one
+ * thread receives. The items are stored in a ring buffer indexed by two
+ * monotonically increasing positions. Sending and receiving do not take a
+ * lock. A thread only blocks (on an outpost::rtos::BinarySemaphore) if it
+ * has to wait for an empty queue to be filled or for a full queue to be
+ * drained.
+ *
+ * \tparam T Type of the items, e.g. SharedBufferPointer
+ * \tparam N Capacity of the queue, must be a power of two
+ */
+template <typename T, size_t N>
+class SpscReferenceQueue : public ReferenceQueueBase<T>
+{
+public:
+    static_assert((N > 0) && ((N & (N - 1)) == 0), "The capacity must be a power of two");
+    static_assert(N <= 0x8000, "The number of items must fit into uint16_t");
+
+    SpscReferenceQueue();
+
+    // Disable copy constructor
+    SpscReferenceQueue(const SpscReferenceQueue&) = delete;
+
+    // Disable copy assignment operator
+    SpscReferenceQueue&
+    operator=(const SpscReferenceQueue&) = delete;
+
+    /**
+     * \brief Send a copy of the data to the queue.
+     * \see ReferenceQueueBase::send(T&)
+     */
+    bool
+    send(T& data) override;
+
+    /**
+     * \brief Move data into the queue.
+     * \see ReferenceQueueBase::send(T&&)
+     */
+    bool
+    send(T&& data) override;
+
+    /**
+     * \brief Move data into the queue, waiting for a free slot.
+     *
+     * \param data Data to be sent, left unchanged if the queue stayed full.
+     * \param timeout Duration for which the caller is willing to wait for a free slot
+     * \return Returns true if data could be sent, false otherwise.
+     */
+    bool
+    send(T&& data, outpost::time::Duration timeout);
+
+    /**
+     * \brief Receive data from the queue.
+     * \see ReferenceQueueBase::receive(T&, outpost::time::Duration)
+     */
+    bool
+    receive(T& data,
+            outpost::time::Duration timeout = outpost::time::Duration::infinity()) override;
+
+    /**
+     * \brief Move several items into the queue, notifying the receiver once.
+     * \see ReferenceQueueBase::sendBatch(outpost::Slice<T>)
+     */
+    size_t
+    sendBatch(outpost::Slice<T> data) override;
+
+    /**
+     * \brief Receive several items, notifying waiting senders once.
+     * \see ReferenceQueueBase::receiveBatch(outpost::Slice<T>, size_t, outpost::time::Duration)
+     */
+    size_t
+    receiveBatch(outpost::Slice<T> data,
+                 size_t minItems = 1,
+                 outpost::time::Duration timeout = outpost::time::Duration::infinity()) override;
+
+    uint16_t
+    getNumberOfItems() override;
+
+    bool
+    isEmpty() override;
+
+    bool
+    isFull() override;
+
+private:
+    static constexpr size_t mask = N - 1;
+
+    bool
+    trySend(T& data);
+
+    bool
+    tryReceive(T& data);
+
+    size_t
+    tryReceiveBatch(outpost::Slice<T> data, size_t& received);
+
+    // Receiver side. The ring buffer is placed in between to keep the
+    // positions written by sender and receiver on different cache lines.
+    std::atomic<size_t> mHead;
+    size_t mCachedTail;
+
+    T mItems[N];
+
+    // Sender side
+    std::atomic<size_t> mTail;
+    size_t mCachedHead;
+
+    reference_queue::WaitList mReceivers;
+    reference_queue::WaitList mSenders;
+};
+
+/**
+ * \ingroup SharedBuffer
+ * \brief Lock-free queue for multiple senders and multiple receivers.
+ *
+ * Drop-in replacement for ReferenceQueue. Every slot of the ring buffer
+ * carries a sequence number which tells whether it is ready to be written
+ * or read for a given position. Senders and receivers claim positions with
+ * a single compare-and-swap and afterwards access their slot without any
+ * further synchronization. A thread only blocks (on an
+ * outpost::rtos::BinarySemaphore) if it has to wait for an empty queue to
+ * be filled or for a full queue to be drained.
+ *
+ * \tparam T Type of the items, e.g. SharedBufferPointer
+ * \tparam N Capacity of the queue, must be a power of two and at least two
+ */
+template <typename T, size_t N>
+class MpmcReferenceQueue : public ReferenceQueueBase<T>
+{
+public:
+    // With a single slot the sequence number of a filled slot equals the
+    // one of a free slot in the next round.
+    static_assert((N > 1) && ((N & (N - 1)) == 0),
+                  "The capacity must be a power of two and at least two");
+    static_assert(N <= 0x8000, "The number of items must fit into uint16_t");
+
+    MpmcReferenceQueue();
+
+    // Disable copy constructor
+    MpmcReferenceQueue(const MpmcReferenceQueue&) = delete;
+
+    // Disable copy assignment operator
+    MpmcReferenceQueue&
+    operator=(const MpmcReferenceQueue&) = delete;
+
+    /**
+     * \brief Send a copy of the data to the queue.
+     * \see ReferenceQueueBase::send(T&)
+     */
+    bool
+    send(T& data) override;
+
+    /**
+     * \brief Move data into the queue.
+     * \see ReferenceQueueBase::send(T&&)
+     */
+    bool
+    send(T&& data) override;
+
+    /**
+     * \brief Move data into the queue, waiting for a free slot.
+     *
+     * \param data Data to be sent, left unchanged if the queue stayed full.
+     * \param timeout Duration for which the caller is willing to wait for a free slot
+     * \return Returns true if data could be sent, false otherwise.
+     */
+    bool
+    send(T&& data, outpost::time::Duration timeout);
+
+    /**
+     * \brief Receive data from the queue.
+     * \see ReferenceQueueBase::receive(T&, outpost::time::Duration)
+     */
+    bool
+    receive(T& data,
+            outpost::time::Duration timeout = outpost::time::Duration::infinity()) override;
+
+    /**
+     * \brief Move several items into the queue, notifying the receiver once.
+     * \see ReferenceQueueBase::sendBatch(outpost::Slice<T>)
+     */
+    size_t
+    sendBatch(outpost::Slice<T> data) override;
+
+    /**
+     * \brief Receive several items, notifying waiting senders once.
+     * \see ReferenceQueueBase::receiveBatch(outpost::Slice<T>, size_t, outpost::time::Duration)
+     */
+    size_t
+    receiveBatch(outpost::Slice<T> data,
+                 size_t minItems = 1,
+                 outpost::time::Duration timeout = outpost::time::Duration::infinity()) override;
+
+    uint16_t
+    getNumberOfItems() override;
+
+    bool
+    isEmpty() override;
+
+    bool
+    isFull() override;
+
+private:
+    static constexpr size_t mask = N - 1;
+
+    struct Slot
+    {
+        std::atomic<size_t> mSequence;
+        T mItem;
+    };
+
+    bool
+    trySend(T& data);
+
+    bool
+    tryReceive(T& data);
+
+    size_t
+    tryReceiveBatch(outpost::Slice<T> data, size_t& received);
+
+    std::atomic<size_t> mReceivePosition;
+
+    Slot mSlots[N];
+
+    std::atomic<size_t> mSendPosition;
+
+    reference_queue::WaitList mReceivers;
+    reference_queue::WaitList mSenders;
+};
+
+}  // namespace utils
+}  // namespace outpost
+
+// ----------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------
+
+template <typename Operation>
+bool
+outpost::utils::reference_queue::WaitList::wait(Operation operation,
+                                                outpost::time::Duration timeout)
+{
+    if (operation())
+    {
+        return true;
+    }
+    if (timeout <= outpost::time::Duration::zero())
+    {
+        return false;
+    }
+
+    outpost::rtos::SystemClock clock;
+    const bool infinite = (timeout == outpost::time::Duration::infinity());
+    const outpost::time::SpacecraftElapsedTime deadline =
+            infinite ? clock.now() : (clock.now() + timeout);
+
+    mWaiting.fetch_add(1, std::memory_order_relaxed);
+    // Pairs with the fence in notify(): either the retry below sees the
+    // update of the other side, or the other side sees the waiting thread.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool success = operation();
+    while (!success)
+    {
+        outpost::time::Duration remaining = outpost::time::Duration::infinity();
+        if (!infinite)
+        {
+            remaining = deadline - clock.now();
+            if (remaining <= outpost::time::Duration::zero())
+            {
+                break;
+            }
+        }
+
+        const bool signaled = mSignal.acquire(remaining);
+        success = operation();
+        if (!signaled)
+        {
+            break;
+        }
+    }
+
+    mWaiting.fetch_sub(1, std::memory_order_relaxed);
+    if (success)
+    {
+        // A single signal might have been issued for several updates, pass
+        // it on to the next waiting thread.
+        notify();
+    }
+    return success;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, size_t N>
+outpost::utils::SpscReferenceQueue<T, N>::SpscReferenceQueue() :
+    mHead(0),
+    mCachedTail(0),
+    mTail(0),
+    mCachedHead(0)
+{
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::send(T& data)
+{
+    T copy(data);
+    return send(std::move(copy));
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::send(T&& data)
+{
+    if (trySend(data))
+    {
+        mReceivers.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::send(T&& data, outpost::time::Duration timeout)
+{
+    if (mSenders.wait([&]() { return trySend(data); }, timeout))
+    {
+        mReceivers.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::receive(T& data, outpost::time::Duration timeout)
+{
+    if (mReceivers.wait([&]() { return tryReceive(data); }, timeout))
+    {
+        mSenders.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::SpscReferenceQueue<T, N>::sendBatch(outpost::Slice<T> data)
+{
+    size_t sent = 0;
+    while ((sent < data.getNumberOfElements()) && trySend(data[sent]))
+    {
+        sent++;
+    }
+    if (sent > 0)
+    {
+        mReceivers.notify();
+    }
+    return sent;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::SpscReferenceQueue<T, N>::receiveBatch(outpost::Slice<T> data,
+                                                       size_t minItems,
+                                                       outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+
+    size_t received = 0;
+    mReceivers.wait([&]() { return tryReceiveBatch(data, received) >= requiredItems; }, timeout);
+    if (received > 0)
+    {
+        mSenders.notify();
+    }
+    return received;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::SpscReferenceQueue<T, N>::tryReceiveBatch(outpost::Slice<T> data, size_t& received)
+{
+    while ((received < data.getNumberOfElements()) && tryReceive(data[received]))
+    {
+        received++;
+    }
+    return received;
+}
+
+template <typename T, size_t N>
+uint16_t
+outpost::utils::SpscReferenceQueue<T, N>::getNumberOfItems()
+{
+    const size_t head = mHead.load(std::memory_order_acquire);
+    const size_t tail = mTail.load(std::memory_order_acquire);
+    return static_cast<uint16_t>(tail - head);
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::isEmpty()
+{
+    return getNumberOfItems() == 0;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::isFull()
+{
+    return getNumberOfItems() >= N;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::trySend(T& data)
+{
+    const size_t tail = mTail.load(std::memory_order_relaxed);
+    if (tail - mCachedHead >= N)
+    {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        if (tail - mCachedHead >= N)
+        {
+            return false;
+        }
+    }
+
+    mItems[tail & mask] = std::move(data);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::SpscReferenceQueue<T, N>::tryReceive(T& data)
+{
+    const size_t head = mHead.load(std::memory_order_relaxed);
+    if (head == mCachedTail)
+    {
+        mCachedTail = mTail.load(std::memory_order_acquire);
+        if (head == mCachedTail)
+        {
+            return false;
+        }
+    }
+
+    data = std::move(mItems[head & mask]);
+    mHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+template <typename T, size_t N>
+outpost::utils::MpmcReferenceQueue<T, N>::MpmcReferenceQueue() :
+    mReceivePosition(0),
+    mSendPosition(0)
+{
+    for (size_t i = 0; i < N; ++i)
+    {
+        mSlots[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::send(T& data)
+{
+    T copy(data);
+    return send(std::move(copy));
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::send(T&& data)
+{
+    if (trySend(data))
+    {
+        mReceivers.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::send(T&& data, outpost::time::Duration timeout)
+{
+    if (mSenders.wait([&]() { return trySend(data); }, timeout))
+    {
+        mReceivers.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::receive(T& data, outpost::time::Duration timeout)
+{
+    if (mReceivers.wait([&]() { return tryReceive(data); }, timeout))
+    {
+        mSenders.notify();
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::MpmcReferenceQueue<T, N>::sendBatch(outpost::Slice<T> data)
+{
+    size_t sent = 0;
+    while ((sent < data.getNumberOfElements()) && trySend(data[sent]))
+    {
+        sent++;
+    }
+    if (sent > 0)
+    {
+        mReceivers.notify();
+    }
+    return sent;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::MpmcReferenceQueue<T, N>::receiveBatch(outpost::Slice<T> data,
+                                                       size_t minItems,
+                                                       outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+
+    size_t received = 0;
+    mReceivers.wait([&]() { return tryReceiveBatch(data, received) >= requiredItems; }, timeout);
+    if (received > 0)
+    {
+        mSenders.notify();
+    }
+    return received;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::MpmcReferenceQueue<T, N>::tryReceiveBatch(outpost::Slice<T> data, size_t& received)
+{
+    while ((received < data.getNumberOfElements()) && tryReceive(data[received]))
+    {
+        received++;
+    }
+    return received;
+}
+
+template <typename T, size_t N>
+uint16_t
+outpost::utils::MpmcReferenceQueue<T, N>::getNumberOfItems()
+{
+    const size_t receivePosition = mReceivePosition.load(std::memory_order_acquire);
+    const size_t sendPosition = mSendPosition.load(std::memory_order_acquire);
+
+    // Positions are claimed before the slots are filled or emptied, the
+    // result is therefore only a snapshot.
+    const ptrdiff_t items = static_cast<ptrdiff_t>(sendPosition - receivePosition);
+    if (items < 0)
+    {
+        return 0;
+    }
+    return static_cast<uint16_t>((static_cast<size_t>(items) > N) ? N : items);
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::isEmpty()
+{
+    return getNumberOfItems() == 0;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::isFull()
+{
+    return getNumberOfItems() >= N;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::trySend(T& data)
+{
+    size_t position = mSendPosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true)
+    {
+        slot = &mSlots[position & mask];
+        const size_t sequence = slot->mSequence.load(std::memory_order_acquire);
+        const ptrdiff_t difference =
+                static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position);
+        if (difference == 0)
+        {
+            // Slot is free for this position, try to claim it
+            if (mSendPosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Slot still holds the item of the previous round
+            return false;
+        }
+        else
+        {
+            position = mSendPosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->mItem = std::move(data);
+    slot->mSequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T, size_t N>
+bool
+outpost::utils::MpmcReferenceQueue<T, N>::tryReceive(T& data)
+{
+    size_t position = mReceivePosition.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true)
+    {
+        slot = &mSlots[position & mask];
+        const size_t sequence = slot->mSequence.load(std::memory_order_acquire);
+        const ptrdiff_t difference =
+                static_cast<ptrdiff_t>(sequence) - static_cast<ptrdiff_t>(position + 1);
+        if (difference == 0)
+        {
+            // Slot holds the item for this position, try to claim it
+            if (mReceivePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Slot has not been written yet
+            return false;
+        }
+        else
+        {
+            position = mReceivePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    data = std::move(slot->mItem);
+    slot->mSequence.store(position + N, std::memory_order_release);
+    return true;
+}
+
+#endif
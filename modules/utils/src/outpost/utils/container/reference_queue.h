@@ -15,9 +15,13 @@
 #ifndef OUTPOST_UTILS_REFERENCE_QUEUE_H_
 #define OUTPOST_UTILS_REFERENCE_QUEUE_H_
 
+#include <outpost/base/slice.h>
+#include <outpost/rtos/clock.h>
 #include <outpost/rtos/queue.h>
 #include <outpost/utils/container/shared_buffer.h>
 
+#include <utility>
+
 namespace outpost
 {
 namespace utils
@@ -28,11 +32,14 @@ namespace utils
  *
  * The standard RTOS/POSIX queues are not capable of handling classes that may not be used as a
  * pointer (e.g. using reference counting), since they use pointers or standard constructors instead
- * of references. Hence, ReferenceQueueBase inherits from outpost::rtos::Queue and adds a wrapper
- * that keeps the references.
+ * of references. Hence, ReferenceQueueBase defines an interface that keeps the references.
+ *
+ * \see ReferenceQueue
+ * \see SpscReferenceQueue
+ * \see MpmcReferenceQueue
  */
 template <typename T>
-class ReferenceQueueBase : public outpost::rtos::Queue<size_t>
+class ReferenceQueueBase
 {
 public:
     /**
@@ -48,6 +55,23 @@ public:
     virtual bool
     send(T& data) = 0;
 
+    /**
+     * \brief Moves data into the queue.
+     *
+     * In contrast to send(T&) the caller hands over its reference, e.g. for a
+     * SharedBufferPointer the reference count is not changed. If the data could not
+     * be sent, \p data is left unchanged.
+     *
+     * The default implementation falls back to send(T&).
+     * \param data Data to be sent.
+     * \return Returns true if data could be sent, false otherwise.
+     */
+    virtual bool
+    send(T&& data)
+    {
+        return send(data);
+    }
+
     /**
      * \brief Receives data from the queue.
      *
@@ -60,6 +84,38 @@ public:
     virtual bool
     receive(T& data, outpost::time::Duration timeout = outpost::time::Duration::infinity()) = 0;
 
+    /**
+     * \brief Moves several items into the queue.
+     *
+     * Items are taken from the beginning of \p data until the queue is full.
+     * Sent items are moved from, the remaining ones are left unchanged.
+     *
+     * The default implementation calls send(T&&) for every item.
+     * \param data Items to be sent.
+     * \return Returns the number of items sent.
+     */
+    virtual size_t
+    sendBatch(outpost::Slice<T> data);
+
+    /**
+     * \brief Receives several items from the queue.
+     *
+     * Waits until \p minItems items (limited to the size of \p data) have
+     * been received or the timeout expired. Afterwards all further items
+     * available are received without waiting, as long as they fit into
+     * \p data. A consumer can thereby drain the queue with a single call.
+     *
+     * The default implementation calls receive() for every item.
+     * \param data Buffer for the received items.
+     * \param minItems Number of items to wait for.
+     * \param timeout Duration for which the caller is willing to wait for incoming data
+     * \return Returns the number of items received.
+     */
+    virtual size_t
+    receiveBatch(outpost::Slice<T> data,
+                 size_t minItems = 1,
+                 outpost::time::Duration timeout = outpost::time::Duration::infinity());
+
     /**
      * \brief Getter function for the number of items currently stored in the queue.
      * \return Returns the number of items in the queue that are ready for receiving.
@@ -85,16 +141,14 @@ public:
 protected:
     /**
      * \brief Constructor for a ReferenceQueueBase. May only be called by its derivatives (i.e.
-     * ReferenceQueue) \param N Maximum number of elements in the queue
+     * ReferenceQueue)
      */
-    inline ReferenceQueueBase(size_t N) : outpost::rtos::Queue<size_t>(N)
-    {
-    }
+    ReferenceQueueBase() = default;
 };
 
 /**
  * \ingroup SharedBuffer
- * \brief Implementation of a outpost::rtos::Queue that stores all additional information needed for
+ * \brief Wrapper around an outpost::rtos::Queue that stores all additional information needed for
  * passing instances of classes that cannot be sent as pointers.
  */
 template <typename T, size_t N>
@@ -104,7 +158,7 @@ public:
     /**
      * \brief Standard constructor.
      */
-    ReferenceQueue() : ReferenceQueueBase<T>(N), mItemsInQueue(0), mLastIndex(0)
+    ReferenceQueue() : mIndices(N), mItemsInQueue(0), mLastIndex(0)
     {
         for (size_t i = 0; i < N; i++)
         {
@@ -156,6 +210,19 @@ public:
      */
     virtual bool
     send(T& data) override
+    {
+        T copy(data);
+        return send(std::move(copy));
+    }
+
+    /**
+     * \brief Move data into the queue.
+     * \see ReferenceQueueBase::send(T&&)
+     * \param data Data to be sent, left unchanged if the queue is full.
+     * \return Returns true if data could be sent, false otherwise.
+     */
+    virtual bool
+    send(T&& data) override
     {
         outpost::rtos::MutexGuard lock(mMutex);
         bool res = false;
@@ -166,10 +233,10 @@ public:
         {
             if (!mIsUsed[i])
             {
-                mPointers[i] = data;
+                mPointers[i] = std::move(data);
                 mIsUsed[i] = true;
                 mLastIndex = (i + 1) % N;
-                if (outpost::rtos::Queue<size_t>::send(i))
+                if (mIndices.send(i))
                 {
                     mItemsInQueue++;
                     res = true;
@@ -177,7 +244,7 @@ public:
                 else
                 {
                     mIsUsed[i] = false;
-                    mPointers[i] = mEmpty;
+                    data = std::move(mPointers[i]);
                 }
                 break;
             }
@@ -201,11 +268,10 @@ public:
     {
         bool res = false;
         size_t index;
-        if (outpost::rtos::Queue<size_t>::receive(index, timeout))
+        if (mIndices.receive(index, timeout))
         {
             outpost::rtos::MutexGuard lock(mMutex);
-            data = mPointers[index];
-            mPointers[index] = mEmpty;
+            data = std::move(mPointers[index]);
             mIsUsed[index] = false;
             mItemsInQueue--;
             res = true;
@@ -224,9 +290,47 @@ public:
         return mItemsInQueue;
     }
 
+    /**
+     * \brief Adds the queue to an outpost::rtos::QueueSet.
+     *
+     * The set then reports every item sent to this queue. For every
+     * successful outpost::rtos::QueueSet::wait() reporting this queue exactly
+     * one item has to be received.
+     *
+     * \param set Set to add the queue to
+     * \return Returns false if the queue could not be added.
+     */
+    template <typename Set>
+    inline bool
+    addTo(Set& set)
+    {
+        return set.add(mIndices);
+    }
+
+    /**
+     * \brief Move several items into the queue while holding the lock only once.
+     * \see ReferenceQueueBase::sendBatch(outpost::Slice<T>)
+     */
+    virtual size_t
+    sendBatch(outpost::Slice<T> data) override;
+
+    /**
+     * \brief Receive several items from the queue while holding the lock only once.
+     * \see ReferenceQueueBase::receiveBatch(outpost::Slice<T>, size_t, outpost::time::Duration)
+     */
+    virtual size_t
+    receiveBatch(outpost::Slice<T> data,
+                 size_t minItems = 1,
+                 outpost::time::Duration timeout = outpost::time::Duration::infinity()) override;
+
 private:
-    T mEmpty;
+    /**
+     * Number of indices handled at once by sendBatch() and receiveBatch().
+     * Limits the stack usage independent of the size of the queue.
+     */
+    static constexpr size_t batchChunkSize = (N < 16) ? N : 16;
 
+    outpost::rtos::Queue<size_t> mIndices;
     outpost::rtos::Mutex mMutex;
 
     uint16_t mItemsInQueue;
@@ -244,4 +348,168 @@ using SharedBufferQueue = ReferenceQueue<SharedBufferPointer, N>;
 }  // namespace utils
 }  // namespace outpost
 
+// ----------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------
+
+template <typename T>
+size_t
+outpost::utils::ReferenceQueueBase<T>::sendBatch(outpost::Slice<T> data)
+{
+    size_t sent = 0;
+    while ((sent < data.getNumberOfElements()) && send(std::move(data[sent])))
+    {
+        sent++;
+    }
+    return sent;
+}
+
+template <typename T>
+size_t
+outpost::utils::ReferenceQueueBase<T>::receiveBatch(outpost::Slice<T> data,
+                                                    size_t minItems,
+                                                    outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+    const bool infinite = (timeout == outpost::time::Duration::infinity());
+
+    outpost::rtos::SystemClock clock;
+    const outpost::time::SpacecraftElapsedTime deadline =
+            infinite ? clock.now() : (clock.now() + timeout);
+
+    size_t received = 0;
+    while (received < maximumItems)
+    {
+        // Only wait for the required items, take the others if available
+        outpost::time::Duration remaining = outpost::time::Duration::zero();
+        if (received < requiredItems)
+        {
+            remaining = infinite ? timeout : (deadline - clock.now());
+            if (remaining < outpost::time::Duration::zero())
+            {
+                remaining = outpost::time::Duration::zero();
+            }
+        }
+
+        if (!receive(data[received], remaining))
+        {
+            break;
+        }
+        received++;
+    }
+    return received;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::ReferenceQueue<T, N>::sendBatch(outpost::Slice<T> data)
+{
+    outpost::rtos::MutexGuard lock(mMutex);
+
+    size_t sent = 0;
+    while (sent < data.getNumberOfElements())
+    {
+        size_t indices[batchChunkSize];
+        size_t count = 0;
+        size_t index = mLastIndex;
+        for (size_t searched = 0; (searched < N) && (count < batchChunkSize)
+                                  && ((sent + count) < data.getNumberOfElements());
+             searched++)
+        {
+            if (!mIsUsed[index])
+            {
+                mPointers[index] = std::move(data[sent + count]);
+                mIsUsed[index] = true;
+                indices[count] = index;
+                count++;
+                mLastIndex = (index + 1) % N;
+            }
+            index = (index + 1) % N;
+        }
+
+        const size_t chunkSent =
+                mIndices.sendBatch(outpost::Slice<const size_t>::unsafe(indices, count));
+        for (size_t i = chunkSent; i < count; i++)
+        {
+            mIsUsed[indices[i]] = false;
+            data[sent + i] = std::move(mPointers[indices[i]]);
+        }
+        mItemsInQueue = static_cast<uint16_t>(mItemsInQueue + chunkSent);
+        sent += chunkSent;
+
+        if ((count == 0) || (chunkSent < count))
+        {
+            // Queue is full
+            break;
+        }
+    }
+
+    return sent;
+}
+
+template <typename T, size_t N>
+size_t
+outpost::utils::ReferenceQueue<T, N>::receiveBatch(outpost::Slice<T> data,
+                                                   size_t minItems,
+                                                   outpost::time::Duration timeout)
+{
+    const size_t maximumItems = data.getNumberOfElements();
+    const size_t requiredItems = (minItems < maximumItems) ? minItems : maximumItems;
+    const bool infinite = (timeout == outpost::time::Duration::infinity());
+
+    outpost::rtos::SystemClock clock;
+    const outpost::time::SpacecraftElapsedTime deadline =
+            infinite ? clock.now() : (clock.now() + timeout);
+
+    size_t received = 0;
+    while (received < maximumItems)
+    {
+        size_t chunk = maximumItems - received;
+        if (chunk > batchChunkSize)
+        {
+            chunk = batchChunkSize;
+        }
+
+        // Only wait for the required items, take the others if available
+        size_t chunkRequired = 0;
+        outpost::time::Duration remaining = outpost::time::Duration::zero();
+        if (received < requiredItems)
+        {
+            chunkRequired = requiredItems - received;
+            if (chunkRequired > chunk)
+            {
+                chunkRequired = chunk;
+            }
+
+            remaining = infinite ? timeout : (deadline - clock.now());
+            if (remaining < outpost::time::Duration::zero())
+            {
+                remaining = outpost::time::Duration::zero();
+            }
+        }
+
+        size_t indices[batchChunkSize];
+        const size_t chunkReceived = mIndices.receiveBatch(
+                outpost::Slice<size_t>::unsafe(indices, chunk), chunkRequired, remaining);
+
+        outpost::rtos::MutexGuard lock(mMutex);
+        for (size_t i = 0; i < chunkReceived; i++)
+        {
+            data[received + i] = std::move(mPointers[indices[i]]);
+            mIsUsed[indices[i]] = false;
+        }
+        mItemsInQueue = static_cast<uint16_t>(mItemsInQueue - chunkReceived);
+        received += chunkReceived;
+
+        if (chunkReceived < chunk)
+        {
+            // Queue is empty or the timeout expired
+            break;
+        }
+    }
+
+    return received;
+}
+
 #endif /* OUTPOST_UTILS_REFERENCE_QUEUE_H_ */
@@ -14,13 +14,20 @@
 
 #include "shared_buffer.h"
 
+#include "shared_object_pool.h"
+
 namespace outpost
 {
 namespace utils
 {
+#ifndef OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
 outpost::rtos::Mutex SharedBuffer::mMutex;
+#endif
 
-SharedBuffer::SharedBuffer() : mReferenceCounter(0), mBuffer(outpost::Slice<uint8_t>::empty())
+SharedBuffer::SharedBuffer() :
+    mReferenceCounter(0),
+    mBuffer(outpost::Slice<uint8_t>::empty()),
+    mPool(nullptr)
 {
 }
 
@@ -29,15 +36,9 @@ SharedBuffer::~SharedBuffer()
 }
 
 void
-SharedBuffer::incrementCount()
-{
-    SharedBuffer::incrementCountAtomic(mReferenceCounter);
-}
-
-void
-SharedBuffer::decrementCount()
+SharedBuffer::releaseToPool()
 {
-    SharedBuffer::decrementCountAtomic(mReferenceCounter);
+    mPool->release(*this);
 }
 
 bool
@@ -21,11 +21,29 @@
 #include <string.h>
 
 #include <array>
+#include <atomic>
+#include <utility>
+
+/**
+ * \def OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+ * Selects lock-free reference counting with std::atomic.
+ *
+ * Enabled automatically if the target supports lock-free atomic
+ * operations on integers. Otherwise, or if OUTPOST_UTILS_SHARED_BUFFER_MUTEX
+ * is defined, all reference counters are protected by a single
+ * outpost::rtos::Mutex.
+ */
+#if !defined(OUTPOST_UTILS_SHARED_BUFFER_MUTEX) && (ATOMIC_INT_LOCK_FREE == 2) \
+        && (ATOMIC_LONG_LOCK_FREE == 2)
+#define OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+#endif
 
 namespace outpost
 {
 namespace utils
 {
+class SharedBufferPoolBase;
+
 /**
  * \ingroup SharedBuffer
  * \brief Reference counting byte buffer as the underlying data structure for the
@@ -47,7 +65,10 @@ public:
      * bytes.
      * \param slice Slice holding the byte array.
      */
-    explicit SharedBuffer(outpost::Slice<uint8_t> slice) : mReferenceCounter(0), mBuffer(slice)
+    explicit SharedBuffer(outpost::Slice<uint8_t> slice) :
+        mReferenceCounter(0),
+        mBuffer(slice),
+        mPool(nullptr)
     {
     }
 
@@ -100,8 +121,8 @@ public:
     }
 
     /**
-     * \brief Getter function for the usage state of the SharedBuffer. Calls outpost::rtos::Mutex
-     * protected functions internally.
+     * \brief Getter function for the usage state of the SharedBuffer. Thread-safe, see
+     * OUTPOST_UTILS_SHARED_BUFFER_ATOMIC.
      * \return Returns true if the SharedBuffer is currently in use, false otherwise.
      */
     inline bool
@@ -117,7 +138,7 @@ public:
     inline size_t
     getReferenceCount() const
     {
-        return mReferenceCounter;
+        return loadCount(mReferenceCounter);
     }
 
     /**
@@ -132,24 +153,98 @@ public:
 
 private:
     friend class SharedBufferPointer;
+    friend class SharedBufferPoolBase;
 
     /**
      * \brief Increments the reference count.
      *
      * Used by its friend class SharedBufferPointer, it does not need to be called manually.
-     * Uses outpost::rtos::Mutex protected functions internally for mutual exclusion.
      */
-    void
-    incrementCount();
+    inline void
+    incrementCount()
+    {
+        SharedBuffer::incrementCountAtomic(mReferenceCounter);
+    }
 
     /**
      * \brief Decrements the reference count.
      *
+     * Hands the buffer back to its pool when the last reference is dropped.
      * Used by its friend class SharedBufferPointer, it does not need to be called manually.
-     * Uses outpost::rtos::Mutex protected functions internally for mutual exclusion.
      */
+    inline void
+    decrementCount()
+    {
+        if (SharedBuffer::decrementCountAtomic(mReferenceCounter) && (mPool != nullptr))
+        {
+            releaseToPool();
+        }
+    }
+
     void
-    decrementCount();
+    releaseToPool();
+
+#ifdef OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+    typedef std::atomic<size_t> ReferenceCounter;
+
+    /**
+     * \brief Lock-free access to the usage state, derived from the reference counter.
+     *
+     * Acquire semantics, pairs with the release in decrementCountAtomic(): all
+     * accesses to the data done by the previous users are visible once the buffer
+     * is seen as unused.
+     * \param ref Reference counter to be checked.
+     */
+    inline static bool
+    isUsedAtomic(const ReferenceCounter& ref)
+    {
+        return ref.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * \brief Lock-free increment of the reference counter.
+     *
+     * A new reference is always created from an existing one, therefore no
+     * ordering is required.
+     * \param ref Reference counter to be incremented.
+     */
+    inline static void
+    incrementCountAtomic(ReferenceCounter& ref)
+    {
+        ref.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Lock-free decrement of the reference counter.
+     *
+     * Never decrements below zero.
+     * \param ref Reference counter to be decremented.
+     * \return Returns true if the last reference was dropped.
+     */
+    inline static bool
+    decrementCountAtomic(ReferenceCounter& ref)
+    {
+        size_t current = ref.load(std::memory_order_relaxed);
+        while (current > 0)
+        {
+            if (ref.compare_exchange_weak(current,
+                                          current - 1,
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_relaxed))
+            {
+                return (current == 1);
+            }
+        }
+        return false;
+    }
+
+    inline static size_t
+    loadCount(const ReferenceCounter& ref)
+    {
+        return ref.load(std::memory_order_relaxed);
+    }
+#else
+    typedef size_t ReferenceCounter;
 
     /**
      * \brief outpost::rtos::Mutex protected access to the usage state, derived from the reference
@@ -160,7 +255,7 @@ private:
      * \param ref Reference counter to be checked.
      */
     inline static bool
-    isUsedAtomic(const size_t& ref)
+    isUsedAtomic(const ReferenceCounter& ref)
     {
         outpost::rtos::MutexGuard lock(mMutex);
         return ref != 0;
@@ -174,7 +269,7 @@ private:
      * \param ref Reference counter to be incremented.
      */
     inline static void
-    incrementCountAtomic(size_t& ref)
+    incrementCountAtomic(ReferenceCounter& ref)
     {
         outpost::rtos::MutexGuard lock(mMutex);
         ref++;
@@ -186,31 +281,47 @@ private:
      * Called internally by the member function isUsed().
      * Does not need to be called manually.
      * \param ref Reference counter to be decremented.
+     * \return Returns true if the last reference was dropped.
      */
-    inline static void
-    decrementCountAtomic(size_t& ref)
+    inline static bool
+    decrementCountAtomic(ReferenceCounter& ref)
     {
         outpost::rtos::MutexGuard lock(mMutex);
         if (ref > 0)
         {
             ref--;
+            return (ref == 0);
         }
+        return false;
+    }
+
+    inline static size_t
+    loadCount(const ReferenceCounter& ref)
+    {
+        return ref;
     }
 
     /**
      * \brief outpost::rtos::Mutex for allowing only one reference counter to be changed at a time.
      */
     static outpost::rtos::Mutex mMutex;
+#endif
 
     /**
      * \brief Reference counter for the current usage state.
      */
-    size_t mReferenceCounter;
+    ReferenceCounter mReferenceCounter;
 
     /**
      * \brief Pointer to the underlying byte array.
      */
     outpost::Slice<uint8_t> mBuffer;
+
+    /**
+     * \brief Pool the buffer is returned to when the last reference is dropped, nullptr
+     * for buffers not managed by a pool.
+     */
+    SharedBufferPoolBase* mPool;
 };
 
 class SharedChildPointer;
@@ -271,15 +382,18 @@ public:
     /**
      * \brief Move constructor for a SharedBufferPointer instance.
      *
+     * Takes over the reference of \p other without changing the reference count.
+     * \p other is left as an empty (invalid) SharedBufferPointer.
+     *
      * \param other Reference of the SharedBufferPointer instance to be moved.
      */
-    SharedBufferPointer(const SharedBufferPointer&& other) :
+    SharedBufferPointer(SharedBufferPointer&& other) :
         mPtr(other.mPtr),
         mType(other.mType),
         mOffset(other.mOffset),
         mLength(other.mLength)
     {
-        incrementCount();
+        other.release();
     }
 
     /**
@@ -322,10 +436,14 @@ public:
     /**
      * \brief Move operator for a SharedBufferPointer instance.
      *
+     * Releases the current reference and takes over the reference of \p other
+     * without changing its reference count. \p other is left as an empty (invalid)
+     * SharedBufferPointer.
+     *
      * \param other Reference of the SharedBufferPointer instance to be moved.
      */
     SharedBufferPointer&
-    operator=(const SharedBufferPointer&& other)
+    operator=(SharedBufferPointer&& other)
     {
         if (&other != this)
         {
@@ -334,7 +452,7 @@ public:
             mType = other.mType;
             mOffset = other.mOffset;
             mLength = other.mLength;
-            incrementCount();
+            other.release();
         }
         return *this;
     }
@@ -557,6 +675,20 @@ public:
     }
 
 protected:
+    /**
+     * \brief Resets the pointer without changing the reference count.
+     *
+     * Used after the reference has been handed over to another instance.
+     */
+    inline void
+    release()
+    {
+        mPtr = nullptr;
+        mType = 0;
+        mOffset = 0;
+        mLength = 0;
+    }
+
     void
     incrementCount() const
     {
@@ -609,11 +741,14 @@ public:
     /**
      * \brief Move constructor for a SharedChildPointer instance.
      *
+     * Takes over the references to the buffer and the parent of \p other without
+     * changing the reference counts.
+     *
      * \param other Reference of the SharedChildPointer instance to be moved.
      */
-    SharedChildPointer(const SharedChildPointer&& other) :
-        SharedBufferPointer(other),
-        mParent(other.mParent)
+    SharedChildPointer(SharedChildPointer&& other) :
+        SharedBufferPointer(std::move(other)),
+        mParent(std::move(other.mParent))
     {
     }
 
@@ -644,17 +779,12 @@ public:
      * \param other Reference of the SharedChildPointer instance to be moved.
      */
     SharedChildPointer&
-    operator=(const SharedChildPointer&& other)
+    operator=(SharedChildPointer&& other)
     {
         if (&other != this)
         {
-            decrementCount();
-            mPtr = other.mPtr;
-            mType = other.mType;
-            mOffset = other.mOffset;
-            mLength = other.mLength;
-            mParent = other.mParent;
-            incrementCount();
+            SharedBufferPointer::operator=(std::move(other));
+            mParent = std::move(other.mParent);
         }
         return *this;
     }
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_UTILS_SHARED_BUFFER_CACHE_H
+#define OUTPOST_UTILS_SHARED_BUFFER_CACHE_H
+
+#include "shared_object_pool.h"
+
+#include <outpost/base/slice.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+namespace outpost
+{
+namespace utils
+{
+/**
+ * \ingroup SharedBuffer
+ * \brief Per-thread magazine of buffers in front of a SharedBufferPool.
+ *
+ * Threads with a high allocation rate keep a small stash of buffers taken
+ * from the shared pool. Allocations are served from the stash without
+ * touching the pool. An empty stash is refilled with a single
+ * SharedBufferPoolBase::allocateBatch() call.
+ *
+ * Buffers always return to the pool they have been allocated from when
+ * their last reference is dropped, independent of the thread dropping it.
+ * At most \p M buffers are held back by a single cache. Use flush() to
+ * hand them back to the pool, e.g. before a thread becomes idle.
+ *
+ * A cache must only be used by the thread owning it. Instead of relying on
+ * thread local storage, which is not available on all targets, every thread
+ * creates its own instance and passes it as SharedBufferPoolBase to the code
+ * allocating the buffers.
+ *
+ * \code
+ * SharedBufferPool<1024, 64> pool;
+ *
+ * // Owned by the dispatcher thread
+ * SharedBufferCache<8> cache(pool);
+ * ProtocolDispatcher<uint8_t, 4> dispatcher(...);
+ * dispatcher.addQueue(id, &cache, &queue);
+ * \endcode
+ *
+ * \tparam M Maximum number of buffers held by the cache
+ */
+template <size_t M>
+class SharedBufferCache : public SharedBufferPoolBase
+{
+public:
+    static_assert(M > 0, "A SharedBufferCache needs to hold at least one buffer");
+
+    /**
+     * \param pool
+     *      Pool to take the buffers from.
+     * \param refillCount
+     *      Number of buffers requested from the pool when the cache is
+     *      empty. Limited to \p M.
+     */
+    explicit SharedBufferCache(SharedBufferPoolBase& pool, size_t refillCount = (M + 1) / 2);
+
+    /**
+     * Hands all cached buffers back to the pool.
+     */
+    virtual ~SharedBufferCache();
+
+    // Disable copy constructor
+    SharedBufferCache(const SharedBufferCache&) = delete;
+
+    // Disable copy assignment operator
+    SharedBufferCache&
+    operator=(const SharedBufferCache&) = delete;
+
+    using SharedBufferPoolBase::allocate;
+
+    /**
+     * \brief Takes a buffer from the cache, refills the cache from the pool if it is empty.
+     *
+     * \param pointer Reference to the SharedBufferPointer
+     * \return Returns true if a valid SharedBufferPointer was found, otherwise false.
+     */
+    bool
+    allocate(SharedBufferPointer& pointer) override;
+
+    /**
+     * \brief Overall number of elements of the underlying pool.
+     */
+    inline size_t
+    numberOfElements() const override
+    {
+        return mPool.numberOfElements();
+    }
+
+    /**
+     * \brief Element size of the underlying pool.
+     */
+    inline size_t
+    elementSize() const override
+    {
+        return mPool.elementSize();
+    }
+
+    /**
+     * \brief Number of buffers available through this cache.
+     *
+     * Must only be called by the owning thread.
+     *
+     * \return Returns the free elements of the pool plus the buffers held by the cache.
+     */
+    inline size_t
+    numberOfFreeElements() const override
+    {
+        return mPool.numberOfFreeElements() + mNumberOfCachedBuffers;
+    }
+
+    /**
+     * \brief Number of buffers currently held back by the cache.
+     *
+     * Must only be called by the owning thread.
+     */
+    inline size_t
+    getNumberOfCachedBuffers() const
+    {
+        return mNumberOfCachedBuffers;
+    }
+
+    /**
+     * \brief Hands all cached buffers back to the pool.
+     */
+    void
+    flush();
+
+    /**
+     * \brief Number of allocations served from the cache.
+     *
+     * May be read from other threads.
+     */
+    inline uint32_t
+    getNumberOfHits() const
+    {
+        return mHits.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Number of allocations which needed a refill from the pool.
+     *
+     * May be read from other threads.
+     */
+    inline uint32_t
+    getNumberOfMisses() const
+    {
+        return mMisses.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Resets the hit and miss counters.
+     */
+    void
+    resetCounters();
+
+private:
+    static inline void
+    increment(std::atomic<uint32_t>& counter)
+    {
+        // Only written by the owning thread, no read-modify-write needed
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    SharedBufferPoolBase& mPool;
+    const size_t mRefillCount;
+
+    SharedBufferPointer mBuffers[M];
+    size_t mNumberOfCachedBuffers;
+
+    std::atomic<uint32_t> mHits;
+    std::atomic<uint32_t> mMisses;
+};
+
+}  // namespace utils
+}  // namespace outpost
+
+// ----------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------
+
+template <size_t M>
+outpost::utils::SharedBufferCache<M>::SharedBufferCache(SharedBufferPoolBase& pool,
+                                                        size_t refillCount) :
+    mPool(pool),
+    mRefillCount((refillCount == 0) ? 1 : ((refillCount > M) ? M : refillCount)),
+    mNumberOfCachedBuffers(0),
+    mHits(0),
+    mMisses(0)
+{
+}
+
+template <size_t M>
+outpost::utils::SharedBufferCache<M>::~SharedBufferCache()
+{
+    flush();
+}
+
+template <size_t M>
+bool
+outpost::utils::SharedBufferCache<M>::allocate(SharedBufferPointer& pointer)
+{
+    if (mNumberOfCachedBuffers == 0)
+    {
+        increment(mMisses);
+        mNumberOfCachedBuffers = mPool.allocateBatch(
+                outpost::Slice<SharedBufferPointer>::unsafe(mBuffers, mRefillCount));
+        if (mNumberOfCachedBuffers == 0)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        increment(mHits);
+    }
+
+    mNumberOfCachedBuffers--;
+    pointer = std::move(mBuffers[mNumberOfCachedBuffers]);
+    return true;
+}
+
+template <size_t M>
+void
+outpost::utils::SharedBufferCache<M>::flush()
+{
+    while (mNumberOfCachedBuffers > 0)
+    {
+        mNumberOfCachedBuffers--;
+        mBuffers[mNumberOfCachedBuffers] = SharedBufferPointer();
+    }
+}
+
+template <size_t M>
+void
+outpost::utils::SharedBufferCache<M>::resetCounters()
+{
+    mHits.store(0, std::memory_order_relaxed);
+    mMisses.store(0, std::memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "shared_buffer_chain.h"
+
+#include <string.h>
+
+namespace outpost
+{
+namespace utils
+{
+SharedBufferChainBase::SharedBufferChainBase(outpost::Slice<SharedBufferPointer> segments) :
+    mSegments(segments),
+    mNumberOfSegments(0),
+    mLength(0)
+{
+}
+
+bool
+SharedBufferChainBase::append(const SharedBufferPointer& buffer)
+{
+    if (!buffer.isValid() || isFull())
+    {
+        return false;
+    }
+
+    mSegments[mNumberOfSegments] = buffer;
+    mNumberOfSegments++;
+    mLength += buffer.getLength();
+    return true;
+}
+
+bool
+SharedBufferChainBase::append(const SharedBufferPointer& buffer, size_t offset, size_t length)
+{
+    if (isFull())
+    {
+        return false;
+    }
+
+    SharedChildPointer child;
+    if ((offset + length > buffer.getLength())
+        || !buffer.getChild(child, buffer.getType(), offset, length))
+    {
+        return false;
+    }
+    return append(child);
+}
+
+void
+SharedBufferChainBase::clear()
+{
+    for (size_t i = 0; i < mNumberOfSegments; ++i)
+    {
+        mSegments[i] = SharedBufferPointer();
+    }
+    mNumberOfSegments = 0;
+    mLength = 0;
+}
+
+size_t
+SharedBufferChainBase::copyTo(outpost::Slice<uint8_t> destination) const
+{
+    size_t position = 0;
+    for (size_t i = 0; (i < mNumberOfSegments) && (position < destination.getNumberOfElements());
+         ++i)
+    {
+        const outpost::Slice<const uint8_t> segment = mSegments[i];
+        const size_t remaining = destination.getNumberOfElements() - position;
+        const size_t length = (segment.getNumberOfElements() < remaining)
+                                      ? segment.getNumberOfElements()
+                                      : remaining;
+        memcpy(&destination[position], &segment[0], length);
+        position += length;
+    }
+    return position;
+}
+
+void
+SharedBufferChainBase::serialize(outpost::Serialize& stream) const
+{
+    for (size_t i = 0; i < mNumberOfSegments; ++i)
+    {
+        stream.store(getSegment(i));
+    }
+}
+
+}  // namespace utils
+}  // namespace outpost
@@ -0,0 +1,187 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_UTILS_SHARED_BUFFER_CHAIN_H
+#define OUTPOST_UTILS_SHARED_BUFFER_CHAIN_H
+
+#include "shared_buffer.h"
+
+#include <outpost/base/slice.h>
+#include <outpost/utils/storage/serialize.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+
+namespace outpost
+{
+namespace utils
+{
+/**
+ * \ingroup SharedBuffer
+ * \brief Ordered list of buffer segments forming a single message.
+ *
+ * A chain describes a message scattered over several shared buffers, e.g.
+ * a frame header allocated for transmission followed by a payload which is
+ * still stored in the buffer it was received in. Every segment holds a
+ * reference to its buffer, so the data stays valid as long as the chain
+ * exists. The segments are only copied when the message is finally written
+ * into a transmit buffer or serialized.
+ *
+ * \code
+ * SharedBufferChain<2> frame;
+ * frame.append(header);
+ * frame.append(packet, payloadOffset, payloadLength);
+ *
+ * outpost::hal::write(serial, frame);
+ * \endcode
+ *
+ * A chain is not thread-safe. It is built and consumed by a single thread.
+ */
+class SharedBufferChainBase
+{
+public:
+    // Disable copy constructor
+    SharedBufferChainBase(const SharedBufferChainBase&) = delete;
+
+    // Disable copy assignment operator
+    SharedBufferChainBase&
+    operator=(const SharedBufferChainBase&) = delete;
+
+    /**
+     * \brief Appends a buffer as next segment.
+     *
+     * The segment covers the range of \p buffer, i.e. the complete buffer
+     * or the sub-range of a SharedChildPointer.
+     *
+     * \return Returns false if \p buffer is invalid or the chain is full.
+     */
+    bool
+    append(const SharedBufferPointer& buffer);
+
+    /**
+     * \brief Appends a sub-range of a buffer as next segment.
+     *
+     * \param buffer
+     *      Buffer holding the data.
+     * \param offset
+     *      Offset of the segment relative to the range of \p buffer.
+     * \param length
+     *      Length of the segment in bytes.
+     * \return Returns false if \p buffer is invalid, the range exceeds the
+     *      buffer or the chain is full.
+     */
+    bool
+    append(const SharedBufferPointer& buffer, size_t offset, size_t length);
+
+    /**
+     * \brief Drops all segments and the references to their buffers.
+     */
+    void
+    clear();
+
+    inline size_t
+    getNumberOfSegments() const
+    {
+        return mNumberOfSegments;
+    }
+
+    inline size_t
+    getMaximumNumberOfSegments() const
+    {
+        return mSegments.getNumberOfElements();
+    }
+
+    inline bool
+    isEmpty() const
+    {
+        return mNumberOfSegments == 0;
+    }
+
+    inline bool
+    isFull() const
+    {
+        return mNumberOfSegments == mSegments.getNumberOfElements();
+    }
+
+    /**
+     * \brief Total length of all segments in bytes.
+     */
+    inline size_t
+    getLength() const
+    {
+        return mLength;
+    }
+
+    /**
+     * \brief Access the data of a segment.
+     *
+     * \warning
+     *      No out-of-bound error checking is performed.
+     */
+    inline outpost::Slice<const uint8_t>
+    getSegment(size_t index) const
+    {
+        return mSegments[index];
+    }
+
+    /**
+     * \brief Gathers the segments into a contiguous buffer.
+     *
+     * \return Number of bytes copied. Less than getLength() if
+     *      \p destination is too small.
+     */
+    size_t
+    copyTo(outpost::Slice<uint8_t> destination) const;
+
+    /**
+     * \brief Writes the segments onto the output stream.
+     *
+     * The stream has to provide at least getLength() bytes.
+     */
+    void
+    serialize(outpost::Serialize& stream) const;
+
+protected:
+    explicit SharedBufferChainBase(outpost::Slice<SharedBufferPointer> segments);
+
+    ~SharedBufferChainBase() = default;
+
+private:
+    outpost::Slice<SharedBufferPointer> mSegments;
+    size_t mNumberOfSegments;
+    size_t mLength;
+};
+
+/**
+ * \ingroup SharedBuffer
+ * \brief SharedBufferChainBase with storage for up to \p N segments.
+ */
+template <size_t N>
+class SharedBufferChain : public SharedBufferChainBase
+{
+public:
+    static_assert(N > 0, "A SharedBufferChain needs to hold at least one segment");
+
+    inline SharedBufferChain() : SharedBufferChainBase(outpost::asSlice(mStorage))
+    {
+    }
+
+    ~SharedBufferChain() = default;
+
+private:
+    std::array<SharedBufferPointer, N> mStorage;
+};
+
+}  // namespace utils
+}  // namespace outpost
+
+#endif
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "shared_buffer_pool_set.h"
+
+using namespace outpost::utils;
+
+constexpr size_t SharedBufferPoolSet::maximumNumberOfClasses;
+
+SharedBufferPoolSet::SharedBufferPoolSet() : mPools(), mNumberOfClasses(0), mFailedAllocations(0)
+{
+    for (size_t i = 0; i < maximumNumberOfClasses; ++i)
+    {
+        mAllocations[i].store(0, std::memory_order_relaxed);
+        mFallbacks[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool
+SharedBufferPoolSet::addPool(SharedBufferPoolBase& pool)
+{
+    const size_t size = pool.elementSize();
+    if ((mNumberOfClasses >= maximumNumberOfClasses) || (size == 0)
+        || ((size & (size - 1)) != 0) || (size <= elementSize()))
+    {
+        return false;
+    }
+
+    mPools[mNumberOfClasses] = &pool;
+    mNumberOfClasses++;
+    return true;
+}
+
+bool
+SharedBufferPoolSet::allocate(SharedBufferPointer& pointer)
+{
+    return allocate(pointer, elementSize());
+}
+
+bool
+SharedBufferPoolSet::allocate(SharedBufferPointer& pointer, size_t minimumSize)
+{
+    bool bestFit = true;
+    for (size_t i = 0; i < mNumberOfClasses; ++i)
+    {
+        if (mPools[i]->elementSize() >= minimumSize)
+        {
+            if (mPools[i]->allocate(pointer))
+            {
+                mAllocations[i].fetch_add(1, std::memory_order_relaxed);
+                if (!bestFit)
+                {
+                    mFallbacks[i].fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+            bestFit = false;
+        }
+    }
+
+    mFailedAllocations.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+size_t
+SharedBufferPoolSet::numberOfElements() const
+{
+    size_t elements = 0;
+    for (size_t i = 0; i < mNumberOfClasses; ++i)
+    {
+        elements += mPools[i]->numberOfElements();
+    }
+    return elements;
+}
+
+size_t
+SharedBufferPoolSet::numberOfFreeElements() const
+{
+    size_t elements = 0;
+    for (size_t i = 0; i < mNumberOfClasses; ++i)
+    {
+        elements += mPools[i]->numberOfFreeElements();
+    }
+    return elements;
+}
+
+size_t
+SharedBufferPoolSet::elementSize() const
+{
+    if (mNumberOfClasses == 0)
+    {
+        return 0;
+    }
+    return mPools[mNumberOfClasses - 1]->elementSize();
+}
+
+SharedBufferPoolSet::ClassStatistics
+SharedBufferPoolSet::getStatistics(size_t index) const
+{
+    ClassStatistics statistics = {0, 0, 0, 0, 0};
+    if (index < mNumberOfClasses)
+    {
+        statistics.elementSize = mPools[index]->elementSize();
+        statistics.numberOfElements = mPools[index]->numberOfElements();
+        statistics.numberOfFreeElements = mPools[index]->numberOfFreeElements();
+        statistics.numberOfAllocations = mAllocations[index].load(std::memory_order_relaxed);
+        statistics.numberOfFallbacks = mFallbacks[index].load(std::memory_order_relaxed);
+    }
+    return statistics;
+}
+
+void
+SharedBufferPoolSet::resetStatistics()
+{
+    for (size_t i = 0; i < maximumNumberOfClasses; ++i)
+    {
+        mAllocations[i].store(0, std::memory_order_relaxed);
+        mFallbacks[i].store(0, std::memory_order_relaxed);
+    }
+    mFailedAllocations.store(0, std::memory_order_relaxed);
+}
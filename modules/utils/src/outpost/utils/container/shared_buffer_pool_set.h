@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef OUTPOST_UTILS_SHARED_BUFFER_POOL_SET_H
+#define OUTPOST_UTILS_SHARED_BUFFER_POOL_SET_H
+
+#include "shared_object_pool.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+namespace outpost
+{
+namespace utils
+{
+/**
+ * \ingroup SharedBuffer
+ * \brief Set of pools with power-of-two element sizes.
+ *
+ * Every registered pool forms a size class. allocate(pointer, minimumSize)
+ * returns a buffer of the smallest class which is large enough. If that
+ * class is exhausted, the next larger classes are tried. Small messages
+ * therefore no longer occupy buffers dimensioned for the largest message.
+ *
+ * allocate(pointer) without a size returns a buffer of the largest class.
+ *
+ * All pools have to be added before the set is used. Afterwards the set
+ * can be used from multiple threads.
+ *
+ * \see SharedBufferPoolSetStorage
+ */
+class SharedBufferPoolSet : public SharedBufferPoolBase
+{
+public:
+    static constexpr size_t maximumNumberOfClasses = 16;
+
+    /**
+     * Occupancy of a single size class.
+     */
+    struct ClassStatistics
+    {
+        size_t elementSize;
+        size_t numberOfElements;
+        size_t numberOfFreeElements;
+
+        /// Buffers handed out by this class
+        uint32_t numberOfAllocations;
+
+        /// Buffers handed out by this class because all smaller fitting classes were exhausted
+        uint32_t numberOfFallbacks;
+    };
+
+    SharedBufferPoolSet();
+
+    virtual ~SharedBufferPoolSet() = default;
+
+    // Disable copy constructor
+    SharedBufferPoolSet(const SharedBufferPoolSet&) = delete;
+
+    // Disable copy assignment operator
+    SharedBufferPoolSet&
+    operator=(const SharedBufferPoolSet&) = delete;
+
+    /**
+     * \brief Adds a pool as next larger size class.
+     *
+     * \param pool
+     *      Pool to add. Its element size must be a power of two and larger
+     *      than the element size of all previously added pools.
+     * \return Returns false if the pool could not be added.
+     */
+    bool
+    addPool(SharedBufferPoolBase& pool);
+
+    /**
+     * \brief Allocation of a buffer of the largest size class.
+     */
+    bool
+    allocate(SharedBufferPointer& pointer) override;
+
+    /**
+     * \brief Best-fit allocation.
+     *
+     * \param pointer Reference to the SharedBufferPointer
+     * \param minimumSize Minimum length of the buffer in bytes
+     * \return Returns true if a sufficiently large SharedBufferPointer was found, otherwise false.
+     */
+    bool
+    allocate(SharedBufferPointer& pointer, size_t minimumSize) override;
+
+    /**
+     * \brief Overall number of elements in all size classes.
+     */
+    size_t
+    numberOfElements() const override;
+
+    /**
+     * \brief Number of free elements in all size classes.
+     */
+    size_t
+    numberOfFreeElements() const override;
+
+    /**
+     * \brief Element size of the largest size class, zero for an empty set.
+     */
+    size_t
+    elementSize() const override;
+
+    inline size_t
+    getNumberOfClasses() const
+    {
+        return mNumberOfClasses;
+    }
+
+    /**
+     * \brief Occupancy of a size class.
+     *
+     * \param index
+     *      Size class, starting with the smallest one.
+     */
+    ClassStatistics
+    getStatistics(size_t index) const;
+
+    /**
+     * \brief Number of allocations for which no class had a free buffer
+     * of sufficient size.
+     */
+    inline uint32_t
+    getNumberOfFailedAllocations() const
+    {
+        return mFailedAllocations.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Resets the allocation counters of all size classes.
+     */
+    void
+    resetStatistics();
+
+private:
+    SharedBufferPoolBase* mPools[maximumNumberOfClasses];
+    size_t mNumberOfClasses;
+
+    std::atomic<uint32_t> mAllocations[maximumNumberOfClasses];
+    std::atomic<uint32_t> mFallbacks[maximumNumberOfClasses];
+    std::atomic<uint32_t> mFailedAllocations;
+};
+
+namespace pool_set
+{
+template <size_t Size, size_t... Counts>
+class Classes;
+
+template <size_t Size>
+class Classes<Size>
+{
+public:
+    inline void
+    addTo(SharedBufferPoolSet&)
+    {
+    }
+};
+
+template <size_t Size, size_t Count, size_t... Counts>
+class Classes<Size, Count, Counts...>
+{
+public:
+    inline void
+    addTo(SharedBufferPoolSet& set)
+    {
+        set.addPool(mPool);
+        mLarger.addTo(set);
+    }
+
+private:
+    SharedBufferPool<Size, Count> mPool;
+    Classes<Size * 2, Counts...> mLarger;
+};
+
+// Unused size class
+template <size_t Size, size_t... Counts>
+class Classes<Size, 0, Counts...>
+{
+public:
+    inline void
+    addTo(SharedBufferPoolSet& set)
+    {
+        mLarger.addTo(set);
+    }
+
+private:
+    Classes<Size * 2, Counts...> mLarger;
+};
+}  // namespace pool_set
+
+/**
+ * \ingroup SharedBuffer
+ * Storage provider for a SharedBufferPoolSet.
+ *
+ * Creates one pool per size class, starting with \p MinimumSize bytes and
+ * doubling the size for every following class.
+ *
+ * \code
+ * // 64 x 16 bytes, 32 x 32 bytes, 0 x 64 bytes, 8 x 128 bytes
+ * SharedBufferPoolSetStorage<16, 64, 32, 0, 8> pools;
+ * \endcode
+ *
+ * \tparam MinimumSize Element size of the smallest class, must be a power of two
+ * \tparam Counts Number of elements of each size class
+ */
+template <size_t MinimumSize, size_t... Counts>
+class SharedBufferPoolSetStorage : public SharedBufferPoolSet
+{
+public:
+    static_assert((MinimumSize > 0) && ((MinimumSize & (MinimumSize - 1)) == 0),
+                  "The minimum size must be a power of two");
+    static_assert(sizeof...(Counts) <= maximumNumberOfClasses, "Too many size classes");
+
+    SharedBufferPoolSetStorage()
+    {
+        mClasses.addTo(*this);
+    }
+
+private:
+    pool_set::Classes<MinimumSize, Counts...> mClasses;
+};
+
+}  // namespace utils
+}  // namespace outpost
+
+#endif
@@ -20,6 +20,10 @@
 #include <outpost/rtos/mutex_guard.h>
 #include <outpost/utils/container/list.h>
 
+#include <stdint.h>
+
+#include <atomic>
+
 namespace outpost
 {
 namespace utils
@@ -41,6 +45,46 @@ public:
     virtual bool
     allocate(SharedBufferPointer& pointer) = 0;
 
+    /**
+     * \brief Allocation of an unused SharedBufferPointer holding at least \p minimumSize bytes.
+     *
+     * The default implementation fails if the elements of the pool are smaller than
+     * \p minimumSize and calls allocate() otherwise.
+     *
+     * \param pointer Reference to the SharedBufferPointer
+     * \param minimumSize Minimum length of the buffer in bytes
+     * \return Returns true if a sufficiently large SharedBufferPointer was found, otherwise false.
+     */
+    virtual bool
+    allocate(SharedBufferPointer& pointer, size_t minimumSize)
+    {
+        if (minimumSize > elementSize())
+        {
+            return false;
+        }
+        return allocate(pointer);
+    }
+
+    /**
+     * \brief Allocation of multiple unused SharedBufferPointers at once.
+     *
+     * The default implementation calls allocate() for every element.
+     *
+     * \param pointers Slice which is filled from the front with the allocated pointers.
+     * \return Returns the number of allocated pointers, less than the size of \p pointers if
+     * the pool does not hold enough unused buffers.
+     */
+    virtual size_t
+    allocateBatch(outpost::Slice<SharedBufferPointer> pointers)
+    {
+        size_t allocated = 0;
+        while ((allocated < pointers.getNumberOfElements()) && allocate(pointers[allocated]))
+        {
+            allocated++;
+        }
+        return allocated;
+    }
+
     /**
      * \brief Getter function for the overall number of elements in the pool.
      *
@@ -58,6 +102,14 @@ public:
     virtual size_t
     numberOfFreeElements() const = 0;
 
+    /**
+     * \brief Getter function for the size of the buffers returned by allocate(SharedBufferPointer&).
+     *
+     * \return Returns the length of a single element in bytes.
+     */
+    virtual size_t
+    elementSize() const = 0;
+
     /**
      * \brief Default destructor.
      *
@@ -65,6 +117,32 @@ public:
      * since this might free their underlying memory.
      */
     virtual ~SharedBufferPoolBase() = default;
+
+protected:
+    friend class SharedBuffer;
+
+    /**
+     * \brief Registers the pool as owner of a buffer.
+     *
+     * release() is called for the buffer whenever its last reference is dropped.
+     */
+    inline void
+    attach(SharedBuffer& buffer)
+    {
+        buffer.mPool = this;
+    }
+
+    /**
+     * \brief Called when the last reference to an attached buffer was dropped.
+     *
+     * Called from the context of the thread dropping the reference, without
+     * holding any lock. The default implementation does nothing.
+     */
+    virtual void
+    release(SharedBuffer& buffer)
+    {
+        (void) buffer;
+    }
 };
 
 /**
@@ -72,20 +150,27 @@ public:
  * \brief A SharedBufferPool holds SharedBuffer instances and allows for allocating matching
  * SharedBufferPointer instances these when needed.
  *
+ * Unused buffers are kept in an intrusive free-list. Allocating a buffer and returning it
+ * when its last reference is dropped are O(1). With OUTPOST_UTILS_SHARED_BUFFER_ATOMIC the
+ * free-list is a lock-free stack with a generation tag against the ABA problem, otherwise
+ * it is protected by a mutex.
+ *
+ * Buffers of a pool must only be referenced through allocate(), never by constructing a
+ * SharedBufferPointer from an unused buffer.
+ *
  * \tparam E Length of a single element in bytes
- * \tparam N Number of elements
+ * \tparam N Number of elements, at most 65534
  */
 template <size_t E, size_t N>
 class SharedBufferPool : public SharedBufferPoolBase
 {
+    typedef uint16_t Index;
+    static constexpr Index invalidIndex = 0xFFFF;
+
+    static_assert(N < invalidIndex, "Too many elements for a SharedBufferPool");
+
 public:
-    SharedBufferPool() : mLastIndex(0)
-    {
-        for (size_t i = 0; i < N; i++)
-        {
-            mBuffer[i].setPointer(outpost::Slice<uint8_t>::unsafe(mDataBuffer[i], E));
-        }
-    }
+    SharedBufferPool();
 
     /**
      * \brief Default destructor.
@@ -94,33 +179,27 @@ public:
      */
     virtual ~SharedBufferPool() = default;
 
+    using SharedBufferPoolBase::allocate;
+
     /**
      * \brief Allocation of an unused SharedBufferPoiner from the pool.
      *
-     *  When looking for an unused element,
-     *  the element next to the one that was allocated last is considered first.
+     * The buffer released last is returned first.
      *
      * \param pointer Reference to the SharedBufferPointer
      * \return Returns true if a valid SharedBudderPointer was found, otherwise false.
      */
     bool
-    allocate(SharedBufferPointer& pointer) override
-    {
-        outpost::rtos::MutexGuard lock(mMutex);
-        size_t i = mLastIndex;
-        bool res = false;
-        do
-        {
-            if (!mBuffer[i].isUsed())
-            {
-                pointer = SharedBufferPointer(&mBuffer[i]);
-                res = true;
-                mLastIndex = (i + 1) % N;
-            }
-            i = (i + 1) % N;
-        } while (i != mLastIndex && !res);
-        return res;
-    }
+    allocate(SharedBufferPointer& pointer) override;
+
+    /**
+     * \brief Allocation of multiple unused SharedBufferPointers with a single update of the
+     * free-list.
+     *
+     * \see SharedBufferPoolBase::allocateBatch
+     */
+    size_t
+    allocateBatch(outpost::Slice<SharedBufferPointer> pointers) override;
 
     /**
      * \brief Prints the current state (used, unused) of all SharedBufferPointers in the pool.
@@ -157,35 +236,231 @@ public:
         return N;
     }
 
+    /**
+     * \brief Getter function for the size of a single element in the pool.
+     *
+     * \return Returns E.
+     */
+    inline size_t
+    elementSize() const override
+    {
+        return E;
+    }
+
     /**
      * \brief Getter function for the number of free elements in the pool.
      *
+     * Maintained as a counter. While other threads allocate or release buffers the value
+     * may lag behind the free-list.
+     *
      * \return Returns the number of unused items in the pool.
      */
     size_t
-    numberOfFreeElements() const override
-    {
-        size_t temp = 0;
-        for (size_t i = 0; i < N; i++)
-        {
-            if (!mBuffer[i].isUsed())
-            {
-                temp++;
-            }
-        }
-        return temp;
-    }
+    numberOfFreeElements() const override;
 
 protected:
+    void
+    release(SharedBuffer& buffer) override;
+
     uint8_t mDataBuffer[N][E] __attribute__((aligned(4)));
     SharedBuffer mBuffer[N];
 
-    size_t mLastIndex;
+private:
+    /**
+     * \brief Removes the first element from the free-list.
+     * \return Index of the element or invalidIndex if the free-list is empty.
+     */
+    Index
+    pop();
+
+    /**
+     * \brief Removes up to \p count elements from the free-list.
+     *
+     * The removed elements stay linked through mNext.
+     * \param count Maximum number of elements to remove.
+     * \param removed Actual number of removed elements.
+     * \return Index of the first removed element or invalidIndex if the free-list is empty.
+     */
+    Index
+    popChain(size_t count, size_t& removed);
+
+    void
+    push(Index index);
+
+#ifdef OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+    static inline uint32_t
+    toHead(uint32_t previous, Index index)
+    {
+        // The upper 16 bits hold a tag which is changed with every update of the head.
+        // A stale head read before a pop/push sequence then fails the compare-exchange.
+        return (((previous >> 16) + 1) << 16) | index;
+    }
+
+    std::atomic<uint32_t> mHead;
+    std::atomic<Index> mNext[N];
+    std::atomic<size_t> mNumberOfFreeElements;
+#else
+    Index mHead;
+    Index mNext[N];
+    size_t mNumberOfFreeElements;
 
-    outpost::rtos::Mutex mMutex;
+    mutable outpost::rtos::Mutex mMutex;
+#endif
 };
 
 }  // namespace utils
 }  // namespace outpost
 
+// ----------------------------------------------------------------------------
+// Implementation
+// ----------------------------------------------------------------------------
+
+template <size_t E, size_t N>
+outpost::utils::SharedBufferPool<E, N>::SharedBufferPool() : mHead(0), mNumberOfFreeElements(N)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        mBuffer[i].setPointer(outpost::Slice<uint8_t>::unsafe(mDataBuffer[i], E));
+        attach(mBuffer[i]);
+        mNext[i] = (i + 1 < N) ? static_cast<Index>(i + 1) : invalidIndex;
+    }
+    if (N == 0)
+    {
+        mHead = invalidIndex;
+    }
+}
+
+template <size_t E, size_t N>
+bool
+outpost::utils::SharedBufferPool<E, N>::allocate(SharedBufferPointer& pointer)
+{
+    Index index = pop();
+    if (index == invalidIndex)
+    {
+        return false;
+    }
+
+    pointer = SharedBufferPointer(&mBuffer[index]);
+    return true;
+}
+
+template <size_t E, size_t N>
+size_t
+outpost::utils::SharedBufferPool<E, N>::allocateBatch(outpost::Slice<SharedBufferPointer> pointers)
+{
+    size_t removed = 0;
+    Index index = popChain(pointers.getNumberOfElements(), removed);
+    for (size_t i = 0; i < removed; ++i)
+    {
+        Index next = mNext[index];
+        pointers[i] = SharedBufferPointer(&mBuffer[index]);
+        index = next;
+    }
+    return removed;
+}
+
+template <size_t E, size_t N>
+typename outpost::utils::SharedBufferPool<E, N>::Index
+outpost::utils::SharedBufferPool<E, N>::pop()
+{
+    size_t removed = 0;
+    return popChain(1, removed);
+}
+
+template <size_t E, size_t N>
+void
+outpost::utils::SharedBufferPool<E, N>::release(SharedBuffer& buffer)
+{
+    push(static_cast<Index>(&buffer - &mBuffer[0]));
+}
+
+#ifdef OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+template <size_t E, size_t N>
+size_t
+outpost::utils::SharedBufferPool<E, N>::numberOfFreeElements() const
+{
+    return mNumberOfFreeElements.load(std::memory_order_relaxed);
+}
+
+template <size_t E, size_t N>
+typename outpost::utils::SharedBufferPool<E, N>::Index
+outpost::utils::SharedBufferPool<E, N>::popChain(size_t count, size_t& removed)
+{
+    uint32_t head = mHead.load(std::memory_order_acquire);
+    Index first;
+    Index next;
+    do
+    {
+        first = static_cast<Index>(head & 0xFFFF);
+        next = first;
+        removed = 0;
+        // The elements below the head only change after the head itself has been
+        // changed, therefore the walk is valid if the compare-exchange succeeds.
+        while ((removed < count) && (next != invalidIndex))
+        {
+            next = mNext[next].load(std::memory_order_relaxed);
+            removed++;
+        }
+        if (removed == 0)
+        {
+            return invalidIndex;
+        }
+    } while (!mHead.compare_exchange_weak(
+            head, toHead(head, next), std::memory_order_acquire, std::memory_order_acquire));
+
+    // Decremented after taking the elements and incremented before returning them, so
+    // that the counter never drops below the actual number of free elements.
+    mNumberOfFreeElements.fetch_sub(removed, std::memory_order_relaxed);
+    return first;
+}
+
+template <size_t E, size_t N>
+void
+outpost::utils::SharedBufferPool<E, N>::push(Index index)
+{
+    mNumberOfFreeElements.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t head = mHead.load(std::memory_order_relaxed);
+    do
+    {
+        mNext[index].store(static_cast<Index>(head & 0xFFFF), std::memory_order_relaxed);
+    } while (!mHead.compare_exchange_weak(
+            head, toHead(head, index), std::memory_order_release, std::memory_order_relaxed));
+}
+#else
+template <size_t E, size_t N>
+size_t
+outpost::utils::SharedBufferPool<E, N>::numberOfFreeElements() const
+{
+    outpost::rtos::MutexGuard lock(mMutex);
+    return mNumberOfFreeElements;
+}
+
+template <size_t E, size_t N>
+typename outpost::utils::SharedBufferPool<E, N>::Index
+outpost::utils::SharedBufferPool<E, N>::popChain(size_t count, size_t& removed)
+{
+    outpost::rtos::MutexGuard lock(mMutex);
+    Index first = mHead;
+    removed = 0;
+    while ((removed < count) && (mHead != invalidIndex))
+    {
+        mHead = mNext[mHead];
+        removed++;
+    }
+    mNumberOfFreeElements -= removed;
+    return first;
+}
+
+template <size_t E, size_t N>
+void
+outpost::utils::SharedBufferPool<E, N>::push(Index index)
+{
+    outpost::rtos::MutexGuard lock(mMutex);
+    mNext[index] = mHead;
+    mHead = index;
+    mNumberOfFreeElements++;
+}
+#endif
+
 #endif /* MODULES_UTILS_OBJECT_POOL_H_ */
@@ -30,10 +30,85 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <atomic>
+#include <utility>
+
 namespace outpost
 {
 namespace utils
 {
+/**
+ * \ingroup SharedBuffer
+ * \brief Consecutive elements of a SharedRingBuffer or SpscSharedRingBuffer.
+ *
+ * Gives access to a range of stored elements without removing them from
+ * the ring buffer. The window stays valid until one of its elements is
+ * popped or the ring buffer is reset.
+ */
+class SharedRingBufferWindow
+{
+public:
+    inline SharedRingBufferWindow(outpost::Slice<SharedBufferPointer> buffer,
+                                  outpost::Slice<uint8_t> flags,
+                                  size_t start,
+                                  size_t count) :
+        mBuffer(buffer),
+        mFlags(flags),
+        mStart(start),
+        mNumberOfElements(count)
+    {
+    }
+
+    inline size_t
+    getNumberOfElements() const
+    {
+        return mNumberOfElements;
+    }
+
+    /**
+     * \brief Access an element of the window.
+     *
+     * \warning
+     *      No out-of-bound error checking is performed.
+     */
+    inline const SharedBufferPointer& operator[](size_t index) const
+    {
+        return mBuffer[getPosition(index)];
+    }
+
+    inline uint8_t
+    getFlags(size_t index) const
+    {
+        return mFlags[getPosition(index)];
+    }
+
+    /**
+     * \brief Updates the flags of an element in place, e.g. to mark it as processed.
+     */
+    inline void
+    setFlags(size_t index, uint8_t flags)
+    {
+        mFlags[getPosition(index)] = flags;
+    }
+
+private:
+    inline size_t
+    getPosition(size_t index) const
+    {
+        size_t position = mStart + index;
+        if (position >= mBuffer.getNumberOfElements())
+        {
+            position -= mBuffer.getNumberOfElements();
+        }
+        return position;
+    }
+
+    outpost::Slice<SharedBufferPointer> mBuffer;
+    outpost::Slice<uint8_t> mFlags;
+    size_t mStart;
+    size_t mNumberOfElements;
+};
+
 /**
  * \ingroup SharedBuffer
  * \brief Ring buffer data structure for SharedBuffers.
@@ -118,6 +193,37 @@ public:
         return appended;
     }
 
+    /**
+     * \brief Moves an element to the first unoccupied index it finds and updates the
+     * writeIndex.
+     *
+     * The reference count of the SharedBuffer is not changed. If the SharedRingBuffer is
+     * full, \p p is left unchanged.
+     *
+     * \param p SharedBufferPointer to be stored
+     * \param flags Additional flags for the SharedBufferPointer that may be set.
+     *
+     * \return Returns true if the element could be stored in the SharedRingBuffer, otherwise false.
+     */
+    inline bool
+    append(SharedBufferPointer&& p, uint8_t flags = 0)
+    {
+        bool appended = false;
+        if ((mNumberOfElements < mBuffer.getNumberOfElements()))
+        {
+            // calculate write index
+            int writeIndex = increment(mReadIndex, mNumberOfElements);
+
+            mFlags[writeIndex] = flags;
+            mBuffer[writeIndex] = std::move(p);
+            ++mNumberOfElements;
+
+            appended = true;
+        }
+
+        return appended;
+    }
+
     /**
      * \brief Checks if the buffer is empty.
      *
@@ -216,6 +322,30 @@ public:
         return mEmpty;
     }
 
+    /**
+     * \brief Provides access to a range of elements without removing them.
+     *
+     * \param index Index of the first element, relative to the current read pointer
+     * \param count Maximum number of elements
+     * \return Window over the elements. Contains fewer than \p count elements
+     * if less elements are stored.
+     */
+    inline SharedRingBufferWindow
+    peek(size_t index, size_t count) const
+    {
+        if (index >= mNumberOfElements)
+        {
+            return SharedRingBufferWindow(mBuffer, mFlags, mReadIndex, 0);
+        }
+
+        const size_t available = mNumberOfElements - index;
+        if (count > available)
+        {
+            count = available;
+        }
+        return SharedRingBufferWindow(mBuffer, mFlags, increment(mReadIndex, index), count);
+    }
+
     /**
      * \brief Provides the means to access one specific element's flags.
      *
@@ -230,6 +360,11 @@ public:
     inline uint8_t
     peekFlags(size_t index) const
     {
+        if (index >= mBuffer.getNumberOfElements())
+        {
+            // Out of range, wrap around without looping
+            index %= mBuffer.getNumberOfElements();
+        }
         size_t position = increment(mReadIndex, index);
         return mFlags[position];
     }
@@ -252,7 +387,14 @@ private:
     inline size_t
     increment(size_t index, size_t count) const
     {
-        size_t next = (index + count) % mBuffer.getNumberOfElements();
+        // Avoids the division. Callers keep index below the capacity and
+        // count at most at the capacity, the subtraction is needed at most
+        // once.
+        size_t next = index + count;
+        if (next >= mBuffer.getNumberOfElements())
+        {
+            next -= mBuffer.getNumberOfElements();
+        }
         return next;
     }
 
@@ -295,6 +437,314 @@ private:
     uint8_t mFlags[totalNumberOfElements];
 };
 
+/**
+ * \ingroup SharedBuffer
+ * \brief SharedRingBuffer for one producer and one consumer thread.
+ *
+ * Can be used without additional locking between e.g. a receive thread
+ * appending incoming packets and a worker processing them. Only the
+ * producer calls append() and getFreeSlots(). All other functions are
+ * reserved to the consumer, except reset() which requires both threads to
+ * be idle.
+ *
+ * The read and write positions are free running atomic counters. The
+ * capacity is a power of two, so a position is mapped to a slot by masking
+ * instead of a division. A slot, including its flags, belongs to exactly one
+ * thread at a time. The flags are therefore updated in place without
+ * atomic operations.
+ *
+ * Non-blocking, combine with an outpost::rtos::Semaphore if the consumer
+ * has to wait for data.
+ */
+class SpscSharedRingBuffer
+{
+public:
+    /**
+     * \brief Constructor based on a Slice of SharedBufferPointers and a Slice byte array of
+     * flags, both of the same length.
+     *
+     * Only the largest power of two not exceeding the length is used as capacity. The
+     * slices must not be empty.
+     */
+    inline SpscSharedRingBuffer(outpost::Slice<SharedBufferPointer> buffer,
+                                outpost::Slice<uint8_t> flags) :
+        mBuffer(buffer.first(getCapacity(buffer.getNumberOfElements()))),
+        mFlags(flags.first(mBuffer.getNumberOfElements())),
+        mMask(mBuffer.getNumberOfElements() - 1),
+        mReadIndex(0),
+        mCachedWriteIndex(0),
+        mWriteIndex(0),
+        mCachedReadIndex(0)
+    {
+    }
+
+    virtual ~SpscSharedRingBuffer() = default;
+
+    SpscSharedRingBuffer(const SpscSharedRingBuffer& o) = delete;
+
+    SpscSharedRingBuffer&
+    operator=(const SpscSharedRingBuffer& o) = delete;
+
+    inline size_t
+    getCapacity() const
+    {
+        return mBuffer.getNumberOfElements();
+    }
+
+    /**
+     * \brief Number of free slots, called by the producer.
+     */
+    inline size_t
+    getFreeSlots() const
+    {
+        return mBuffer.getNumberOfElements()
+               - (mWriteIndex.load(std::memory_order_relaxed)
+                  - mReadIndex.load(std::memory_order_acquire));
+    }
+
+    /**
+     * \brief Number of stored elements, called by the consumer.
+     */
+    inline size_t
+    getUsedSlots() const
+    {
+        return mWriteIndex.load(std::memory_order_acquire)
+               - mReadIndex.load(std::memory_order_relaxed);
+    }
+
+    inline bool
+    isEmpty() const
+    {
+        return getUsedSlots() == 0;
+    }
+
+    /**
+     * \brief Stores a copy of the pointer, called by the producer.
+     *
+     * \return Returns false if the ring buffer is full.
+     */
+    inline bool
+    append(const SharedBufferPointer& p, uint8_t flags = 0)
+    {
+        SharedBufferPointer copy(p);
+        return append(std::move(copy), flags);
+    }
+
+    /**
+     * \brief Moves the pointer into the ring buffer, called by the producer.
+     *
+     * If the ring buffer is full, \p p is left unchanged.
+     *
+     * \return Returns false if the ring buffer is full.
+     */
+    inline bool
+    append(SharedBufferPointer&& p, uint8_t flags = 0)
+    {
+        const size_t writeIndex = mWriteIndex.load(std::memory_order_relaxed);
+        if (writeIndex - mCachedReadIndex >= mBuffer.getNumberOfElements())
+        {
+            mCachedReadIndex = mReadIndex.load(std::memory_order_acquire);
+            if (writeIndex - mCachedReadIndex >= mBuffer.getNumberOfElements())
+            {
+                return false;
+            }
+        }
+
+        mFlags[writeIndex & mMask] = flags;
+        mBuffer[writeIndex & mMask] = std::move(p);
+        mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Element at the current read pointer, invalid if the buffer is empty.
+     */
+    inline const SharedBufferPointer&
+    read() const
+    {
+        return mBuffer[mReadIndex.load(std::memory_order_relaxed) & mMask];
+    }
+
+    inline uint8_t
+    readFlags() const
+    {
+        return mFlags[mReadIndex.load(std::memory_order_relaxed) & mMask];
+    }
+
+    /**
+     * \brief Sets the flags of the element at the current read pointer.
+     */
+    inline void
+    setFlags(uint8_t flags)
+    {
+        mFlags[mReadIndex.load(std::memory_order_relaxed) & mMask] = flags;
+    }
+
+    /**
+     * \brief Removes the element at the current read pointer.
+     *
+     * \return Returns false if the buffer is empty.
+     */
+    inline bool
+    pop()
+    {
+        const size_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        if (!isAvailable(readIndex, 1))
+        {
+            return false;
+        }
+
+        mBuffer[readIndex & mMask] = SharedBufferPointer();
+        mReadIndex.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Removes the element at the current read pointer and hands it to the caller.
+     *
+     * \return Returns false if the buffer is empty.
+     */
+    inline bool
+    pop(SharedBufferPointer& p)
+    {
+        const size_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        if (!isAvailable(readIndex, 1))
+        {
+            return false;
+        }
+
+        p = std::move(mBuffer[readIndex & mMask]);
+        mReadIndex.store(readIndex + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Provides access to a range of elements without removing them.
+     *
+     * \param index Index of the first element, relative to the current read pointer
+     * \param count Maximum number of elements
+     * \return Window over the elements. Contains fewer than \p count elements
+     * if less elements are stored.
+     */
+    inline SharedRingBufferWindow
+    peek(size_t index, size_t count) const
+    {
+        const size_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        const size_t used = mWriteIndex.load(std::memory_order_acquire) - readIndex;
+
+        size_t available = 0;
+        if (index < used)
+        {
+            available = used - index;
+        }
+        if (count > available)
+        {
+            count = available;
+        }
+        return SharedRingBufferWindow(mBuffer, mFlags, (readIndex + index) & mMask, count);
+    }
+
+    /**
+     * \brief Removes up to \p count elements at once, e.g. after processing a window.
+     *
+     * \return Number of removed elements.
+     */
+    inline size_t
+    pop(size_t count)
+    {
+        const size_t readIndex = mReadIndex.load(std::memory_order_relaxed);
+        const size_t used = mWriteIndex.load(std::memory_order_acquire) - readIndex;
+        if (count > used)
+        {
+            count = used;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            mBuffer[(readIndex + i) & mMask] = SharedBufferPointer();
+        }
+        mReadIndex.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * \brief Deletes all references. Neither producer nor consumer may
+     * access the ring buffer concurrently.
+     */
+    inline void
+    reset()
+    {
+        for (size_t i = 0; i < mBuffer.getNumberOfElements(); i++)
+        {
+            mBuffer[i] = SharedBufferPointer();
+        }
+        mReadIndex.store(0, std::memory_order_relaxed);
+        mCachedWriteIndex = 0;
+        mWriteIndex.store(0, std::memory_order_relaxed);
+        mCachedReadIndex = 0;
+    }
+
+private:
+    static inline size_t
+    getCapacity(size_t length)
+    {
+        size_t capacity = 1;
+        while ((capacity * 2) <= length)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    inline bool
+    isAvailable(size_t readIndex, size_t count)
+    {
+        if (mCachedWriteIndex - readIndex < count)
+        {
+            mCachedWriteIndex = mWriteIndex.load(std::memory_order_acquire);
+        }
+        return (mCachedWriteIndex - readIndex) >= count;
+    }
+
+    const outpost::Slice<SharedBufferPointer> mBuffer;
+    const outpost::Slice<uint8_t> mFlags;
+    const size_t mMask;
+
+    // Consumer side
+    std::atomic<size_t> mReadIndex;
+    size_t mCachedWriteIndex;
+
+    // Producer side
+    std::atomic<size_t> mWriteIndex;
+    size_t mCachedReadIndex;
+};
+
+/**
+ * \ingroup SharedBuffer
+ * Storage provider for the SpscSharedRingBuffer.
+ *
+ * \tparam totalNumberOfElements Capacity, has to be a power of two
+ */
+template <size_t totalNumberOfElements>
+class SpscSharedRingBufferStorage : public SpscSharedRingBuffer
+{
+public:
+    static_assert((totalNumberOfElements > 0)
+                          && ((totalNumberOfElements & (totalNumberOfElements - 1)) == 0),
+                  "Capacity must be a power of two");
+
+    inline SpscSharedRingBufferStorage() :
+        SpscSharedRingBuffer(outpost::asSlice(mBufferStorage), outpost::asSlice(mFlags))
+    {
+    }
+
+    virtual ~SpscSharedRingBufferStorage() = default;
+
+private:
+    SharedBufferPointer mBufferStorage[totalNumberOfElements];
+    uint8_t mFlags[totalNumberOfElements];
+};
+
 }  // namespace utils
 }  // namespace outpost
 
@@ -14,6 +14,8 @@
 #ifndef OUTPOST_META_H
 #define OUTPOST_META_H
 
+#include <stddef.h>
+
 namespace outpost
 {
 /**
@@ -74,6 +76,29 @@ struct remove_const<T*>
     typedef typename remove_const<T>::type* type;
 };
 
+/**
+ * Compile-time sequence of indices, replacement for the C++14
+ * std::index_sequence.
+ */
+template <size_t... indices>
+struct IndexSequence
+{
+};
+
+/**
+ * Creates IndexSequence<0, 1, ..., N - 1> as MakeIndexSequence<N>::Type
+ */
+template <size_t N, size_t... indices>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, indices...>
+{
+};
+
+template <size_t... indices>
+struct MakeIndexSequence<0, indices...>
+{
+    typedef IndexSequence<indices...> Type;
+};
+
 }  // namespace outpost
 
 #endif
@@ -24,6 +24,9 @@ namespace outpost
 class Bitstream : outpost::SerializableObject
 {
 private:
+    friend class BitstreamWriter;
+    friend class BitstreamReader;
+
     outpost::Slice<uint8_t>& mData;  // Buffer for storing the bitstream
     uint16_t bytePointer;
     int8_t bitPointer;
@@ -240,6 +243,252 @@ public:
     }
 };
 
+/**
+ * Writes bits to a Bitstream in words instead of single bits.
+ *
+ * The bits are collected in a 64 bit accumulator. Whenever 32 bits are
+ * pending they are written to the stream as one word with a single bounds
+ * check. The resulting stream is identical to pushing the same bits with
+ * Bitstream::pushBit(), including the truncation when the stream is full.
+ *
+ * The last partial byte and the bit pointer of the Bitstream are only
+ * updated by flush(), which is called by the destructor. The stream must
+ * not be modified otherwise while a writer exists.
+ */
+class BitstreamWriter
+{
+public:
+    explicit BitstreamWriter(Bitstream& stream) :
+        mStream(stream), mAccumulator(0), mPendingBits(0)
+    {
+        // Continue a partially filled byte, so that all words are byte aligned
+        if (mStream.bitPointer < Bitstream::initialBitPointer && !mStream.isFull())
+        {
+            mPendingBits = static_cast<uint8_t>(Bitstream::initialBitPointer - mStream.bitPointer);
+            mAccumulator = mStream.mData[mStream.bytePointer] >> (mStream.bitPointer + 1);
+        }
+    }
+
+    // Disable copy constructor
+    BitstreamWriter(const BitstreamWriter&) = delete;
+
+    BitstreamWriter&
+    operator=(const BitstreamWriter&) = delete;
+
+    ~BitstreamWriter()
+    {
+        flush();
+    }
+
+    /**
+     * Pushes one bit to the stream
+     * \param b
+     *     Bit value to push to the stream
+     */
+    inline void
+    pushBit(bool b)
+    {
+        mAccumulator = (mAccumulator << 1) | static_cast<uint64_t>(b);
+        mPendingBits++;
+        if (mPendingBits >= 32)
+        {
+            flushWord();
+        }
+    }
+
+    /**
+     * Pushes the lower bits of a value to the stream, MSB first
+     * \param value
+     *     Value to push to the stream
+     * \param count
+     *     Number of bits to push, at most 32
+     */
+    inline void
+    pushBits(uint32_t value, uint8_t count)
+    {
+        const uint64_t mask = (static_cast<uint64_t>(1) << count) - 1;
+        mAccumulator = (mAccumulator << count) | (value & mask);
+        mPendingBits += count;
+        if (mPendingBits >= 32)
+        {
+            flushWord();
+        }
+    }
+
+    /**
+     * The size of the stream in bytes including the pending bits
+     */
+    inline uint16_t
+    getSize() const
+    {
+        size_t size = mStream.bytePointer + ((mPendingBits + 7) >> 3);
+        if (size > mStream.mData.getNumberOfElements())
+        {
+            size = mStream.mData.getNumberOfElements();
+        }
+        return static_cast<uint16_t>(size - Bitstream::headerSize);
+    }
+
+    /**
+     * Writes the pending bits to the stream and updates its size.
+     *
+     * The writer can be used further afterwards.
+     */
+    void
+    flush()
+    {
+        const size_t capacity = mStream.mData.getNumberOfElements();
+        while (mPendingBits >= 8 && mStream.bytePointer < capacity)
+        {
+            mPendingBits -= 8;
+            mStream.mData[mStream.bytePointer++] =
+                    static_cast<uint8_t>(mAccumulator >> mPendingBits);
+        }
+
+        if (mStream.bytePointer < capacity)
+        {
+            // Unused bits of the last byte are zero, as with Bitstream::pushBit()
+            mStream.mData[mStream.bytePointer] = (mAccumulator << (8 - mPendingBits)) & 0xFF;
+            mStream.bitPointer = static_cast<int8_t>(Bitstream::initialBitPointer - mPendingBits);
+        }
+        else
+        {
+            mPendingBits = 0;
+            mStream.bitPointer = Bitstream::initialBitPointer;
+        }
+    }
+
+private:
+    void
+    flushWord()
+    {
+        mPendingBits -= 32;
+        const uint32_t word = static_cast<uint32_t>(mAccumulator >> mPendingBits);
+        if (mStream.bytePointer + 4U <= mStream.mData.getNumberOfElements())
+        {
+            uint8_t* data = &mStream.mData[mStream.bytePointer];
+            data[0] = static_cast<uint8_t>(word >> 24);
+            data[1] = static_cast<uint8_t>(word >> 16);
+            data[2] = static_cast<uint8_t>(word >> 8);
+            data[3] = static_cast<uint8_t>(word);
+            mStream.bytePointer += 4;
+        }
+        else
+        {
+            // Bits exceeding the capacity of the stream are dropped
+            for (int shift = 24; shift >= 0 && !mStream.isFull(); shift -= 8)
+            {
+                mStream.mData[mStream.bytePointer++] = static_cast<uint8_t>(word >> shift);
+            }
+        }
+    }
+
+    Bitstream& mStream;
+    uint64_t mAccumulator;  // Pending bits in the lower mPendingBits bits
+    uint8_t mPendingBits;
+};
+
+/**
+ * Reads bits from a Bitstream sequentially.
+ *
+ * Up to 64 bits are loaded from the stream at once, instead of locating
+ * every single bit as Bitstream::getBit() does. Bits beyond the end of the
+ * stream are read as zero.
+ */
+class BitstreamReader
+{
+public:
+    /**
+     * \param stream
+     *     Stream to read from
+     * \param startBit
+     *     Position of the first bit to read
+     */
+    explicit BitstreamReader(const Bitstream& stream, uint32_t startBit = 0) :
+        mStream(stream),
+        mLength(((stream.bytePointer - Bitstream::headerSize) << 3)
+                + (Bitstream::initialBitPointer - stream.bitPointer)),
+        mPosition(startBit),
+        mCache(0),
+        mCachedBits(0)
+    {
+    }
+
+    // Disable copy constructor
+    BitstreamReader(const BitstreamReader&) = delete;
+
+    BitstreamReader&
+    operator=(const BitstreamReader&) = delete;
+
+    ~BitstreamReader() = default;
+
+    /**
+     * Reads the next bit from the stream
+     * \retval True
+     *    If the bit is set
+     * \retval False
+     *    If the bit is not set or beyond the end of the stream
+     */
+    inline bool
+    getBit()
+    {
+        if (mCachedBits == 0)
+        {
+            refill();
+        }
+        const bool bit = (mCache >> 63) != 0;
+        mCache <<= 1;
+        mCachedBits--;
+        mPosition++;
+        return bit;
+    }
+
+    /**
+     * Position of the next bit to read
+     */
+    inline uint32_t
+    getPosition() const
+    {
+        return mPosition;
+    }
+
+private:
+    void
+    refill()
+    {
+        mCache = 0;
+        if (mPosition >= mLength)
+        {
+            mCachedBits = 64;
+            return;
+        }
+
+        const uint32_t byte = mPosition >> 3;
+        const uint32_t end = (mLength + 7) >> 3;
+        const uint8_t* data = &mStream.mData[Bitstream::headerSize + byte];
+        const uint32_t count = (end - byte < 8) ? (end - byte) : 8;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            mCache |= static_cast<uint64_t>(data[i]) << (56 - 8 * i);
+        }
+
+        const uint8_t offset = mPosition & 7;
+        mCache <<= offset;
+        mCachedBits = static_cast<uint8_t>((count << 3) - offset);
+        if (mCachedBits > mLength - mPosition)
+        {
+            // Following bits are read as zero after the next refill
+            mCachedBits = static_cast<uint8_t>(mLength - mPosition);
+        }
+    }
+
+    const Bitstream& mStream;
+    const uint32_t mLength;  // Number of valid bits in the stream
+    uint32_t mPosition;
+    uint64_t mCache;  // Next bits to read, MSB first
+    uint8_t mCachedBits;
+};
+
 }  // namespace outpost
 
 #endif /*OUTPOST_UTILS_STORAGE_BITSTREAM_H_ */
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/utils/container/concurrent_reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <utility>
+#include <vector>
+
+using outpost::time::Duration;
+using outpost::time::Milliseconds;
+using outpost::utils::MpmcReferenceQueue;
+using outpost::utils::ReferenceQueueBase;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+using outpost::utils::SharedBufferQueueBase;
+using outpost::utils::SpscReferenceQueue;
+
+template <typename Queue>
+static void
+checkSendAndReceiveInOrder()
+{
+    Queue queue;
+    ReferenceQueueBase<int>& base = queue;
+
+    EXPECT_TRUE(base.isEmpty());
+    EXPECT_FALSE(base.isFull());
+    for (int i = 0; i < 4; ++i)
+    {
+        int value = i;
+        EXPECT_TRUE(base.send(value));
+    }
+    EXPECT_TRUE(base.isFull());
+    EXPECT_EQ(4U, base.getNumberOfItems());
+
+    int value = 4;
+    EXPECT_FALSE(base.send(value));
+
+    // Wrap around the end of the ring buffer a few times
+    for (int i = 4; i < 20; ++i)
+    {
+        int received = -1;
+        EXPECT_TRUE(base.receive(received, Duration::zero()));
+        EXPECT_EQ(i - 4, received);
+        EXPECT_TRUE(base.send(std::move(i)));
+    }
+
+    for (int i = 16; i < 20; ++i)
+    {
+        int received = -1;
+        EXPECT_TRUE(base.receive(received, Duration::zero()));
+        EXPECT_EQ(i, received);
+    }
+    EXPECT_TRUE(base.isEmpty());
+    EXPECT_FALSE(base.receive(value, Duration::zero()));
+}
+
+TEST(SpscReferenceQueueTest, sendAndReceiveInOrder)
+{
+    checkSendAndReceiveInOrder<SpscReferenceQueue<int, 4>>();
+}
+
+TEST(MpmcReferenceQueueTest, sendAndReceiveInOrder)
+{
+    checkSendAndReceiveInOrder<MpmcReferenceQueue<int, 4>>();
+}
+
+template <typename Queue>
+static void
+checkHandOverOfSharedBuffers()
+{
+    SharedBufferPool<16, 4> pool;
+    Queue queue;
+    SharedBufferQueueBase& base = queue;
+
+    SharedBufferPointer first;
+    SharedBufferPointer second;
+    ASSERT_TRUE(pool.allocate(first));
+    ASSERT_TRUE(pool.allocate(second));
+
+    EXPECT_TRUE(base.send(first));
+    EXPECT_EQ(2U, first->getReferenceCount());
+
+    EXPECT_TRUE(base.send(std::move(first)));
+    EXPECT_TRUE(first == nullptr);
+
+    // Full, the data stays with the caller
+    EXPECT_FALSE(base.send(std::move(second)));
+    EXPECT_TRUE(second.isValid());
+    EXPECT_EQ(1U, second->getReferenceCount());
+
+    SharedBufferPointer received;
+    EXPECT_TRUE(base.receive(received, Duration::zero()));
+    EXPECT_EQ(2U, received->getReferenceCount());
+    EXPECT_TRUE(base.receive(received, Duration::zero()));
+    EXPECT_EQ(1U, received->getReferenceCount());
+
+    // The queue must not keep references to received buffers
+    received = SharedBufferPointer();
+    second = SharedBufferPointer();
+    EXPECT_EQ(4U, pool.numberOfFreeElements());
+}
+
+TEST(SpscReferenceQueueTest, handOverOfSharedBuffers)
+{
+    checkHandOverOfSharedBuffers<SpscReferenceQueue<SharedBufferPointer, 2>>();
+}
+
+TEST(MpmcReferenceQueueTest, handOverOfSharedBuffers)
+{
+    checkHandOverOfSharedBuffers<MpmcReferenceQueue<SharedBufferPointer, 2>>();
+}
+
+template <typename Queue>
+static void
+checkTimeouts()
+{
+    Queue queue;
+
+    int value = 0;
+    EXPECT_FALSE(queue.receive(value, Milliseconds(5)));
+
+    EXPECT_TRUE(queue.send(1, Milliseconds(5)));
+    EXPECT_TRUE(queue.send(2, Milliseconds(5)));
+    EXPECT_FALSE(queue.send(3, Milliseconds(5)));
+    EXPECT_FALSE(queue.send(3, Duration::zero()));
+
+    EXPECT_TRUE(queue.receive(value, Milliseconds(5)));
+    EXPECT_EQ(1, value);
+}
+
+TEST(SpscReferenceQueueTest, timeouts)
+{
+    checkTimeouts<SpscReferenceQueue<int, 2>>();
+}
+
+TEST(MpmcReferenceQueueTest, timeouts)
+{
+    checkTimeouts<MpmcReferenceQueue<int, 2>>();
+}
+
+template <typename Queue>
+static void
+checkBlockingReceiveAndSend()
+{
+    Queue queue;
+
+    int received = 0;
+    std::thread receiver([&]() { queue.receive(received); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(queue.send(42, Duration::infinity()));
+    receiver.join();
+    EXPECT_EQ(42, received);
+
+    EXPECT_TRUE(queue.send(1, Duration::zero()));
+    EXPECT_TRUE(queue.send(2, Duration::zero()));
+    bool sent = false;
+    std::thread sender([&]() { sent = queue.send(3, Duration::infinity()); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(queue.receive(received));
+    sender.join();
+    EXPECT_TRUE(sent);
+    EXPECT_EQ(1, received);
+    EXPECT_TRUE(queue.receive(received));
+    EXPECT_EQ(2, received);
+    EXPECT_TRUE(queue.receive(received));
+    EXPECT_EQ(3, received);
+}
+
+TEST(SpscReferenceQueueTest, blockingReceiveAndSend)
+{
+    checkBlockingReceiveAndSend<SpscReferenceQueue<int, 2>>();
+}
+
+TEST(MpmcReferenceQueueTest, blockingReceiveAndSend)
+{
+    checkBlockingReceiveAndSend<MpmcReferenceQueue<int, 2>>();
+}
+
+TEST(SpscReferenceQueueTest, concurrentSenderAndReceiver)
+{
+    static constexpr int numberOfItems = 20000;
+    SpscReferenceQueue<int, 8> queue;
+
+    std::thread sender([&]() {
+        for (int i = 0; i < numberOfItems; ++i)
+        {
+            queue.send(std::move(i), Duration::infinity());
+        }
+    });
+
+    int errors = 0;
+    for (int i = 0; i < numberOfItems; ++i)
+    {
+        int value = -1;
+        if (!queue.receive(value) || (value != i))
+        {
+            errors++;
+        }
+    }
+    sender.join();
+
+    EXPECT_EQ(0, errors);
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(MpmcReferenceQueueTest, concurrentSendersAndReceivers)
+{
+    static constexpr int numberOfThreads = 3;
+    static constexpr int itemsPerThread = 5000;
+    MpmcReferenceQueue<int, 8> queue;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numberOfThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < itemsPerThread; ++i)
+            {
+                queue.send(t * itemsPerThread + i, Duration::infinity());
+            }
+        });
+    }
+
+    std::vector<int> counts(numberOfThreads * itemsPerThread, 0);
+    std::vector<std::vector<int>> received(numberOfThreads);
+    for (int t = 0; t < numberOfThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < itemsPerThread; ++i)
+            {
+                int value;
+                if (queue.receive(value))
+                {
+                    received[t].push_back(value);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (auto& values : received)
+    {
+        for (int value : values)
+        {
+            counts[value]++;
+        }
+    }
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        EXPECT_EQ(1, counts[i]) << "item " << i;
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Throughput of the mutex based ReferenceQueue compared to the lock-free
+ * SpscReferenceQueue and MpmcReferenceQueue when passing SharedBufferPointer
+ * instances between threads.
+ *
+ * All queues are used through the common SharedBufferQueueBase interface.
+ * Senders retry if the queue is full, receivers block until an item is
+ * available. The batched variant passes the items with sendBatch() and
+ * receiveBatch() instead of send() and receive().
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include <outpost/utils/container/concurrent_reference_queue.h>
+#include <outpost/utils/container/reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+static const uint32_t itemsPerSender = 200000;
+static constexpr size_t queueSize = 64;
+
+using PointerSlice = outpost::Slice<outpost::utils::SharedBufferPointer>;
+
+/**
+ * Returns the number of items per second passed through the queue.
+ */
+double
+measureThroughput(outpost::utils::SharedBufferQueueBase& queue, size_t numberOfSenders)
+{
+    outpost::utils::SharedBufferPool<16, 2> pool;
+    outpost::utils::SharedBufferPointer buffer;
+    pool.allocate(buffer);
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numberOfSenders; ++t)
+    {
+        threads.emplace_back([&]() {
+            for (uint32_t i = 0; i < itemsPerSender; ++i)
+            {
+                outpost::utils::SharedBufferPointer copy(buffer);
+                while (!queue.send(std::move(copy)))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            outpost::utils::SharedBufferPointer received;
+            for (uint32_t i = 0; i < itemsPerSender; ++i)
+            {
+                queue.receive(received);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    return (itemsPerSender * numberOfSenders) / duration.count();
+}
+
+/**
+ * Returns the number of items per second passed from one sender to one
+ * receiver in batches of up to \p batchSize items.
+ */
+double
+measureBatchThroughput(outpost::utils::SharedBufferQueueBase& queue, size_t batchSize)
+{
+    outpost::utils::SharedBufferPool<16, 2> pool;
+    outpost::utils::SharedBufferPointer buffer;
+    pool.allocate(buffer);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread sender([&]() {
+        std::vector<outpost::utils::SharedBufferPointer> batch(batchSize);
+        uint32_t sent = 0;
+        while (sent < itemsPerSender)
+        {
+            const size_t count = std::min<size_t>(batchSize, itemsPerSender - sent);
+            for (size_t i = 0; i < count; ++i)
+            {
+                batch[i] = buffer;
+            }
+
+            size_t offset = 0;
+            while (offset < count)
+            {
+                offset += queue.sendBatch(PointerSlice::unsafe(&batch[offset], count - offset));
+                if (offset < count)
+                {
+                    std::this_thread::yield();
+                }
+            }
+            sent += count;
+        }
+    });
+    std::thread receiver([&]() {
+        std::vector<outpost::utils::SharedBufferPointer> batch(batchSize);
+        uint32_t received = 0;
+        while (received < itemsPerSender)
+        {
+            received += queue.receiveBatch(PointerSlice::unsafe(&batch[0], batchSize));
+        }
+    });
+    sender.join();
+    receiver.join();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+    return itemsPerSender / duration.count();
+}
+}  // namespace
+
+TEST(ReferenceQueueBenchmark, DISABLED_itemsPerSecond)
+{
+    printf("queue size %zu, %u items per sender\n", queueSize, itemsPerSender);
+    printf("senders/receivers | ReferenceQueue [items/s] | SpscReferenceQueue [items/s] | "
+           "MpmcReferenceQueue [items/s]\n");
+    for (size_t senders = 1; senders <= 4; senders *= 2)
+    {
+        outpost::utils::SharedBufferQueue<queueSize> referenceQueue;
+        const double reference = measureThroughput(referenceQueue, senders);
+
+        double spsc = 0;
+        if (senders == 1)
+        {
+            outpost::utils::SpscReferenceQueue<outpost::utils::SharedBufferPointer, queueSize>
+                    spscQueue;
+            spsc = measureThroughput(spscQueue, senders);
+        }
+
+        outpost::utils::MpmcReferenceQueue<outpost::utils::SharedBufferPointer, queueSize>
+                mpmcQueue;
+        const double mpmc = measureThroughput(mpmcQueue, senders);
+
+        if (senders == 1)
+        {
+            printf("%17zu | %24.0f | %28.0f | %28.0f\n", senders, reference, spsc, mpmc);
+        }
+        else
+        {
+            printf("%17zu | %24.0f | %28s | %28.0f\n", senders, reference, "-", mpmc);
+        }
+    }
+}
+
+TEST(ReferenceQueueBenchmark, DISABLED_batchedItemsPerSecond)
+{
+    printf("queue size %zu, %u items, one sender and one receiver\n", queueSize, itemsPerSender);
+    printf("batch size | ReferenceQueue [items/s] | SpscReferenceQueue [items/s] | "
+           "MpmcReferenceQueue [items/s]\n");
+    for (size_t batchSize = 1; batchSize <= queueSize; batchSize *= 4)
+    {
+        outpost::utils::SharedBufferQueue<queueSize> referenceQueue;
+        const double reference = measureBatchThroughput(referenceQueue, batchSize);
+
+        outpost::utils::SpscReferenceQueue<outpost::utils::SharedBufferPointer, queueSize>
+                spscQueue;
+        const double spsc = measureBatchThroughput(spscQueue, batchSize);
+
+        outpost::utils::MpmcReferenceQueue<outpost::utils::SharedBufferPointer, queueSize>
+                mpmcQueue;
+        const double mpmc = measureBatchThroughput(mpmcQueue, batchSize);
+
+        printf("%10zu | %24.0f | %28.0f | %28.0f\n", batchSize, reference, spsc, mpmc);
+    }
+}
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/rtos/queue_set.h>
+#include <outpost/utils/container/concurrent_reference_queue.h>
+#include <outpost/utils/container/reference_queue.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <utility>
+
+using outpost::time::Duration;
+using outpost::time::Milliseconds;
+using outpost::utils::MpmcReferenceQueue;
+using outpost::utils::ReferenceQueue;
+using outpost::utils::ReferenceQueueBase;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+using outpost::utils::SharedBufferQueueBase;
+using outpost::utils::SpscReferenceQueue;
+
+/**
+ * Only implements the single item operations to test the default batch
+ * implementation of ReferenceQueueBase.
+ */
+template <size_t N>
+class SingleItemQueue : public SharedBufferQueueBase
+{
+public:
+    bool
+    send(SharedBufferPointer& data) override
+    {
+        return mQueue.send(data);
+    }
+
+    bool
+    send(SharedBufferPointer&& data) override
+    {
+        return mQueue.send(std::move(data));
+    }
+
+    bool
+    receive(SharedBufferPointer& data, Duration timeout) override
+    {
+        return mQueue.receive(data, timeout);
+    }
+
+    uint16_t
+    getNumberOfItems() override
+    {
+        return mQueue.getNumberOfItems();
+    }
+
+    bool
+    isEmpty() override
+    {
+        return mQueue.isEmpty();
+    }
+
+    bool
+    isFull() override
+    {
+        return mQueue.isFull();
+    }
+
+private:
+    ReferenceQueue<SharedBufferPointer, N> mQueue;
+};
+
+template <typename Queue>
+static void
+checkBatches()
+{
+    SharedBufferPool<16, 8> pool;
+    Queue queue;
+    SharedBufferQueueBase& base = queue;
+
+    SharedBufferPointer pointers[6];
+    for (auto& pointer : pointers)
+    {
+        ASSERT_TRUE(pool.allocate(pointer));
+    }
+    uint8_t* sentBuffers[4];
+    for (size_t i = 0; i < 4; ++i)
+    {
+        sentBuffers[i] = pointers[i];
+    }
+
+    // Capacity of the queue is four
+    EXPECT_EQ(4U, base.sendBatch(outpost::asSlice(pointers)));
+    EXPECT_TRUE(base.isFull());
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(pointers[i] == nullptr);
+    }
+    EXPECT_TRUE(pointers[4].isValid());
+    EXPECT_TRUE(pointers[5].isValid());
+
+    SharedBufferPointer received[8];
+    EXPECT_EQ(3U, base.receiveBatch(outpost::asSlice(received).first(3), 1, Duration::zero()));
+    EXPECT_EQ(1U, base.getNumberOfItems());
+    EXPECT_EQ(1U, base.receiveBatch(outpost::asSlice(received).subSlice(3, 5)));
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(sentBuffers[i], static_cast<uint8_t*>(received[i]));
+        EXPECT_EQ(1U, received[i]->getReferenceCount());
+    }
+    EXPECT_TRUE(base.isEmpty());
+
+    EXPECT_EQ(0U, base.receiveBatch(outpost::asSlice(received), 1, Duration::zero()));
+
+    // Timeout with fewer items than requested
+    EXPECT_TRUE(base.send(std::move(pointers[4])));
+    EXPECT_EQ(1U, base.receiveBatch(outpost::asSlice(received), 2, Milliseconds(5)));
+    EXPECT_TRUE(base.isEmpty());
+}
+
+TEST(ReferenceQueueTest, batches)
+{
+    checkBatches<ReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+TEST(ReferenceQueueTest, defaultBatchImplementation)
+{
+    checkBatches<SingleItemQueue<4>>();
+}
+
+TEST(SpscReferenceQueueTest, batches)
+{
+    checkBatches<SpscReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+TEST(MpmcReferenceQueueTest, batches)
+{
+    checkBatches<MpmcReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+template <typename Queue>
+static void
+checkReceiveBatchWaitsForMinimumNumberOfItems()
+{
+    SharedBufferPool<16, 8> pool;
+    Queue queue;
+    SharedBufferQueueBase& base = queue;
+
+    std::thread sender([&]() {
+        for (size_t i = 0; i < 3; ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            SharedBufferPointer pointer;
+            pool.allocate(pointer);
+            base.send(std::move(pointer));
+        }
+    });
+
+    SharedBufferPointer received[4];
+    const size_t count = base.receiveBatch(outpost::asSlice(received), 3);
+    sender.join();
+
+    EXPECT_EQ(3U, count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        EXPECT_TRUE(received[i].isValid());
+    }
+}
+
+TEST(ReferenceQueueTest, receiveBatchWaitsForMinimumNumberOfItems)
+{
+    checkReceiveBatchWaitsForMinimumNumberOfItems<ReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+TEST(ReferenceQueueTest, defaultReceiveBatchWaitsForMinimumNumberOfItems)
+{
+    checkReceiveBatchWaitsForMinimumNumberOfItems<SingleItemQueue<4>>();
+}
+
+TEST(SpscReferenceQueueTest, receiveBatchWaitsForMinimumNumberOfItems)
+{
+    checkReceiveBatchWaitsForMinimumNumberOfItems<SpscReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+TEST(MpmcReferenceQueueTest, receiveBatchWaitsForMinimumNumberOfItems)
+{
+    checkReceiveBatchWaitsForMinimumNumberOfItems<MpmcReferenceQueue<SharedBufferPointer, 4>>();
+}
+
+TEST(ReferenceQueueTest, batchesLargerThanChunkSize)
+{
+    static const size_t numberOfItems = 40;
+
+    SharedBufferPool<16, numberOfItems> pool;
+    ReferenceQueue<SharedBufferPointer, numberOfItems> queue;
+
+    SharedBufferPointer pointers[numberOfItems + 2];
+    uint8_t* sentBuffers[numberOfItems];
+    for (size_t i = 0; i < numberOfItems; ++i)
+    {
+        ASSERT_TRUE(pool.allocate(pointers[i]));
+        sentBuffers[i] = pointers[i];
+    }
+
+    EXPECT_EQ(numberOfItems, queue.sendBatch(outpost::asSlice(pointers)));
+    EXPECT_TRUE(queue.isFull());
+
+    SharedBufferPointer received[numberOfItems + 2];
+    EXPECT_EQ(numberOfItems,
+              queue.receiveBatch(outpost::asSlice(received), numberOfItems, Duration::zero()));
+    for (size_t i = 0; i < numberOfItems; ++i)
+    {
+        EXPECT_EQ(sentBuffers[i], static_cast<uint8_t*>(received[i]));
+    }
+    EXPECT_TRUE(queue.isEmpty());
+}
+
+TEST(ReferenceQueueTest, shouldNotWaitForMoreItemsThanQueueCapacity)
+{
+    outpost::rtos::Queue<size_t> queue(2);
+    ASSERT_TRUE(queue.send(1));
+    ASSERT_TRUE(queue.send(2));
+
+    size_t received[4];
+    EXPECT_EQ(2U, queue.receiveBatch(outpost::asSlice(received), 4, Duration::infinity()));
+}
+
+TEST(ReferenceQueueTest, queueSetReportsReferenceQueue)
+{
+    SharedBufferPool<16, 4> pool;
+    outpost::rtos::Queue<uint32_t> commands(4);
+    ReferenceQueue<SharedBufferPointer, 4> packets;
+
+    outpost::rtos::QueueSet set(8);
+    ASSERT_TRUE(set.add(commands));
+    ASSERT_TRUE(packets.addTo(set));
+
+    SharedBufferPointer pointer;
+    ASSERT_TRUE(pool.allocate(pointer));
+    EXPECT_TRUE(packets.send(std::move(pointer)));
+
+    size_t index;
+    ASSERT_TRUE(set.wait(index, Duration::zero()));
+    EXPECT_EQ(1U, index);
+    EXPECT_TRUE(packets.receive(pointer, Duration::zero()));
+    EXPECT_TRUE(pointer.isValid());
+    EXPECT_FALSE(set.wait(index, Duration::zero()));
+}
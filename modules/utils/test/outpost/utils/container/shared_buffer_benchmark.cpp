@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * \file
+ * Contention of the SharedBuffer reference counter with multiple
+ * threads copying and dropping pointers, and of the SharedBufferPool
+ * free-list with multiple threads allocating and releasing buffers,
+ * directly or through a per-thread SharedBufferCache.
+ *
+ * Build with -DOUTPOST_UTILS_SHARED_BUFFER_MUTEX to measure the mutex
+ * based reference counting instead of the atomic one.
+ *
+ * The benchmarks are disabled by default. Run them with:
+ *
+ *     runner --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+ */
+
+#include <outpost/utils/container/shared_buffer.h>
+#include <outpost/utils/container/shared_buffer_cache.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+static const uint32_t copiesPerThread = 1000000;
+
+/**
+ * Returns the number of copy/drop pairs per second over all threads.
+ *
+ * \param sharedBuffer
+ *      All threads copy the same pointer if true, otherwise every
+ *      thread uses its own buffer.
+ */
+double
+measureCopies(size_t numberOfThreads, bool sharedBuffer)
+{
+    outpost::utils::SharedBufferPool<16, 8> pool;
+    std::vector<outpost::utils::SharedBufferPointer> pointers(numberOfThreads);
+    for (size_t i = 0; i < numberOfThreads; ++i)
+    {
+        if (sharedBuffer && (i > 0))
+        {
+            pointers[i] = pointers[0];
+        }
+        else
+        {
+            pool.allocate(pointers[i]);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        const outpost::utils::SharedBufferPointer& pointer = pointers[t];
+        threads.emplace_back([&pointer]() {
+            for (uint32_t i = 0; i < copiesPerThread; ++i)
+            {
+                outpost::utils::SharedBufferPointer copy(pointer);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(sharedBuffer ? numberOfThreads : 1U, pointers[0]->getReferenceCount());
+    return (numberOfThreads * copiesPerThread) / elapsed.count();
+}
+static const uint32_t allocationsPerThread = 200000;
+static const size_t buffersPerThread = 4;
+
+/**
+ * Returns the number of allocate/release pairs per second over all threads.
+ *
+ * \param freeStride
+ *      Only every freeStride-th buffer of the pool is free during the
+ *      measurement, all others stay allocated. 1 for an empty pool.
+ * \param useCache
+ *      Allocate through a SharedBufferCache per thread instead of
+ *      directly from the pool.
+ */
+template <size_t N>
+double
+measureAllocations(size_t numberOfThreads, size_t freeStride, bool useCache)
+{
+    static outpost::utils::SharedBufferPool<16, N> pool;
+    std::atomic<uint32_t> hits(0);
+    std::atomic<uint32_t> misses(0);
+    std::vector<outpost::utils::SharedBufferPointer> held(N);
+    for (auto& pointer : held)
+    {
+        pool.allocate(pointer);
+    }
+    for (size_t i = 0; i < N; i += freeStride)
+    {
+        held[i] = outpost::utils::SharedBufferPointer();
+    }
+
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        threads.emplace_back([&]() {
+            outpost::utils::SharedBufferCache<8> cache(pool);
+            outpost::utils::SharedBufferPoolBase& allocator =
+                    useCache ? static_cast<outpost::utils::SharedBufferPoolBase&>(cache) : pool;
+            outpost::utils::SharedBufferPointer pointers[buffersPerThread];
+            for (uint32_t i = 0; i < allocationsPerThread; i += buffersPerThread)
+            {
+                for (auto& pointer : pointers)
+                {
+                    allocator.allocate(pointer);
+                }
+                for (auto& pointer : pointers)
+                {
+                    pointer = outpost::utils::SharedBufferPointer();
+                }
+            }
+            cache.flush();
+
+            hits += cache.getNumberOfHits();
+            misses += cache.getNumberOfMisses();
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    held.clear();
+    EXPECT_EQ(N, pool.numberOfFreeElements());
+    if (useCache)
+    {
+        printf("        cache hit rate %.1f %%\n", (100.0 * hits) / (hits + misses));
+    }
+    return (numberOfThreads * allocationsPerThread) / elapsed.count();
+}
+}  // namespace
+
+TEST(SharedBufferBenchmark, DISABLED_copiesPerSecond)
+{
+#ifdef OUTPOST_UTILS_SHARED_BUFFER_ATOMIC
+    printf("reference counting: std::atomic\n");
+#else
+    printf("reference counting: outpost::rtos::Mutex\n");
+#endif
+    printf("threads | same buffer [copies/s] | own buffer [copies/s]\n");
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        double same = measureCopies(threads, true);
+        double own = measureCopies(threads, false);
+        printf("%7zu | %22.0f | %21.0f\n", threads, same, own);
+    }
+}
+
+TEST(SharedBufferBenchmark, DISABLED_allocationsPerSecond)
+{
+    static constexpr size_t poolSize = 1024;
+
+    static constexpr size_t freeStride = poolSize / (8 * buffersPerThread);
+
+    printf("threads | empty pool [allocations/s] | %zu of %zu used [allocations/s]\n",
+           poolSize - poolSize / freeStride,
+           poolSize);
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        double empty = measureAllocations<poolSize>(threads, 1, false);
+        double occupied = measureAllocations<poolSize>(threads, freeStride, false);
+        printf("%7zu | %26.0f | %25.0f\n", threads, empty, occupied);
+    }
+}
+
+TEST(SharedBufferBenchmark, DISABLED_cachedAllocationsPerSecond)
+{
+    static constexpr size_t poolSize = 1024;
+
+    printf("threads | pool [allocations/s] | cache of 8 [allocations/s]\n");
+    for (size_t threads = 1; threads <= 8; threads *= 2)
+    {
+        double direct = measureAllocations<poolSize>(threads, 1, false);
+        double cached = measureAllocations<poolSize>(threads, 1, true);
+        printf("%7zu | %20.0f | %26.0f\n", threads, direct, cached);
+    }
+}
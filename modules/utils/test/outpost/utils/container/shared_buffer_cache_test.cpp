@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/utils/container/shared_buffer_cache.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using outpost::utils::SharedBufferCache;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+
+TEST(SharedBufferPoolTest, allocateBatch)
+{
+    SharedBufferPool<16, 5> pool;
+    SharedBufferPointer pointers[3];
+
+    EXPECT_EQ(3U, pool.allocateBatch(outpost::asSlice(pointers)));
+    EXPECT_EQ(2U, pool.numberOfFreeElements());
+    for (auto& pointer : pointers)
+    {
+        ASSERT_TRUE(pointer.isValid());
+        EXPECT_EQ(1U, pointer->getReferenceCount());
+    }
+    EXPECT_TRUE(pointers[0] != pointers[1]);
+    EXPECT_TRUE(pointers[1] != pointers[2]);
+
+    SharedBufferPointer more[3];
+    EXPECT_EQ(2U, pool.allocateBatch(outpost::asSlice(more)));
+    EXPECT_EQ(0U, pool.numberOfFreeElements());
+    EXPECT_FALSE(more[2].isValid());
+    EXPECT_EQ(0U, pool.allocateBatch(outpost::asSlice(more).subSlice(2, 1)));
+
+    pointers[1] = SharedBufferPointer();
+    EXPECT_EQ(1U, pool.numberOfFreeElements());
+}
+
+TEST(SharedBufferCacheTest, shouldRefillInBatches)
+{
+    SharedBufferPool<16, 10> pool;
+    SharedBufferCache<4> cache(pool, 3);
+
+    SharedBufferPointer pointer;
+    ASSERT_TRUE(cache.allocate(pointer));
+    EXPECT_EQ(2U, cache.getNumberOfCachedBuffers());
+    EXPECT_EQ(7U, pool.numberOfFreeElements());
+    EXPECT_EQ(9U, cache.numberOfFreeElements());
+    EXPECT_EQ(10U, cache.numberOfElements());
+    EXPECT_EQ(1U, pointer->getReferenceCount());
+
+    SharedBufferPointer second;
+    SharedBufferPointer third;
+    EXPECT_TRUE(cache.allocate(second));
+    EXPECT_TRUE(cache.allocate(third));
+    EXPECT_EQ(0U, cache.getNumberOfCachedBuffers());
+    EXPECT_EQ(2U, cache.getNumberOfHits());
+    EXPECT_EQ(1U, cache.getNumberOfMisses());
+
+    // Released buffers go back to the pool, not to the cache
+    second = SharedBufferPointer();
+    EXPECT_EQ(8U, pool.numberOfFreeElements());
+    EXPECT_EQ(0U, cache.getNumberOfCachedBuffers());
+
+    cache.resetCounters();
+    EXPECT_EQ(0U, cache.getNumberOfHits());
+    EXPECT_EQ(0U, cache.getNumberOfMisses());
+}
+
+TEST(SharedBufferCacheTest, shouldBoundCachedBuffers)
+{
+    SharedBufferPool<16, 10> pool;
+    SharedBufferCache<2> cache(pool, 8);
+
+    SharedBufferPointer pointer;
+    ASSERT_TRUE(cache.allocate(pointer));
+    EXPECT_EQ(1U, cache.getNumberOfCachedBuffers());
+    EXPECT_EQ(8U, pool.numberOfFreeElements());
+
+    cache.flush();
+    EXPECT_EQ(0U, cache.getNumberOfCachedBuffers());
+    EXPECT_EQ(9U, pool.numberOfFreeElements());
+
+    {
+        SharedBufferCache<4> temporary(pool);
+        SharedBufferPointer other;
+        ASSERT_TRUE(temporary.allocate(other));
+        EXPECT_EQ(1U, temporary.getNumberOfCachedBuffers());
+    }
+    EXPECT_EQ(9U, pool.numberOfFreeElements());
+}
+
+TEST(SharedBufferCacheTest, shouldServeRemainingBuffersIfPoolIsAlmostEmpty)
+{
+    SharedBufferPool<16, 3> pool;
+    SharedBufferCache<4> cache(pool, 4);
+
+    SharedBufferPointer pointers[4];
+    EXPECT_TRUE(cache.allocate(pointers[0]));
+    EXPECT_TRUE(cache.allocate(pointers[1]));
+    EXPECT_TRUE(cache.allocate(pointers[2]));
+    EXPECT_FALSE(cache.allocate(pointers[3]));
+    EXPECT_EQ(2U, cache.getNumberOfMisses());
+
+    pointers[0] = SharedBufferPointer();
+    EXPECT_TRUE(cache.allocate(pointers[3]));
+}
+
+TEST(SharedBufferCacheTest, shouldWorkWithCachesInMultipleThreads)
+{
+    static constexpr size_t numberOfThreads = 4;
+    SharedBufferPool<16, 32> pool;
+
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> hits(numberOfThreads, 0);
+    std::vector<int> errors(numberOfThreads, 0);
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        threads.emplace_back([&, t]() {
+            SharedBufferCache<4> cache(pool);
+            for (int i = 0; i < 5000; ++i)
+            {
+                SharedBufferPointer pointer;
+                if (!cache.allocate(pointer) || (pointer->getReferenceCount() != 1))
+                {
+                    errors[t]++;
+                }
+            }
+            hits[t] = cache.getNumberOfHits();
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        EXPECT_EQ(0, errors[t]);
+        EXPECT_GT(hits[t], 0U);
+    }
+    EXPECT_EQ(32U, pool.numberOfFreeElements());
+}
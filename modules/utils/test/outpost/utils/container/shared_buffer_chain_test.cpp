@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/utils/container/shared_buffer_chain.h>
+#include <outpost/utils/container/shared_object_pool.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+using outpost::utils::SharedBufferChain;
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+using outpost::utils::SharedChildPointer;
+
+class SharedBufferChainTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        ASSERT_TRUE(mPool.allocate(mHeader));
+        ASSERT_TRUE(mPool.allocate(mPayload));
+        for (size_t i = 0; i < 8; ++i)
+        {
+            mHeader[i] = static_cast<uint8_t>(0xA0 + i);
+            mPayload[i] = static_cast<uint8_t>(i);
+        }
+    }
+
+    SharedBufferPool<8, 4> mPool;
+    SharedBufferPointer mHeader;
+    SharedBufferPointer mPayload;
+};
+
+TEST_F(SharedBufferChainTest, shouldKeepSegmentsWithoutCopying)
+{
+    SharedBufferChain<3> chain;
+    EXPECT_TRUE(chain.isEmpty());
+    EXPECT_EQ(3U, chain.getMaximumNumberOfSegments());
+
+    SharedChildPointer child;
+    ASSERT_TRUE(mPayload.getChild(child, 0, 2, 4));
+
+    EXPECT_TRUE(chain.append(mHeader, 0, 2));
+    EXPECT_TRUE(chain.append(child));
+    EXPECT_EQ(2U, chain.getNumberOfSegments());
+    EXPECT_EQ(6U, chain.getLength());
+
+    EXPECT_EQ(&mHeader[0], &chain.getSegment(0)[0]);
+    EXPECT_EQ(2U, chain.getSegment(0).getNumberOfElements());
+    EXPECT_EQ(&mPayload[2], &chain.getSegment(1)[0]);
+    EXPECT_EQ(4U, chain.getSegment(1).getNumberOfElements());
+
+    // Changes to the buffers are visible through the chain
+    mPayload[2] = 0x55;
+    EXPECT_EQ(0x55, chain.getSegment(1)[0]);
+}
+
+TEST_F(SharedBufferChainTest, shouldHoldReferencesUntilCleared)
+{
+    SharedBufferChain<2> chain;
+    EXPECT_TRUE(chain.append(mHeader));
+    EXPECT_TRUE(chain.append(mPayload, 4, 4));
+
+    mHeader = SharedBufferPointer();
+    mPayload = SharedBufferPointer();
+    EXPECT_EQ(2U, mPool.numberOfFreeElements());
+    EXPECT_EQ(0xA0, chain.getSegment(0)[0]);
+    EXPECT_EQ(4, chain.getSegment(1)[0]);
+
+    chain.clear();
+    EXPECT_TRUE(chain.isEmpty());
+    EXPECT_EQ(0U, chain.getLength());
+    EXPECT_EQ(4U, mPool.numberOfFreeElements());
+}
+
+TEST_F(SharedBufferChainTest, shouldRejectInvalidSegments)
+{
+    SharedBufferChain<2> chain;
+    EXPECT_FALSE(chain.append(SharedBufferPointer()));
+    EXPECT_FALSE(chain.append(mPayload, 6, 4));
+    EXPECT_FALSE(chain.append(mPayload, 0, 0));
+
+    // Ranges are relative to the range of a child
+    SharedChildPointer child;
+    ASSERT_TRUE(mPayload.getChild(child, 0, 4, 2));
+    EXPECT_FALSE(chain.append(child, 1, 2));
+    EXPECT_TRUE(chain.append(child, 1, 1));
+    EXPECT_EQ(5, chain.getSegment(0)[0]);
+
+    EXPECT_TRUE(chain.append(mHeader));
+    EXPECT_TRUE(chain.isFull());
+    EXPECT_FALSE(chain.append(mPayload));
+    EXPECT_EQ(2U, chain.getNumberOfSegments());
+    EXPECT_EQ(9U, chain.getLength());
+}
+
+TEST_F(SharedBufferChainTest, shouldGatherSegments)
+{
+    SharedBufferChain<2> chain;
+    chain.append(mHeader, 0, 3);
+    chain.append(mPayload, 1, 2);
+
+    std::array<uint8_t, 8> data;
+    data.fill(0xFF);
+    EXPECT_EQ(5U, chain.copyTo(outpost::asSlice(data)));
+    const std::array<uint8_t, 8> expected = {{0xA0, 0xA1, 0xA2, 1, 2, 0xFF, 0xFF, 0xFF}};
+    EXPECT_EQ(expected, data);
+
+    // Truncated if the destination is too small
+    data.fill(0xFF);
+    EXPECT_EQ(4U, chain.copyTo(outpost::asSlice(data).first(4)));
+    EXPECT_EQ(1, data[3]);
+    EXPECT_EQ(0xFF, data[4]);
+}
+
+TEST_F(SharedBufferChainTest, shouldSerializeSegments)
+{
+    SharedBufferChain<2> chain;
+    chain.append(mHeader, 6, 2);
+    chain.append(mPayload, 0, 3);
+
+    std::array<uint8_t, 8> data;
+    data.fill(0);
+    outpost::Serialize stream(outpost::asSlice(data));
+    stream.store<uint8_t>(0x11);
+    chain.serialize(stream);
+    stream.store<uint8_t>(0x22);
+
+    EXPECT_EQ(7U, stream.getPosition());
+    const std::array<uint8_t, 8> expected = {{0x11, 0xA6, 0xA7, 0, 1, 2, 0x22, 0}};
+    EXPECT_EQ(expected, data);
+}
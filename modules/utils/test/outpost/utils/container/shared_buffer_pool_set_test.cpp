@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/utils/container/shared_buffer_pool_set.h>
+
+#include <gtest/gtest.h>
+
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+using outpost::utils::SharedBufferPoolSet;
+using outpost::utils::SharedBufferPoolSetStorage;
+
+TEST(SharedBufferPoolSetTest, shouldCreateSizeClasses)
+{
+    SharedBufferPoolSetStorage<16, 4, 2, 0, 1> pools;
+
+    ASSERT_EQ(3U, pools.getNumberOfClasses());
+    EXPECT_EQ(16U, pools.getStatistics(0).elementSize);
+    EXPECT_EQ(4U, pools.getStatistics(0).numberOfElements);
+    EXPECT_EQ(32U, pools.getStatistics(1).elementSize);
+    EXPECT_EQ(128U, pools.getStatistics(2).elementSize);
+    EXPECT_EQ(1U, pools.getStatistics(2).numberOfElements);
+
+    EXPECT_EQ(7U, pools.numberOfElements());
+    EXPECT_EQ(7U, pools.numberOfFreeElements());
+    EXPECT_EQ(128U, pools.elementSize());
+}
+
+TEST(SharedBufferPoolSetTest, shouldSelectBestFit)
+{
+    SharedBufferPoolSetStorage<16, 2, 2, 2> pools;
+
+    SharedBufferPointer small;
+    ASSERT_TRUE(pools.allocate(small, 12));
+    EXPECT_EQ(16U, small.getLength());
+
+    SharedBufferPointer exact;
+    ASSERT_TRUE(pools.allocate(exact, 32));
+    EXPECT_EQ(32U, exact.getLength());
+
+    SharedBufferPointer large;
+    ASSERT_TRUE(pools.allocate(large, 33));
+    EXPECT_EQ(64U, large.getLength());
+
+    SharedBufferPointer tooLarge;
+    EXPECT_FALSE(pools.allocate(tooLarge, 65));
+    EXPECT_EQ(1U, pools.getNumberOfFailedAllocations());
+
+    SharedBufferPointer any;
+    ASSERT_TRUE(pools.allocate(any));
+    EXPECT_EQ(64U, any.getLength());
+
+    SharedBufferPoolSet::ClassStatistics statistics = pools.getStatistics(0);
+    EXPECT_EQ(1U, statistics.numberOfAllocations);
+    EXPECT_EQ(1U, statistics.numberOfFreeElements);
+    EXPECT_EQ(0U, statistics.numberOfFallbacks);
+    EXPECT_EQ(0U, pools.getStatistics(2).numberOfFreeElements);
+}
+
+TEST(SharedBufferPoolSetTest, shouldFallBackToLargerClass)
+{
+    SharedBufferPoolSetStorage<16, 1, 1> pools;
+
+    SharedBufferPointer first;
+    SharedBufferPointer second;
+    SharedBufferPointer third;
+    ASSERT_TRUE(pools.allocate(first, 1));
+    ASSERT_TRUE(pools.allocate(second, 1));
+    EXPECT_EQ(16U, first.getLength());
+    EXPECT_EQ(32U, second.getLength());
+    EXPECT_FALSE(pools.allocate(third, 1));
+
+    EXPECT_EQ(1U, pools.getStatistics(1).numberOfFallbacks);
+    EXPECT_EQ(0U, pools.numberOfFreeElements());
+
+    first = SharedBufferPointer();
+    EXPECT_EQ(1U, pools.getStatistics(0).numberOfFreeElements);
+
+    pools.resetStatistics();
+    EXPECT_EQ(0U, pools.getStatistics(1).numberOfAllocations);
+    EXPECT_EQ(0U, pools.getStatistics(1).numberOfFallbacks);
+    EXPECT_EQ(0U, pools.getNumberOfFailedAllocations());
+}
+
+TEST(SharedBufferPoolSetTest, shouldRejectInvalidPools)
+{
+    SharedBufferPool<32, 1> pool32;
+    SharedBufferPool<16, 1> pool16;
+    SharedBufferPool<48, 1> pool48;
+
+    SharedBufferPoolSet pools;
+    EXPECT_EQ(0U, pools.elementSize());
+    EXPECT_TRUE(pools.addPool(pool32));
+    EXPECT_FALSE(pools.addPool(pool16));
+    EXPECT_FALSE(pools.addPool(pool32));
+    EXPECT_FALSE(pools.addPool(pool48));
+    EXPECT_EQ(1U, pools.getNumberOfClasses());
+}
+
+TEST(SharedBufferPoolSetTest, shouldCheckMinimumSizeOfSinglePool)
+{
+    SharedBufferPool<32, 1> pool;
+    SharedBufferPointer pointer;
+
+    EXPECT_FALSE(pool.allocate(pointer, 33));
+    EXPECT_EQ(1U, pool.numberOfFreeElements());
+    EXPECT_TRUE(pool.allocate(pointer, 32));
+    EXPECT_EQ(0U, pool.numberOfFreeElements());
+}
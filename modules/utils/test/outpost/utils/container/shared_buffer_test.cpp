@@ -13,8 +13,10 @@
  */
 
 #include <outpost/rtos/thread.h>
+#include <outpost/utils/container/reference_queue.h>
 #include <outpost/utils/container/shared_buffer.h>
 #include <outpost/utils/container/shared_object_pool.h>
+#include <outpost/utils/container/shared_ring_buffer.h>
 #include <outpost/utils/storage/serialize.h>
 
 #include <gmock/gmock.h>
@@ -22,11 +24,94 @@
 
 #include <unittest/utils/container/reference_queue_stub.h>
 
+#include <thread>
+#include <utility>
+#include <vector>
+
 using namespace testing;
 
 static constexpr size_t poolSize = 1500;
 static constexpr size_t objectSize = 160;
 
+/**
+ * SharedBufferPointer that counts all operations changing the reference count
+ * of a valid buffer.
+ */
+class CountingPointer : public outpost::utils::SharedBufferPointer
+{
+public:
+    CountingPointer() = default;
+
+    explicit CountingPointer(const outpost::utils::SharedBufferPointer& pointer) :
+        outpost::utils::SharedBufferPointer(pointer)
+    {
+    }
+
+    CountingPointer(const CountingPointer& other) : outpost::utils::SharedBufferPointer(other)
+    {
+        countIncrement();
+    }
+
+    CountingPointer(CountingPointer&& other) = default;
+
+    ~CountingPointer()
+    {
+        countDecrement();
+    }
+
+    CountingPointer&
+    operator=(const CountingPointer& other)
+    {
+        if (&other != this)
+        {
+            countDecrement();
+            outpost::utils::SharedBufferPointer::operator=(other);
+            countIncrement();
+        }
+        return *this;
+    }
+
+    CountingPointer&
+    operator=(CountingPointer&& other)
+    {
+        countDecrement();
+        outpost::utils::SharedBufferPointer::operator=(std::move(other));
+        return *this;
+    }
+
+    static void
+    reset()
+    {
+        increments = 0;
+        decrements = 0;
+    }
+
+    static size_t increments;
+    static size_t decrements;
+
+private:
+    void
+    countIncrement() const
+    {
+        if (mPtr != nullptr)
+        {
+            increments++;
+        }
+    }
+
+    void
+    countDecrement() const
+    {
+        if (mPtr != nullptr)
+        {
+            decrements++;
+        }
+    }
+};
+
+size_t CountingPointer::increments = 0;
+size_t CountingPointer::decrements = 0;
+
 class SharedBufferTest : public testing::Test
 {
 public:
@@ -385,3 +470,211 @@ TEST_F(SharedBufferTest, allocateChildChildBuffer)
 
     EXPECT_EQ(mPool.numberOfFreeElements(), poolSize);
 }
+
+TEST_F(SharedBufferTest, concurrentCopiesKeepReferenceCount)
+{
+    outpost::utils::SharedBufferPointer pointer;
+    ASSERT_TRUE(mPool.allocate(pointer));
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&pointer]() {
+            for (int i = 0; i < 10000; ++i)
+            {
+                outpost::utils::SharedBufferPointer copy(pointer);
+                outpost::utils::SharedBufferPointer other;
+                other = copy;
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(1U, pointer->getReferenceCount());
+    EXPECT_EQ(mPool.numberOfFreeElements(), poolSize - 1);
+
+    pointer = outpost::utils::SharedBufferPointer();
+    EXPECT_EQ(mPool.numberOfFreeElements(), poolSize);
+}
+
+TEST_F(SharedBufferTest, moveKeepsReferenceCount)
+{
+    outpost::utils::SharedBufferPointer pointer;
+    ASSERT_TRUE(mPool.allocate(pointer));
+    pointer.setType(3);
+
+    outpost::utils::SharedBufferPointer moved(std::move(pointer));
+    EXPECT_TRUE(pointer == nullptr);
+    EXPECT_EQ(0U, pointer.getLength());
+    EXPECT_EQ(1U, moved->getReferenceCount());
+    EXPECT_EQ(3U, moved.getType());
+    EXPECT_EQ(objectSize, moved.getLength());
+
+    outpost::utils::SharedBufferPointer other;
+    ASSERT_TRUE(mPool.allocate(other));
+    other = std::move(moved);
+    EXPECT_TRUE(moved == nullptr);
+    EXPECT_EQ(1U, other->getReferenceCount());
+    EXPECT_EQ(mPool.numberOfFreeElements(), poolSize - 1);
+
+    outpost::utils::SharedChildPointer child;
+    ASSERT_TRUE(other.getChild(child, 1, 2, 10));
+    EXPECT_EQ(3U, other->getReferenceCount());
+
+    outpost::utils::SharedChildPointer movedChild(std::move(child));
+    EXPECT_TRUE(child == nullptr);
+    EXPECT_FALSE(child.isChild());
+    EXPECT_TRUE(movedChild.isChild());
+    EXPECT_EQ(3U, other->getReferenceCount());
+
+    child = std::move(movedChild);
+    EXPECT_TRUE(movedChild == nullptr);
+    EXPECT_EQ(10U, child.getLength());
+    EXPECT_EQ(3U, other->getReferenceCount());
+
+    other = outpost::utils::SharedBufferPointer();
+    child = outpost::utils::SharedChildPointer();
+    EXPECT_EQ(mPool.numberOfFreeElements(), poolSize);
+}
+
+TEST_F(SharedBufferTest, referenceQueueHandOffDoesNotTouchReferenceCount)
+{
+    outpost::utils::ReferenceQueue<CountingPointer, 4> queue;
+
+    outpost::utils::SharedBufferPointer buffer;
+    ASSERT_TRUE(mPool.allocate(buffer));
+    CountingPointer pointer(buffer);
+    buffer = outpost::utils::SharedBufferPointer();
+
+    CountingPointer::reset();
+    EXPECT_TRUE(queue.send(std::move(pointer)));
+    EXPECT_TRUE(pointer == nullptr);
+
+    CountingPointer received;
+    EXPECT_TRUE(queue.receive(received, outpost::time::Duration::zero()));
+    EXPECT_EQ(0U, CountingPointer::increments);
+    EXPECT_EQ(0U, CountingPointer::decrements);
+    EXPECT_EQ(1U, received->getReferenceCount());
+
+    // Sending by reference keeps the sender's reference and therefore needs a copy
+    EXPECT_TRUE(queue.send(received));
+    EXPECT_EQ(1U, CountingPointer::increments);
+    EXPECT_EQ(2U, received->getReferenceCount());
+
+    received = CountingPointer();
+    EXPECT_EQ(1U, CountingPointer::decrements);
+    EXPECT_TRUE(queue.receive(received, outpost::time::Duration::zero()));
+    EXPECT_EQ(1U, CountingPointer::increments);
+    EXPECT_EQ(1U, CountingPointer::decrements);
+    EXPECT_EQ(1U, received->getReferenceCount());
+}
+
+TEST_F(SharedBufferTest, referenceQueueKeepsDataIfFull)
+{
+    outpost::utils::ReferenceQueue<CountingPointer, 1> queue;
+
+    outpost::utils::SharedBufferPointer buffer;
+    ASSERT_TRUE(mPool.allocate(buffer));
+    CountingPointer first(buffer);
+    CountingPointer second(buffer);
+    buffer = outpost::utils::SharedBufferPointer();
+
+    CountingPointer::reset();
+    EXPECT_TRUE(queue.send(std::move(first)));
+    EXPECT_FALSE(queue.send(std::move(second)));
+    EXPECT_TRUE(second.isValid());
+    EXPECT_EQ(2U, second->getReferenceCount());
+    EXPECT_EQ(0U, CountingPointer::increments);
+    EXPECT_EQ(0U, CountingPointer::decrements);
+}
+
+TEST_F(SharedBufferTest, ringBufferAppendMovesPointer)
+{
+    outpost::utils::SharedRingBufferStorage<2> ringBuffer;
+
+    outpost::utils::SharedBufferPointer pointer;
+    ASSERT_TRUE(mPool.allocate(pointer));
+
+    EXPECT_TRUE(ringBuffer.append(std::move(pointer), 5));
+    EXPECT_TRUE(pointer == nullptr);
+    EXPECT_EQ(1U, ringBuffer.read()->getReferenceCount());
+    EXPECT_EQ(5U, ringBuffer.readFlags());
+
+    EXPECT_TRUE(ringBuffer.pop());
+    EXPECT_EQ(mPool.numberOfFreeElements(), poolSize);
+}
+
+TEST_F(SharedBufferTest, releasedBufferIsAllocatedFirst)
+{
+    outpost::utils::SharedBufferPool<objectSize, 3> pool;
+    outpost::utils::SharedBufferPointer pointers[3];
+    for (auto& pointer : pointers)
+    {
+        ASSERT_TRUE(pool.allocate(pointer));
+    }
+    EXPECT_EQ(0U, pool.numberOfFreeElements());
+
+    outpost::utils::SharedBufferPointer failed;
+    EXPECT_FALSE(pool.allocate(failed));
+
+    outpost::utils::SharedBuffer* released = &(*pointers[1]);
+    outpost::utils::SharedBufferPointer copy = pointers[1];
+    pointers[1] = outpost::utils::SharedBufferPointer();
+    EXPECT_EQ(0U, pool.numberOfFreeElements());
+
+    copy = outpost::utils::SharedBufferPointer();
+    EXPECT_EQ(1U, pool.numberOfFreeElements());
+
+    ASSERT_TRUE(pool.allocate(pointers[1]));
+    EXPECT_TRUE(pointers[1] == released);
+    EXPECT_EQ(1U, pointers[1]->getReferenceCount());
+}
+
+TEST_F(SharedBufferTest, concurrentAllocateAndRelease)
+{
+    static constexpr size_t numberOfThreads = 4;
+    static constexpr size_t buffersPerThread = 8;
+    outpost::utils::SharedBufferPool<16, numberOfThreads * buffersPerThread> pool;
+
+    std::vector<std::thread> threads;
+    std::vector<int> errors(numberOfThreads, 0);
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        threads.emplace_back([&pool, &errors, t]() {
+            outpost::utils::SharedBufferPointer pointers[buffersPerThread];
+            for (int i = 0; i < 2000; ++i)
+            {
+                for (auto& pointer : pointers)
+                {
+                    if (!pool.allocate(pointer) || (pointer->getReferenceCount() != 1))
+                    {
+                        errors[t]++;
+                    }
+                    // Exclusive ownership: nobody else may write to the buffer
+                    pointer[0] = static_cast<uint8_t>(t);
+                }
+                for (auto& pointer : pointers)
+                {
+                    if (pointer[0] != static_cast<uint8_t>(t))
+                    {
+                        errors[t]++;
+                    }
+                    pointer = outpost::utils::SharedBufferPointer();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < numberOfThreads; ++t)
+    {
+        EXPECT_EQ(0, errors[t]);
+    }
+    EXPECT_EQ(pool.numberOfElements(), pool.numberOfFreeElements());
+}
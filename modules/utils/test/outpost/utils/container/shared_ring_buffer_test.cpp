@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2020, German Aerospace Center (DLR)
+ *
+ * This file is part of the development version of OUTPOST.
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include <outpost/utils/container/shared_object_pool.h>
+#include <outpost/utils/container/shared_ring_buffer.h>
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+#include <thread>
+#include <utility>
+
+using outpost::utils::SharedBufferPointer;
+using outpost::utils::SharedBufferPool;
+using outpost::utils::SharedRingBufferStorage;
+using outpost::utils::SharedRingBufferWindow;
+using outpost::utils::SpscSharedRingBuffer;
+using outpost::utils::SpscSharedRingBufferStorage;
+
+class SharedRingBufferTest : public testing::Test
+{
+public:
+    virtual void
+    SetUp() override
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            ASSERT_TRUE(mPool.allocate(mPointers[i]));
+            mPointers[i][0] = static_cast<uint8_t>(i);
+        }
+    }
+
+    SharedBufferPool<4, 8> mPool;
+    SharedBufferPointer mPointers[8];
+};
+
+TEST_F(SharedRingBufferTest, shouldWrapAround)
+{
+    SharedRingBufferStorage<3> ringBuffer;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_TRUE(ringBuffer.append(mPointers[i], static_cast<uint8_t>(i)));
+        EXPECT_EQ(i, ringBuffer.read()[0]);
+        EXPECT_EQ(i, ringBuffer.readFlags());
+        EXPECT_TRUE(ringBuffer.pop());
+    }
+    EXPECT_TRUE(ringBuffer.isEmpty());
+}
+
+TEST_F(SharedRingBufferTest, shouldPeekRange)
+{
+    SharedRingBufferStorage<3> ringBuffer;
+    ringBuffer.append(mPointers[0]);
+    ringBuffer.append(mPointers[1]);
+    ringBuffer.pop();
+    ringBuffer.pop();
+    for (size_t i = 2; i < 5; ++i)
+    {
+        ringBuffer.append(mPointers[i], static_cast<uint8_t>(i));
+    }
+
+    // Wraps around the end of the storage
+    SharedRingBufferWindow window = ringBuffer.peek(0, 3);
+    ASSERT_EQ(3U, window.getNumberOfElements());
+    for (size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(window[i] == mPointers[i + 2]);
+        EXPECT_EQ(i + 2, window.getFlags(i));
+    }
+
+    window = ringBuffer.peek(1, 5);
+    ASSERT_EQ(2U, window.getNumberOfElements());
+    EXPECT_TRUE(window[0] == mPointers[3]);
+
+    window.setFlags(0, 0x80);
+    EXPECT_EQ(0x80, ringBuffer.peekFlags(1));
+    EXPECT_EQ(3U, ringBuffer.getUsedSlots());
+
+    EXPECT_EQ(0U, ringBuffer.peek(3, 1).getNumberOfElements());
+}
+
+TEST_F(SharedRingBufferTest, shouldHandleOutOfRangePeekIndex)
+{
+    SharedRingBufferStorage<3> ringBuffer;
+    ringBuffer.append(mPointers[0], 1);
+    ringBuffer.append(mPointers[1], 2);
+
+    EXPECT_EQ(0U, ringBuffer.peek(SIZE_MAX, 1).getNumberOfElements());
+    EXPECT_EQ(0U, ringBuffer.peek(SIZE_MAX, SIZE_MAX).getNumberOfElements());
+
+    // Wraps around like the previous modulo implementation
+    EXPECT_EQ(2, ringBuffer.peekFlags(4));
+    ringBuffer.peekFlags(SIZE_MAX);
+}
+
+TEST_F(SharedRingBufferTest, spscShouldUsePowerOfTwoCapacity)
+{
+    SharedBufferPointer storage[6];
+    uint8_t flags[6];
+    SpscSharedRingBuffer ringBuffer(outpost::asSlice(storage), outpost::asSlice(flags));
+    EXPECT_EQ(4U, ringBuffer.getCapacity());
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ringBuffer.append(mPointers[i]));
+    }
+    EXPECT_EQ(0U, ringBuffer.getFreeSlots());
+    EXPECT_FALSE(ringBuffer.append(mPointers[4]));
+    EXPECT_TRUE(storage[4] == nullptr);
+}
+
+TEST_F(SharedRingBufferTest, spscShouldAppendAndPop)
+{
+    SpscSharedRingBufferStorage<4> ringBuffer;
+    EXPECT_TRUE(ringBuffer.isEmpty());
+    EXPECT_FALSE(ringBuffer.pop());
+
+    EXPECT_TRUE(ringBuffer.append(std::move(mPointers[0]), 7));
+    EXPECT_TRUE(mPointers[0] == nullptr);
+    EXPECT_EQ(1U, ringBuffer.getUsedSlots());
+    EXPECT_EQ(3U, ringBuffer.getFreeSlots());
+    EXPECT_EQ(0, ringBuffer.read()[0]);
+    EXPECT_EQ(7, ringBuffer.readFlags());
+
+    ringBuffer.setFlags(9);
+    EXPECT_EQ(9, ringBuffer.readFlags());
+
+    SharedBufferPointer pointer;
+    EXPECT_TRUE(ringBuffer.pop(pointer));
+    EXPECT_EQ(1U, pointer->getReferenceCount());
+    EXPECT_TRUE(ringBuffer.isEmpty());
+    EXPECT_FALSE(ringBuffer.pop(pointer));
+
+    // The ring buffer must not keep references to removed elements
+    for (size_t i = 1; i < 8; ++i)
+    {
+        EXPECT_TRUE(ringBuffer.append(std::move(mPointers[i])));
+        EXPECT_TRUE(ringBuffer.pop());
+    }
+    pointer = SharedBufferPointer();
+    EXPECT_EQ(8U, mPool.numberOfFreeElements());
+}
+
+TEST_F(SharedRingBufferTest, spscShouldPeekAndPopRange)
+{
+    SpscSharedRingBufferStorage<4> ringBuffer;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        ringBuffer.append(mPointers[i]);
+        ringBuffer.pop();
+    }
+    for (size_t i = 3; i < 7; ++i)
+    {
+        EXPECT_TRUE(ringBuffer.append(mPointers[i], static_cast<uint8_t>(i)));
+    }
+
+    SharedRingBufferWindow window = ringBuffer.peek(1, 8);
+    ASSERT_EQ(3U, window.getNumberOfElements());
+    for (size_t i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(window[i] == mPointers[i + 4]);
+        EXPECT_EQ(i + 4, window.getFlags(i));
+        window.setFlags(i, 0);
+    }
+    EXPECT_EQ(0, ringBuffer.peek(3, 1).getFlags(0));
+    EXPECT_EQ(4U, ringBuffer.getUsedSlots());
+
+    EXPECT_EQ(2U, ringBuffer.pop(2));
+    EXPECT_TRUE(ringBuffer.read() == mPointers[5]);
+    EXPECT_EQ(2U, ringBuffer.pop(5));
+    EXPECT_TRUE(ringBuffer.isEmpty());
+    EXPECT_EQ(1U, mPointers[6]->getReferenceCount());
+
+    ringBuffer.append(mPointers[0]);
+    ringBuffer.reset();
+    EXPECT_TRUE(ringBuffer.isEmpty());
+    EXPECT_EQ(4U, ringBuffer.getFreeSlots());
+    EXPECT_EQ(1U, mPointers[0]->getReferenceCount());
+}
+
+TEST_F(SharedRingBufferTest, spscConcurrentProducerAndConsumer)
+{
+    static constexpr size_t numberOfItems = 20000;
+    SpscSharedRingBufferStorage<4> ringBuffer;
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < numberOfItems; ++i)
+        {
+            while (!ringBuffer.append(mPointers[i % 8], static_cast<uint8_t>(i)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    size_t errors = 0;
+    size_t received = 0;
+    while (received < numberOfItems)
+    {
+        SharedRingBufferWindow window = ringBuffer.peek(0, 4);
+        for (size_t i = 0; i < window.getNumberOfElements(); ++i)
+        {
+            const size_t expected = received + i;
+            if ((window[i] != mPointers[expected % 8])
+                || (window.getFlags(i) != static_cast<uint8_t>(expected)))
+            {
+                errors++;
+            }
+        }
+        received += ringBuffer.pop(window.getNumberOfElements());
+        if (window.getNumberOfElements() == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(0U, errors);
+    EXPECT_TRUE(ringBuffer.isEmpty());
+    for (auto& pointer : mPointers)
+    {
+        EXPECT_EQ(1U, pointer->getReferenceCount());
+    }
+}
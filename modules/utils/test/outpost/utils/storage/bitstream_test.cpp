@@ -16,9 +16,12 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <rapidcheck/gtest.h>
 
 #include <unittest/harness.h>
 
+#include <vector>
+
 using namespace outpost;
 
 constexpr uint16_t ARRAY_LENGTH = 256U;
@@ -296,3 +299,166 @@ TEST(BitstreamTest, deserializeFail)
         EXPECT_EQ(bitstream.getSerializedSize(), 3U);
     }
 }
+
+TEST(BitstreamWriterTest, pushBits)
+{
+    memset(buffer_in, 0xFF, ARRAY_LENGTH);
+    memset(ref, 0xFF, ARRAY_LENGTH);
+    outpost::Bitstream bitstream(data_in);
+
+    {
+        outpost::BitstreamWriter writer(bitstream);
+        writer.pushBits(0xA, 4);
+        writer.pushBit(true);
+        EXPECT_EQ(writer.getSize(), 1U);
+
+        writer.pushBits(0x12345678, 32);
+        EXPECT_EQ(writer.getSize(), 5U);
+
+        // The last partial byte is not written before the writer is flushed
+        EXPECT_EQ(bitstream.getSize(), 4U);
+    }
+
+    EXPECT_EQ(bitstream.getSize(), 5U);
+    EXPECT_EQ(bitstream.getSerializedSize(), 8U);
+
+    ref[3] = 0xA8;
+    ref[4] = 0x91;
+    ref[5] = 0xA2;
+    ref[6] = 0xB3;
+    ref[7] = 0xC0;
+
+    EXPECT_ARRAY_EQ(uint8_t, &ref[3], &buffer_in[3], ARRAY_LENGTH - 3U);
+}
+
+TEST(BitstreamWriterTest, shouldContinuePartialByte)
+{
+    memset(buffer_in, 0, ARRAY_LENGTH);
+    outpost::Bitstream bitstream(data_in);
+
+    bitstream.pushBit(true);
+    bitstream.pushBit(false);
+    bitstream.pushBit(true);
+    {
+        outpost::BitstreamWriter writer(bitstream);
+        writer.pushBits(0x1F, 5);
+        writer.pushBit(true);
+        writer.flush();
+
+        EXPECT_EQ(bitstream.getSize(), 2U);
+        EXPECT_EQ(bitstream.getByte(0), 0xBF);
+        EXPECT_EQ(bitstream.getByte(1), 0x80);
+
+        writer.pushBit(true);
+    }
+    bitstream.pushBit(true);
+
+    EXPECT_EQ(bitstream.getSize(), 2U);
+    EXPECT_EQ(bitstream.getByte(1), 0xE0);
+}
+
+TEST(BitstreamWriterTest, shouldDropBitsWhenFull)
+{
+    memset(buffer_in, 0, ARRAY_LENGTH);
+    outpost::Slice<uint8_t> shortBuffer = data_in.first(10);
+    outpost::Bitstream bitstream(shortBuffer);
+
+    outpost::BitstreamWriter writer(bitstream);
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        writer.pushBits(0xFFFFFFFF, 32);
+    }
+    EXPECT_EQ(writer.getSize(), 7U);
+
+    writer.flush();
+    EXPECT_TRUE(bitstream.isFull());
+    EXPECT_EQ(bitstream.getSize(), 7U);
+    EXPECT_EQ(buffer_in[10], 0);
+}
+
+TEST(BitstreamReaderTest, getBit)
+{
+    memset(buffer_in, 0, ARRAY_LENGTH);
+    outpost::Bitstream bitstream(data_in);
+
+    bitstream.pushBit(true);
+    bitstream.pushBit(false);
+    bitstream.pushBit(true);
+    bitstream.pushBit(true);
+
+    outpost::BitstreamReader reader(bitstream, 1);
+    EXPECT_EQ(reader.getPosition(), 1U);
+    EXPECT_FALSE(reader.getBit());
+    EXPECT_TRUE(reader.getBit());
+    EXPECT_TRUE(reader.getBit());
+    EXPECT_EQ(reader.getPosition(), 4U);
+
+    // Out of the current bitstream's bounds
+    for (uint8_t i = 0; i < 100; i++)
+    {
+        EXPECT_FALSE(reader.getBit());
+    }
+    EXPECT_EQ(reader.getPosition(), 104U);
+}
+
+RC_GTEST_PROP(BitstreamWriterTest, shouldEqualPushBit, ())
+{
+    const auto length = *rc::gen::inRange<size_t>(4, ARRAY_LENGTH);
+    const auto initialBits = *rc::gen::inRange<size_t>(0, 16);
+    const auto counts = *rc::gen::container<std::vector<uint8_t>>(rc::gen::inRange<uint8_t>(1, 33));
+
+    std::vector<uint8_t> expectedBuffer(length, 0xAB);
+    std::vector<uint8_t> actualBuffer(length, 0xAB);
+    outpost::Slice<uint8_t> expectedSlice(expectedBuffer);
+    outpost::Slice<uint8_t> actualSlice(actualBuffer);
+    outpost::Bitstream expected(expectedSlice);
+    outpost::Bitstream actual(actualSlice);
+
+    for (size_t i = 0; i < initialBits; i++)
+    {
+        expected.pushBit(i & 1);
+        actual.pushBit(i & 1);
+    }
+
+    {
+        outpost::BitstreamWriter writer(actual);
+        for (uint8_t count : counts)
+        {
+            const auto value = *rc::gen::arbitrary<uint32_t>();
+            writer.pushBits(value, count);
+            for (int8_t bit = count - 1; bit >= 0; bit--)
+            {
+                expected.pushBit((value >> bit) & 1);
+            }
+            RC_ASSERT(writer.getSize() == expected.getSize());
+        }
+    }
+
+    RC_ASSERT(actual.getSize() == expected.getSize());
+    RC_ASSERT(actual.isFull() == expected.isFull());
+    for (uint16_t i = 0; i < expected.getSize(); i++)
+    {
+        RC_ASSERT(actual.getByte(i) == expected.getByte(i));
+    }
+}
+
+RC_GTEST_PROP(BitstreamReaderTest, shouldEqualGetBit, ())
+{
+    const auto bits = *rc::gen::container<std::vector<bool>>(rc::gen::arbitrary<bool>());
+    const auto start = *rc::gen::inRange<uint32_t>(0, bits.size() + 16);
+
+    std::vector<uint8_t> buffer(bits.size() / 8 + 4);
+    outpost::Slice<uint8_t> slice(buffer);
+    outpost::Bitstream bitstream(slice);
+    for (bool bit : bits)
+    {
+        bitstream.pushBit(bit);
+    }
+
+    outpost::BitstreamReader reader(bitstream, start);
+    for (uint32_t i = start; i < bits.size() + 80; i++)
+    {
+        RC_ASSERT(reader.getBit() == bitstream.getBit(i));
+    }
+    RC_ASSERT(reader.getPosition() == bits.size() + 80);
+}